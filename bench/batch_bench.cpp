@@ -0,0 +1,227 @@
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include <onion/Batch.hpp>
+#include <onion/DateTime.hpp>
+
+using namespace onion;
+
+namespace
+{
+	constexpr std::size_t ColumnSize = 1 << 20;
+
+	const std::vector<int64_t>& EpochMillis()
+	{
+		static const std::vector<int64_t> values = []()
+		{
+			std::mt19937_64 rng(42);
+			std::uniform_int_distribution<int64_t> dist(0, 4'102'444'800'000); // [1970, 2100)
+
+			std::vector<int64_t> result(ColumnSize);
+			for (int64_t& value : result)
+				value = dist(rng);
+			return result;
+		}();
+		return values;
+	}
+
+	const std::vector<DateTime>& DateTimes()
+	{
+		static const std::vector<DateTime> values = []()
+		{
+			std::vector<DateTime> result(ColumnSize, DateTime::FromUnixMillis(0));
+			batch::fromUnixMillis(EpochMillis(), result);
+			return result;
+		}();
+		return values;
+	}
+} // namespace
+
+static void BM_DateTimeGetters_PerElement(benchmark::State& state)
+{
+	const auto& values = DateTimes();
+	std::vector<int32_t> years(ColumnSize), months(ColumnSize), days(ColumnSize), hours(ColumnSize);
+
+	for (auto _ : state)
+	{
+		for (std::size_t i = 0; i < ColumnSize; ++i)
+		{
+			years[i] = values[i].getYear();
+			months[i] = values[i].getMonth();
+			days[i] = values[i].getDay();
+			hours[i] = values[i].getHours();
+		}
+		benchmark::ClobberMemory();
+	}
+	state.SetItemsProcessed(state.iterations() * ColumnSize);
+}
+BENCHMARK(BM_DateTimeGetters_PerElement)->Unit(benchmark::kMillisecond);
+
+static void BM_DateTimeDecompose_PerElement(benchmark::State& state)
+{
+	const auto& values = DateTimes();
+	std::vector<int32_t> years(ColumnSize), months(ColumnSize), days(ColumnSize), hours(ColumnSize);
+
+	for (auto _ : state)
+	{
+		for (std::size_t i = 0; i < ColumnSize; ++i)
+		{
+			const DateTime::Components components = values[i].decompose();
+			years[i] = components.year;
+			months[i] = components.month;
+			days[i] = components.day;
+			hours[i] = components.hours;
+		}
+		benchmark::ClobberMemory();
+	}
+	state.SetItemsProcessed(state.iterations() * ColumnSize);
+}
+BENCHMARK(BM_DateTimeDecompose_PerElement)->Unit(benchmark::kMillisecond);
+
+static void BM_BatchDecompose(benchmark::State& state)
+{
+	const auto isa = static_cast<batch::Isa>(state.range(0));
+	const auto& epochMs = EpochMillis();
+	std::vector<int32_t> years(ColumnSize), months(ColumnSize), days(ColumnSize), hours(ColumnSize);
+
+	for (auto _ : state)
+	{
+		batch::decompose(epochMs, {.years = years, .months = months, .days = days, .hours = hours}, isa);
+		benchmark::ClobberMemory();
+	}
+	state.SetItemsProcessed(state.iterations() * ColumnSize);
+	state.SetLabel(isa == batch::activeIsa() ? "active" : "");
+}
+BENCHMARK(BM_BatchDecompose)
+	->ArgName("isa")
+	->Arg(static_cast<int>(batch::Isa::Scalar))
+	->Arg(static_cast<int>(batch::Isa::Avx2))
+	->Arg(static_cast<int>(batch::Isa::Avx512))
+	->Unit(benchmark::kMillisecond);
+
+static void BM_FromUnixTimestamp_PerElement(benchmark::State& state)
+{
+	const auto& epochMs = EpochMillis();
+	std::vector<DateTime> values(ColumnSize, DateTime::FromUnixMillis(0));
+
+	for (auto _ : state)
+	{
+		for (std::size_t i = 0; i < ColumnSize; ++i)
+			values[i] = DateTime::FromUnixTimestamp(static_cast<double>(epochMs[i]) / 1000.0);
+		benchmark::ClobberMemory();
+	}
+	state.SetItemsProcessed(state.iterations() * ColumnSize);
+}
+BENCHMARK(BM_FromUnixTimestamp_PerElement)->Unit(benchmark::kMillisecond);
+
+static void BM_FromUnixMillis_PerElement(benchmark::State& state)
+{
+	const auto& epochMs = EpochMillis();
+	std::vector<DateTime> values(ColumnSize, DateTime::FromUnixMillis(0));
+
+	for (auto _ : state)
+	{
+		for (std::size_t i = 0; i < ColumnSize; ++i)
+			values[i] = DateTime::FromUnixMillis(epochMs[i]);
+		benchmark::ClobberMemory();
+	}
+	state.SetItemsProcessed(state.iterations() * ColumnSize);
+}
+BENCHMARK(BM_FromUnixMillis_PerElement)->Unit(benchmark::kMillisecond);
+
+static void BM_BatchFromUnixMicros(benchmark::State& state)
+{
+	std::vector<int64_t> epochUs(ColumnSize);
+	for (std::size_t i = 0; i < ColumnSize; ++i)
+		epochUs[i] = EpochMillis()[i] * 1000 + static_cast<int64_t>(i % 1000);
+	std::vector<DateTime> values(ColumnSize, DateTime::FromUnixMillis(0));
+
+	for (auto _ : state)
+	{
+		batch::fromUnixMicros(epochUs, values);
+		benchmark::ClobberMemory();
+	}
+	state.SetItemsProcessed(state.iterations() * ColumnSize);
+}
+BENCHMARK(BM_BatchFromUnixMicros)->Unit(benchmark::kMillisecond);
+
+static void BM_BatchFromUnixMillis(benchmark::State& state)
+{
+	const auto& epochMs = EpochMillis();
+	std::vector<DateTime> values(ColumnSize, DateTime::FromUnixMillis(0));
+
+	for (auto _ : state)
+	{
+		batch::fromUnixMillis(epochMs, values);
+		benchmark::ClobberMemory();
+	}
+	state.SetItemsProcessed(state.iterations() * ColumnSize);
+}
+BENCHMARK(BM_BatchFromUnixMillis)->Unit(benchmark::kMillisecond);
+
+static void BM_BatchToUnixMillis(benchmark::State& state)
+{
+	const auto& values = DateTimes();
+	std::vector<int64_t> epochMs(ColumnSize);
+
+	for (auto _ : state)
+	{
+		batch::toUnixMillis(values, epochMs);
+		benchmark::ClobberMemory();
+	}
+	state.SetItemsProcessed(state.iterations() * ColumnSize);
+}
+BENCHMARK(BM_BatchToUnixMillis)->Unit(benchmark::kMillisecond);
+
+static void BM_DateTimeFloorMonth_PerElement(benchmark::State& state)
+{
+	const auto& values = DateTimes();
+	std::vector<DateTime> starts(ColumnSize, DateTime::FromUnixMillis(0));
+
+	for (auto _ : state)
+	{
+		for (std::size_t i = 0; i < ColumnSize; ++i)
+			starts[i] = values[i].floor(CalendarUnit::Month);
+		benchmark::ClobberMemory();
+	}
+	state.SetItemsProcessed(state.iterations() * ColumnSize);
+}
+BENCHMARK(BM_DateTimeFloorMonth_PerElement)->Unit(benchmark::kMillisecond);
+
+static void BM_BatchBucketizeMonth(benchmark::State& state)
+{
+	const auto isa = static_cast<batch::Isa>(state.range(0));
+	const auto& values = DateTimes();
+	std::vector<int64_t> ids(ColumnSize);
+
+	for (auto _ : state)
+	{
+		batch::bucketize(values, CalendarUnit::Month, ids, isa);
+		benchmark::ClobberMemory();
+	}
+	state.SetItemsProcessed(state.iterations() * ColumnSize);
+	state.SetLabel(isa == batch::activeIsa() ? "active" : "");
+}
+BENCHMARK(BM_BatchBucketizeMonth)
+	->ArgName("isa")
+	->Arg(static_cast<int>(batch::Isa::Scalar))
+	->Arg(static_cast<int>(batch::Isa::Avx2))
+	->Arg(static_cast<int>(batch::Isa::Avx512))
+	->Unit(benchmark::kMillisecond);
+
+static void BM_BatchBucketizeInterval(benchmark::State& state)
+{
+	const auto& values = DateTimes();
+	std::vector<int64_t> ids(ColumnSize);
+
+	for (auto _ : state)
+	{
+		batch::bucketize(values, TimeSpan::FromMinutes(15), ids);
+		benchmark::ClobberMemory();
+	}
+	state.SetItemsProcessed(state.iterations() * ColumnSize);
+}
+BENCHMARK(BM_BatchBucketizeInterval)->Unit(benchmark::kMillisecond);
@@ -0,0 +1,38 @@
+#include <optional>
+
+#include <benchmark/benchmark.h>
+
+#include <onion/CoarseClock.hpp>
+#include <onion/DateTime.hpp>
+
+using namespace onion;
+
+static void BM_UtcNow(benchmark::State& state)
+{
+	for (auto _ : state)
+		benchmark::DoNotOptimize(DateTime::UtcNow());
+}
+BENCHMARK(BM_UtcNow)->ThreadRange(1, 8)->UseRealTime();
+
+static void BM_UtcNowCoarse_System(benchmark::State& state)
+{
+	for (auto _ : state)
+		benchmark::DoNotOptimize(DateTime::UtcNowCoarse());
+}
+BENCHMARK(BM_UtcNowCoarse_System)->ThreadRange(1, 8)->UseRealTime();
+
+static void BM_UtcNowCoarse_Ticker(benchmark::State& state)
+{
+	// All threads wait for each other when entering and leaving the loop, so the ticker started by
+	// thread 0 runs for the whole measurement.
+	static std::optional<CoarseClockTicker> ticker;
+	if (state.thread_index() == 0)
+		ticker.emplace();
+
+	for (auto _ : state)
+		benchmark::DoNotOptimize(DateTime::UtcNowCoarse());
+
+	if (state.thread_index() == 0)
+		ticker.reset();
+}
+BENCHMARK(BM_UtcNowCoarse_Ticker)->ThreadRange(1, 8)->UseRealTime();
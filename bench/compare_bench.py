@@ -0,0 +1,88 @@
+#!/usr/bin/env python3
+"""Compares Google Benchmark JSON results against a baseline and flags slowdowns.
+
+Usage:
+    onion_datetime_bench --benchmark_out=current.json --benchmark_out_format=json
+    python3 bench/compare_bench.py bench/baseline.json current.json [--threshold 0.10]
+
+No baseline ships with the repository, as timings only compare on the same machine and compiler. Record one
+before the change, then refresh it as needed:
+    python3 bench/compare_bench.py bench/baseline.json current.json --update
+
+Benchmarks are matched by name; when repetitions are used, the "mean" aggregate is compared.
+Exits with status 1 if any benchmark is slower than the baseline by more than the threshold.
+"""
+
+import argparse
+import json
+import os
+import shutil
+import sys
+
+
+def load(path):
+    with open(path, encoding="utf-8") as file:
+        document = json.load(file)
+
+    results = {}
+    for entry in document.get("benchmarks", []):
+        if entry.get("error_occurred"):
+            continue
+        aggregate = entry.get("aggregate_name")
+        if aggregate not in (None, "mean"):
+            continue
+        name = entry.get("run_name", entry["name"])
+        results[name] = entry
+    return results
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("baseline", help="baseline JSON, recorded with --update")
+    parser.add_argument("current", help="JSON written by --benchmark_out")
+    parser.add_argument("--threshold", type=float, default=0.10,
+                        help="relative slowdown that is reported as a regression (default: 0.10)")
+    parser.add_argument("--metric", choices=("cpu_time", "real_time"), default="cpu_time")
+    parser.add_argument("--update", action="store_true", help="replace the baseline with the current results")
+    args = parser.parse_args()
+
+    if args.update:
+        shutil.copyfile(args.current, args.baseline)
+        print(f"Baseline {args.baseline} updated from {args.current}")
+        return 0
+
+    if not os.path.exists(args.baseline):
+        print(f"No baseline at {args.baseline}: record one with --update before the change", file=sys.stderr)
+        return 2
+
+    baseline = load(args.baseline)
+    current = load(args.current)
+
+    regressions = 0
+    width = max((len(name) for name in current), default=0)
+    print(f"{'Benchmark':<{width}}  {'Baseline':>12}  {'Current':>12}  {'Change':>8}")
+    for name, entry in current.items():
+        if name not in baseline:
+            print(f"{name:<{width}}  {'-':>12}  {entry[args.metric]:>12.2f}  {'new':>8}")
+            continue
+
+        before = baseline[name][args.metric]
+        after = entry[args.metric]
+        change = (after - before) / before if before > 0 else 0.0
+        flag = ""
+        if change > args.threshold:
+            flag = "  SLOWER"
+            regressions += 1
+        print(f"{name:<{width}}  {before:>12.2f}  {after:>12.2f}  {change:>+8.1%}{flag}")
+
+    for name in baseline.keys() - current.keys():
+        print(f"{name:<{width}}  missing from current results")
+
+    if regressions:
+        print(f"\n{regressions} benchmark(s) slower than the baseline by more than {args.threshold:.0%}")
+        return 1
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,226 @@
+#include <format>
+#include <string>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include <onion/DateTime.hpp>
+
+using namespace onion;
+
+namespace
+{
+	constexpr std::size_t InputMask = 1023;
+
+	const std::vector<DateTime>& Inputs()
+	{
+		static const std::vector<DateTime> values = []()
+		{
+			std::vector<DateTime> result;
+			result.reserve(InputMask + 1);
+
+			DateTime dt(2024, 6, 15, 12, 30, 45, 500);
+			for (std::size_t i = 0; i <= InputMask; ++i)
+			{
+				result.push_back(dt);
+				dt = dt + TimeSpan::FromMilliseconds(7'919'123);
+			}
+			return result;
+		}();
+		return values;
+	}
+
+	const std::vector<DateTimeNanos>& NanosInputs()
+	{
+		static const std::vector<DateTimeNanos> values = []()
+		{
+			std::vector<DateTimeNanos> result;
+			result.reserve(InputMask + 1);
+			for (const DateTime& dt : Inputs())
+				result.push_back(DateTimeNanos(dt) + TimeSpan::FromNanoseconds(456'789));
+			return result;
+		}();
+		return values;
+	}
+} // namespace
+
+// ---- Construction ----
+
+static void BM_DateTimeConstruct_Components(benchmark::State& state)
+{
+	int i = 0;
+	for (auto _ : state)
+	{
+		const int n = i++ & 1023;
+		benchmark::DoNotOptimize(DateTime(2000 + n % 50, 1 + n % 12, 1 + n % 28, n % 24, n % 60, n % 60, n % 1000));
+	}
+	state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_DateTimeConstruct_Components);
+
+static void BM_DateTimeConstruct_UnixTimestamp(benchmark::State& state)
+{
+	double timestamp = 1'718'454'645.5;
+	for (auto _ : state)
+	{
+		benchmark::DoNotOptimize(DateTime::FromUnixTimestamp(timestamp));
+		timestamp += 0.001;
+	}
+	state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_DateTimeConstruct_UnixTimestamp);
+
+static void BM_DateTimeConstruct_UnixMillis(benchmark::State& state)
+{
+	int64_t milliseconds = 1'718'454'645'500;
+	for (auto _ : state)
+		benchmark::DoNotOptimize(DateTime::FromUnixMillis(milliseconds++));
+	state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_DateTimeConstruct_UnixMillis);
+
+// ---- Getters ----
+
+template <typename Getter>
+static void BM_DateTimeGetter(benchmark::State& state, Getter getter)
+{
+	const auto& inputs = Inputs();
+	std::size_t i = 0;
+	for (auto _ : state)
+		benchmark::DoNotOptimize(getter(inputs[i++ & InputMask]));
+	state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK_CAPTURE(BM_DateTimeGetter, getYear, [](const DateTime& dt) { return dt.getYear(); });
+BENCHMARK_CAPTURE(BM_DateTimeGetter, getMonth, [](const DateTime& dt) { return dt.getMonth(); });
+BENCHMARK_CAPTURE(BM_DateTimeGetter, getDay, [](const DateTime& dt) { return dt.getDay(); });
+BENCHMARK_CAPTURE(BM_DateTimeGetter, getHours, [](const DateTime& dt) { return dt.getHours(); });
+BENCHMARK_CAPTURE(BM_DateTimeGetter, getMinutes, [](const DateTime& dt) { return dt.getMinutes(); });
+BENCHMARK_CAPTURE(BM_DateTimeGetter, getSeconds, [](const DateTime& dt) { return dt.getSeconds(); });
+BENCHMARK_CAPTURE(BM_DateTimeGetter, getMilliseconds, [](const DateTime& dt) { return dt.getMilliseconds(); });
+BENCHMARK_CAPTURE(BM_DateTimeGetter, decompose, [](const DateTime& dt) { return dt.decompose(); });
+
+// ---- Formatting ----
+
+static void BM_DateTimeToString(benchmark::State& state)
+{
+	const auto& inputs = Inputs();
+	std::size_t i = 0;
+	for (auto _ : state)
+		benchmark::DoNotOptimize(inputs[i++ & InputMask].toString());
+	state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_DateTimeToString);
+
+static void BM_DateTimeToString_Format(benchmark::State& state)
+{
+	const auto& inputs = Inputs();
+	const std::string format = "%Y-%m-%d %H:%M:%S";
+	std::size_t i = 0;
+	for (auto _ : state)
+		benchmark::DoNotOptimize(inputs[i++ & InputMask].toString(format));
+	state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_DateTimeToString_Format);
+
+static void BM_DateTimeToString_Pattern(benchmark::State& state)
+{
+	const auto& inputs = Inputs();
+	constexpr DateTime::Pattern pattern = DateTime::Pattern::Compile("%Y-%m-%d %H:%M:%S");
+	std::size_t i = 0;
+	for (auto _ : state)
+		benchmark::DoNotOptimize(inputs[i++ & InputMask].toString(pattern));
+	state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_DateTimeToString_Pattern);
+
+static void BM_StdFormat_Default(benchmark::State& state)
+{
+	const auto& inputs = Inputs();
+	std::size_t i = 0;
+	for (auto _ : state)
+		benchmark::DoNotOptimize(std::format("{}", inputs[i++ & InputMask]));
+	state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_StdFormat_Default);
+
+static void BM_StdFormat_Spec(benchmark::State& state)
+{
+	const auto& inputs = Inputs();
+	std::size_t i = 0;
+	for (auto _ : state)
+		benchmark::DoNotOptimize(std::format("{:%F %T}", inputs[i++ & InputMask]));
+	state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_StdFormat_Spec);
+
+// ---- Arithmetic ----
+
+static void BM_DateTimeDifference(benchmark::State& state)
+{
+	const auto& inputs = Inputs();
+	std::size_t i = 0;
+	for (auto _ : state)
+	{
+		benchmark::DoNotOptimize(inputs[(i + 1) & InputMask] - inputs[i & InputMask]);
+		++i;
+	}
+	state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_DateTimeDifference);
+
+static void BM_DateTimeAddTimeSpan(benchmark::State& state)
+{
+	const auto& inputs = Inputs();
+	const TimeSpan offset = TimeSpan::FromMinutes(90);
+	std::size_t i = 0;
+	for (auto _ : state)
+		benchmark::DoNotOptimize(inputs[i++ & InputMask] + offset);
+	state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_DateTimeAddTimeSpan);
+
+static void BM_DateTimeCompare(benchmark::State& state)
+{
+	const auto& inputs = Inputs();
+	std::size_t i = 0;
+	for (auto _ : state)
+	{
+		benchmark::DoNotOptimize(inputs[(i + 1) & InputMask] < inputs[i & InputMask]);
+		++i;
+	}
+	state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_DateTimeCompare);
+
+// ---- Nanosecond precision ----
+
+static void BM_DateTimeNanosToString(benchmark::State& state)
+{
+	const auto& inputs = NanosInputs();
+	std::size_t i = 0;
+	for (auto _ : state)
+		benchmark::DoNotOptimize(inputs[i++ & InputMask].toString());
+	state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_DateTimeNanosToString);
+
+static void BM_DateTimeNanosDecompose(benchmark::State& state)
+{
+	const auto& inputs = NanosInputs();
+	std::size_t i = 0;
+	for (auto _ : state)
+		benchmark::DoNotOptimize(inputs[i++ & InputMask].decompose());
+	state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_DateTimeNanosDecompose);
+
+static void BM_DateTimeNanosAddTimeSpan(benchmark::State& state)
+{
+	const auto& inputs = NanosInputs();
+	const TimeSpan offset = TimeSpan::FromNanoseconds(90'000'000'123);
+	std::size_t i = 0;
+	for (auto _ : state)
+		benchmark::DoNotOptimize(inputs[i++ & InputMask] + offset);
+	state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_DateTimeNanosAddTimeSpan);
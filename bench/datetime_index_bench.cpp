@@ -0,0 +1,97 @@
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include <onion/DateTime.hpp>
+#include <onion/DateTimeIndex.hpp>
+
+using namespace onion;
+
+namespace
+{
+	constexpr std::size_t QueryMask = (1 << 16) - 1;
+
+	/// Sorted event timestamps, 1 to 16 ms apart.
+	std::vector<DateTime> Values(std::size_t size)
+	{
+		std::vector<DateTime> result(size, DateTime::FromUnixMillis(0));
+		int64_t unixMillis = 1'718'454'645'000;
+		for (std::size_t i = 0; i < size; ++i)
+		{
+			unixMillis += 1 + static_cast<int64_t>(i * 7'919 % 16);
+			result[i] = DateTime::FromUnixMillis(unixMillis);
+		}
+		return result;
+	}
+
+	/// Random queries over the range of the values.
+	std::vector<DateTime> Queries(const std::vector<DateTime>& values)
+	{
+		const int64_t first = values.front().toUnixMillis();
+		const auto span = static_cast<uint64_t>(values.back().toUnixMillis() - first + 1);
+		std::vector<DateTime> result(QueryMask + 1, DateTime::FromUnixMillis(0));
+		uint64_t state = 0x9E3779B97F4A7C15;
+		for (auto& query : result)
+		{
+			state = state * 6'364'136'223'846'793'005 + 1'442'695'040'888'963'407;
+			query = DateTime::FromUnixMillis(first + static_cast<int64_t>((state >> 16) % span));
+		}
+		return result;
+	}
+
+	// From 8 KiB (L1) to 512 MiB (DRAM) of values.
+	void Sizes(benchmark::internal::Benchmark* benchmark)
+	{
+		benchmark->RangeMultiplier(8)->Range(1 << 10, 1 << 26);
+	}
+} // namespace
+
+static void BM_StdLowerBound(benchmark::State& state)
+{
+	const auto values = Values(static_cast<std::size_t>(state.range(0)));
+	const auto queries = Queries(values);
+	std::size_t i = 0;
+	for (auto _ : state)
+		benchmark::DoNotOptimize(std::lower_bound(values.begin(), values.end(), queries[i++ & QueryMask]));
+	state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_StdLowerBound)->Apply(Sizes);
+
+static void BM_DateTimeIndexLowerBound(benchmark::State& state)
+{
+	const auto values = Values(static_cast<std::size_t>(state.range(0)));
+	const auto queries = Queries(values);
+	const DateTimeIndex index(values);
+	std::size_t i = 0;
+	for (auto _ : state)
+		benchmark::DoNotOptimize(index.lowerBound(queries[i++ & QueryMask]));
+	state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_DateTimeIndexLowerBound)->Apply(Sizes);
+
+static void BM_DateTimeIndexLowerBounds(benchmark::State& state)
+{
+	const auto values = Values(static_cast<std::size_t>(state.range(0)));
+	const auto queries = Queries(values);
+	const DateTimeIndex index(values);
+	std::vector<std::size_t> out(queries.size());
+	for (auto _ : state)
+	{
+		index.lowerBounds(queries, out);
+		benchmark::DoNotOptimize(out.data());
+	}
+	state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(queries.size()));
+}
+BENCHMARK(BM_DateTimeIndexLowerBounds)->Apply(Sizes);
+
+static void BM_DateTimeIndexBuild(benchmark::State& state)
+{
+	const auto values = Values(static_cast<std::size_t>(state.range(0)));
+	for (auto _ : state)
+		benchmark::DoNotOptimize(DateTimeIndex(values));
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_DateTimeIndexBuild)->Arg(1 << 20);
@@ -0,0 +1,150 @@
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include <onion/DateTime.hpp>
+#include <onion/Encoding.hpp>
+
+using namespace onion;
+
+namespace
+{
+	constexpr std::size_t InputMask = 1023;
+
+	/// Instants spread over 1900-2100, so that keys differ in their high bytes.
+	const std::vector<DateTime>& Instants()
+	{
+		static const std::vector<DateTime> values = []()
+		{
+			std::vector<DateTime> result;
+			result.reserve(InputMask + 1);
+			for (std::size_t i = 0; i <= InputMask; ++i)
+			{
+				const int64_t unixMillis = -2'208'988'800'000 + static_cast<int64_t>(i) * 6'170'586'113;
+				result.push_back(DateTime::FromUnixMillis(unixMillis));
+			}
+			return result;
+		}();
+		return values;
+	}
+
+	/// Event timestamps 1 ms to 2 s apart, as in a sorted log.
+	std::vector<DateTime> Events()
+	{
+		std::vector<DateTime> result(1 << 16, DateTime::FromUnixMillis(0));
+		int64_t unixMillis = 1'718'454'645'000;
+		for (std::size_t i = 0; i < result.size(); ++i)
+		{
+			unixMillis += 1 + static_cast<int64_t>(i * 7'919 % 2'000);
+			result[i] = DateTime::FromUnixMillis(unixMillis);
+		}
+		return result;
+	}
+} // namespace
+
+// ---- Single values ----
+
+static void BM_EncodeKey(benchmark::State& state)
+{
+	const auto& inputs = Instants();
+	std::byte key[encoding::KeySize];
+	std::size_t i = 0;
+	for (auto _ : state)
+	{
+		encoding::encodeKey(inputs[i++ & InputMask], key);
+		benchmark::DoNotOptimize(key);
+	}
+	state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_EncodeKey);
+
+static void BM_DecodeKey(benchmark::State& state)
+{
+	const auto& inputs = Instants();
+	std::vector<std::byte> keys(inputs.size() * encoding::KeySize);
+	encoding::encodeKeys(inputs, keys);
+
+	std::size_t i = 0;
+	for (auto _ : state)
+		benchmark::DoNotOptimize(encoding::decodeKey(&keys[(i++ & InputMask) * encoding::KeySize]));
+	state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_DecodeKey);
+
+static void BM_EncodeVarint(benchmark::State& state)
+{
+	const auto& inputs = Instants();
+	std::byte varint[encoding::MaxVarintSize];
+	std::size_t i = 0;
+	for (auto _ : state)
+	{
+		const auto span = TimeSpan::FromMilliseconds(inputs[i++ & InputMask].toUnixMillis() % 100'000);
+		benchmark::DoNotOptimize(encoding::encodeVarint(span, varint));
+	}
+	state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_EncodeVarint);
+
+// ---- Columns ----
+
+static void BM_EncodeKeys(benchmark::State& state)
+{
+	const auto events = Events();
+	std::vector<std::byte> keys(events.size() * encoding::KeySize);
+	for (auto _ : state)
+	{
+		encoding::encodeKeys(events, keys);
+		benchmark::DoNotOptimize(keys.data());
+	}
+	state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(events.size()));
+}
+BENCHMARK(BM_EncodeKeys);
+
+static void BM_DecodeKeys(benchmark::State& state)
+{
+	const auto events = Events();
+	std::vector<std::byte> keys(events.size() * encoding::KeySize);
+	encoding::encodeKeys(events, keys);
+
+	std::vector<DateTime> out(events.size(), DateTime::FromUnixMillis(0));
+	for (auto _ : state)
+	{
+		encoding::decodeKeys(keys, out);
+		benchmark::DoNotOptimize(out.data());
+	}
+	state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(events.size()));
+}
+BENCHMARK(BM_DecodeKeys);
+
+static void BM_EncodeDeltas(benchmark::State& state)
+{
+	const auto events = Events();
+	std::vector<std::byte> bytes(encoding::maxDeltasSize(events.size()));
+	std::size_t size = 0;
+	for (auto _ : state)
+	{
+		size = encoding::encodeDeltas(events, bytes);
+		benchmark::DoNotOptimize(bytes.data());
+	}
+	state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(events.size()));
+	state.counters["bytes_per_value"] = static_cast<double>(size) / static_cast<double>(events.size());
+}
+BENCHMARK(BM_EncodeDeltas);
+
+static void BM_DecodeDeltas(benchmark::State& state)
+{
+	const auto events = Events();
+	std::vector<std::byte> bytes(encoding::maxDeltasSize(events.size()));
+	bytes.resize(encoding::encodeDeltas(events, bytes));
+
+	std::vector<DateTime> out(events.size(), DateTime::FromUnixMillis(0));
+	for (auto _ : state)
+	{
+		encoding::decodeDeltas(bytes, out);
+		benchmark::DoNotOptimize(out.data());
+	}
+	state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(events.size()));
+}
+BENCHMARK(BM_DecodeDeltas);
@@ -0,0 +1,75 @@
+#include <stdexcept>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include <onion/DateTime.hpp>
+
+using namespace onion;
+
+namespace
+{
+	struct Components
+	{
+		int year, month, day, hours, minutes, seconds;
+	};
+
+	/// Records where one in `invalidEvery` has a day that does not exist (February 30th).
+	std::vector<Components> Records(int invalidEvery)
+	{
+		std::vector<Components> records(1024);
+		for (std::size_t i = 0; i < records.size(); ++i)
+		{
+			const bool invalid = invalidEvery > 0 && i % static_cast<std::size_t>(invalidEvery) == 0;
+			records[i] = {2000 + static_cast<int>(i % 50), 2, invalid ? 30 : 1 + static_cast<int>(i % 28), 12, 30, 45};
+		}
+		return records;
+	}
+} // namespace
+
+#ifndef ONION_NO_EXCEPTIONS
+static void BM_Constructor_Throwing(benchmark::State& state)
+{
+	const auto records = Records(static_cast<int>(state.range(0)));
+	int64_t rejected = 0;
+
+	for (auto _ : state)
+	{
+		for (const Components& c : records)
+		{
+			try
+			{
+				benchmark::DoNotOptimize(DateTime(c.year, c.month, c.day, c.hours, c.minutes, c.seconds));
+			}
+			catch (const std::invalid_argument&)
+			{
+				++rejected;
+			}
+		}
+	}
+	benchmark::DoNotOptimize(rejected);
+	state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(records.size()));
+}
+BENCHMARK(BM_Constructor_Throwing)->ArgName("invalidEvery")->Arg(0)->Arg(50)->Arg(1);
+#endif
+
+static void BM_TryCreate(benchmark::State& state)
+{
+	const auto records = Records(static_cast<int>(state.range(0)));
+	int64_t rejected = 0;
+
+	for (auto _ : state)
+	{
+		for (const Components& c : records)
+		{
+			const auto result = DateTime::TryCreate(c.year, c.month, c.day, c.hours, c.minutes, c.seconds);
+			if (result)
+				benchmark::DoNotOptimize(*result);
+			else
+				++rejected;
+		}
+	}
+	benchmark::DoNotOptimize(rejected);
+	state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(records.size()));
+}
+BENCHMARK(BM_TryCreate)->ArgName("invalidEvery")->Arg(0)->Arg(50)->Arg(1);
@@ -0,0 +1,129 @@
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include <onion/LatencyHistogram.hpp>
+#include <onion/TimeSpan.hpp>
+
+using namespace onion;
+
+namespace
+{
+	/// Log-normal latencies around 200 us, as request latencies are.
+	const std::vector<TimeSpan>& Latencies()
+	{
+		static const std::vector<TimeSpan> latencies = []()
+		{
+			std::mt19937_64 rng(42);
+			std::lognormal_distribution<double> dist(12.2, 0.8);
+			std::vector<TimeSpan> result(1 << 16);
+			for (TimeSpan& latency : result)
+				latency = TimeSpan::FromNanoseconds(static_cast<int64_t>(dist(rng)));
+			return result;
+		}();
+		return latencies;
+	}
+
+	int MaxThreads()
+	{
+		return static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+	}
+
+	std::unique_ptr<LatencyHistogram> SharedHistogram;
+
+	/// The usual alternative: one set of counters shared by every thread, incremented with atomic adds.
+	std::unique_ptr<std::atomic<uint64_t>[]> SharedCounters;
+} // namespace
+
+static void BM_LatencyRecord(benchmark::State& state)
+{
+	const std::vector<TimeSpan>& latencies = Latencies();
+	if (state.thread_index() == 0)
+		SharedHistogram = std::make_unique<LatencyHistogram>(static_cast<std::size_t>(MaxThreads()));
+
+	for (auto _ : state)
+	{
+		// In the loop, which the threads only enter once thread 0 created the histogram.
+		auto& recorder = SharedHistogram->recorder(static_cast<std::size_t>(state.thread_index()));
+		for (const TimeSpan& latency : latencies)
+			recorder.record(latency);
+	}
+	state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(latencies.size()));
+
+	if (state.thread_index() == 0)
+		SharedHistogram.reset();
+}
+BENCHMARK(BM_LatencyRecord)->ThreadRange(1, MaxThreads())->UseRealTime();
+
+static void BM_LatencyRecordSharedAtomic(benchmark::State& state)
+{
+	const std::vector<TimeSpan>& latencies = Latencies();
+	if (state.thread_index() == 0)
+		SharedCounters = std::make_unique<std::atomic<uint64_t>[]>(LatencyHistogram::BucketCount + 1);
+
+	for (auto _ : state)
+	{
+		std::atomic<uint64_t>* const counters = SharedCounters.get();
+		for (const TimeSpan& latency : latencies)
+		{
+			const auto nanoseconds = static_cast<uint64_t>(latency.TotalNanoseconds());
+			counters[LatencyHistogram::BucketIndex(nanoseconds)].fetch_add(1, std::memory_order_relaxed);
+			counters[LatencyHistogram::BucketCount].fetch_add(nanoseconds, std::memory_order_relaxed);
+		}
+	}
+	state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(latencies.size()));
+
+	if (state.thread_index() == 0)
+		SharedCounters.reset();
+}
+BENCHMARK(BM_LatencyRecordSharedAtomic)->ThreadRange(1, MaxThreads())->UseRealTime();
+
+static void BM_LatencySnapshot(benchmark::State& state)
+{
+	LatencyHistogram histogram(static_cast<std::size_t>(state.range(0)));
+	for (const TimeSpan& latency : Latencies())
+		histogram.recorder(0).record(latency);
+
+	for (auto _ : state)
+		benchmark::DoNotOptimize(histogram.snapshot().count());
+}
+BENCHMARK(BM_LatencySnapshot)->ArgName("recorders")->Arg(1)->Arg(16);
+
+static void BM_LatencyPercentiles(benchmark::State& state)
+{
+	LatencyHistogram::Snapshot snapshot;
+	for (const TimeSpan& latency : Latencies())
+		snapshot.record(latency);
+
+	for (auto _ : state)
+	{
+		benchmark::DoNotOptimize(snapshot.percentile(50));
+		benchmark::DoNotOptimize(snapshot.percentile(99));
+		benchmark::DoNotOptimize(snapshot.percentile(99.9));
+	}
+}
+BENCHMARK(BM_LatencyPercentiles);
+
+static void BM_LatencyEncode(benchmark::State& state)
+{
+	LatencyHistogram::Snapshot snapshot;
+	for (const TimeSpan& latency : Latencies())
+		snapshot.record(latency);
+
+	std::size_t size = 0;
+	for (auto _ : state)
+	{
+		const auto bytes = snapshot.encode();
+		size = bytes.size();
+		benchmark::DoNotOptimize(bytes.data());
+	}
+	state.counters["bytes"] = static_cast<double>(size);
+}
+BENCHMARK(BM_LatencyEncode);
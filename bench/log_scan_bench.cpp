@@ -0,0 +1,77 @@
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include <onion/DateTime.hpp>
+#include <onion/LogScanner.hpp>
+
+using namespace onion;
+
+namespace
+{
+	constexpr std::size_t FileSize = std::size_t{256} << 20;
+
+	/// A generated log of about 256 MB in the temporary directory, written once: 100-byte lines starting with
+	/// a `toString()` timestamp, and a continuation line every 16 lines.
+	const std::string& LogFile()
+	{
+		static const std::string path = []()
+		{
+			const std::string result = (std::filesystem::temp_directory_path() / "onion_log_scan_bench.log").string();
+			if (std::filesystem::exists(result) && std::filesystem::file_size(result) >= FileSize)
+				return result;
+
+			std::ofstream file(result, std::ios::binary | std::ios::trunc);
+			std::string line;
+			for (std::size_t size = 0, i = 0; size < FileSize; size += line.size(), ++i)
+			{
+				line = DateTime::FromUnixMillis(1'718'454'645'000 + static_cast<int64_t>(i) * 13).toString();
+				line += i % 16 == 15 ? "\n    at worker.run(Worker.java:42)" : "";
+				line += " INFO request completed path=/api/v1/items status=200 bytes=5120 latency_ms=12\n";
+				file << line;
+			}
+			return result;
+		}();
+		return path;
+	}
+} // namespace
+
+static void BM_LogScanFile(benchmark::State& state)
+{
+	const std::string& path = LogFile();
+	const auto threads = static_cast<unsigned>(state.range(0));
+	for (auto _ : state)
+	{
+		const LogScan scan = scanLogFile(path, threads);
+		benchmark::DoNotOptimize(scan.timestamps.data());
+	}
+	state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(std::filesystem::file_size(path)));
+}
+BENCHMARK(BM_LogScanFile)->ArgName("threads")->Arg(1)->Arg(0)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+/// The approach replaced by `scanLogFile`: a std::string per line, parsed with `DateTime::TryParse`.
+static void BM_LogScanGetline(benchmark::State& state)
+{
+	const std::string& path = LogFile();
+	for (auto _ : state)
+	{
+		std::ifstream file(path, std::ios::binary);
+		std::vector<LogTimestamp> timestamps;
+		std::string line;
+		uint64_t offset = 0;
+		while (std::getline(file, line))
+		{
+			if (const auto time = DateTime::TryParse(line.substr(0, line.find(' '))))
+				timestamps.push_back({offset, *time});
+			offset += line.size() + 1;
+		}
+		benchmark::DoNotOptimize(timestamps.data());
+	}
+	state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(std::filesystem::file_size(path)));
+}
+BENCHMARK(BM_LogScanGetline)->Unit(benchmark::kMillisecond)->UseRealTime();
@@ -0,0 +1,106 @@
+#include <chrono>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include <onion/DateTime.hpp>
+
+using namespace onion;
+
+namespace
+{
+	std::vector<std::string> MakeIsoStrings(std::size_t count)
+	{
+		std::vector<std::string> result;
+		result.reserve(count);
+
+		DateTime dt(2024, 6, 15, 12, 30, 45, 500);
+		for (std::size_t i = 0; i < count; ++i)
+		{
+			result.push_back(dt.toString());
+			dt = dt + TimeSpan::FromMilliseconds(7'919'123);
+		}
+
+		return result;
+	}
+
+	std::vector<std::string> MakeOffsetStrings(std::size_t count)
+	{
+		std::vector<std::string> result = MakeIsoStrings(count);
+		for (std::string& text : result)
+		{
+			text.pop_back();
+			text += "+02:00";
+		}
+
+		return result;
+	}
+
+	const std::vector<std::string>& IsoStrings()
+	{
+		static const std::vector<std::string> strings = MakeIsoStrings(1024);
+		return strings;
+	}
+
+	const std::vector<std::string>& OffsetStrings()
+	{
+		static const std::vector<std::string> strings = MakeOffsetStrings(1024);
+		return strings;
+	}
+} // namespace
+
+static void BM_DateTimeParse_Iso(benchmark::State& state)
+{
+	const auto& inputs = IsoStrings();
+	std::size_t i = 0;
+	for (auto _ : state)
+	{
+		benchmark::DoNotOptimize(DateTime::Parse(inputs[i++ & 1023]));
+	}
+	state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_DateTimeParse_Iso);
+
+static void BM_DateTimeTryParse_Offset(benchmark::State& state)
+{
+	const auto& inputs = OffsetStrings();
+	std::size_t i = 0;
+	for (auto _ : state)
+	{
+		benchmark::DoNotOptimize(DateTime::TryParse(inputs[i++ & 1023]));
+	}
+	state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_DateTimeTryParse_Offset);
+
+static void BM_ChronoParse_Iso(benchmark::State& state)
+{
+	const auto& inputs = IsoStrings();
+	std::size_t i = 0;
+	for (auto _ : state)
+	{
+		std::istringstream stream(inputs[i++ & 1023]);
+		std::chrono::sys_time<std::chrono::milliseconds> tp;
+		stream >> std::chrono::parse("%FT%TZ", tp);
+		benchmark::DoNotOptimize(tp);
+	}
+	state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_ChronoParse_Iso);
+
+static void BM_ChronoParse_Offset(benchmark::State& state)
+{
+	const auto& inputs = OffsetStrings();
+	std::size_t i = 0;
+	for (auto _ : state)
+	{
+		std::istringstream stream(inputs[i++ & 1023]);
+		std::chrono::sys_time<std::chrono::milliseconds> tp;
+		stream >> std::chrono::parse("%FT%T%Ez", tp);
+		benchmark::DoNotOptimize(tp);
+	}
+	state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_ChronoParse_Offset);
@@ -0,0 +1,121 @@
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <execution>
+#include <random>
+#include <span>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include <onion/DateTime.hpp>
+#include <onion/Sort.hpp>
+
+using namespace onion;
+
+namespace
+{
+	/// A batch of events within one day, in random order: keys share their high bytes, so 4 radix passes.
+	std::vector<DateTime> Events(std::size_t size)
+	{
+		std::mt19937_64 rng(42);
+		std::uniform_int_distribution<int64_t> dist(1'718'409'600'000, 1'718'495'999'999);
+
+		std::vector<DateTime> result(size, DateTime::FromUnixMillis(0));
+		for (DateTime& value : result)
+			value = DateTime::FromUnixMillis(dist(rng));
+		return result;
+	}
+
+	struct Record
+	{
+		DateTime time;
+		int64_t id;
+		double value;
+	};
+
+	std::vector<Record> Records(std::size_t size)
+	{
+		std::vector<Record> result;
+		result.reserve(size);
+		for (const DateTime& time : Events(size))
+			result.push_back({time, static_cast<int64_t>(result.size()), 1.0});
+		return result;
+	}
+} // namespace
+
+static void BM_StdSort(benchmark::State& state)
+{
+	const auto input = Events(static_cast<std::size_t>(state.range(0)));
+	std::vector<DateTime> values;
+	for (auto _ : state)
+	{
+		values = input;
+		std::sort(values.begin(), values.end());
+		benchmark::DoNotOptimize(values.data());
+	}
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_StdSort)->Arg(1 << 20)->Arg(1 << 24)->Unit(benchmark::kMillisecond);
+
+static void BM_StdSortParallel(benchmark::State& state)
+{
+	const auto input = Events(static_cast<std::size_t>(state.range(0)));
+	std::vector<DateTime> values;
+	for (auto _ : state)
+	{
+		values = input;
+		std::sort(std::execution::par, values.begin(), values.end());
+		benchmark::DoNotOptimize(values.data());
+	}
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_StdSortParallel)->Arg(1 << 20)->Arg(1 << 24)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+static void BM_SortByTime(benchmark::State& state)
+{
+	const auto input = Events(static_cast<std::size_t>(state.range(0)));
+	const auto threads = static_cast<unsigned>(state.range(1));
+	std::vector<DateTime> values;
+	for (auto _ : state)
+	{
+		values = input;
+		sortByTime(values, threads);
+		benchmark::DoNotOptimize(values.data());
+	}
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_SortByTime)
+	->ArgNames({"size", "threads"})
+	->ArgsProduct({{1 << 20, 1 << 24}, {1, 0}})
+	->Unit(benchmark::kMillisecond)
+	->UseRealTime();
+
+static void BM_StdStableSortRecords(benchmark::State& state)
+{
+	const auto input = Records(static_cast<std::size_t>(state.range(0)));
+	std::vector<Record> records;
+	for (auto _ : state)
+	{
+		records = input;
+		std::stable_sort(
+			records.begin(), records.end(), [](const Record& a, const Record& b) { return a.time < b.time; });
+		benchmark::DoNotOptimize(records.data());
+	}
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_StdStableSortRecords)->Arg(1 << 20)->Unit(benchmark::kMillisecond);
+
+static void BM_SortByTimeRecords(benchmark::State& state)
+{
+	const auto input = Records(static_cast<std::size_t>(state.range(0)));
+	std::vector<Record> records;
+	for (auto _ : state)
+	{
+		records = input;
+		sortByTime(std::span<Record>(records), &Record::time);
+		benchmark::DoNotOptimize(records.data());
+	}
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_SortByTimeRecords)->Arg(1 << 20)->Unit(benchmark::kMillisecond);
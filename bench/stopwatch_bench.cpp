@@ -0,0 +1,49 @@
+#include <chrono>
+
+#include <benchmark/benchmark.h>
+
+#include <onion/DateTime.hpp>
+#include <onion/Stopwatch.hpp>
+
+using namespace onion;
+
+static void BM_SteadyStampNow(benchmark::State& state)
+{
+	for (auto _ : state)
+		benchmark::DoNotOptimize(SteadyStamp::Now());
+}
+BENCHMARK(BM_SteadyStampNow);
+
+/// The cost of timing a section with laps: one reading and one conversion to TimeSpan per lap.
+static void BM_StopwatchLap(benchmark::State& state)
+{
+	Stopwatch watch;
+	for (auto _ : state)
+		benchmark::DoNotOptimize(watch.lap());
+}
+BENCHMARK(BM_StopwatchLap);
+
+static void BM_SteadyClockLap(benchmark::State& state)
+{
+	auto previous = std::chrono::steady_clock::now();
+	for (auto _ : state)
+	{
+		const auto now = std::chrono::steady_clock::now();
+		benchmark::DoNotOptimize(TimeSpan(now - previous));
+		previous = now;
+	}
+}
+BENCHMARK(BM_SteadyClockLap);
+
+/// The approach replaced by `Stopwatch`: differences of `UtcNow()`, in whole milliseconds.
+static void BM_UtcNowLap(benchmark::State& state)
+{
+	DateTime previous = DateTime::UtcNow();
+	for (auto _ : state)
+	{
+		const DateTime now = DateTime::UtcNow();
+		benchmark::DoNotOptimize(now - previous);
+		previous = now;
+	}
+}
+BENCHMARK(BM_UtcNowLap);
@@ -0,0 +1,114 @@
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include <onion/DateTime.hpp>
+#include <onion/TimeBucketAggregator.hpp>
+
+using namespace onion;
+
+namespace
+{
+	constexpr std::size_t EventCount = 1 << 16;
+
+	/// Event times 7 ms apart, with one event in 32 late by up to ten seconds, as arrival order roughly follows time.
+	const std::vector<DateTime>& EventTimes()
+	{
+		static const std::vector<DateTime> times = []()
+		{
+			std::vector<DateTime> result;
+			result.reserve(EventCount);
+			for (std::size_t i = 0; i < EventCount; ++i)
+			{
+				const auto millis = static_cast<int64_t>(i) * 7 - (i % 32 == 31 ? static_cast<int64_t>(i % 10'000) : 0);
+				result.push_back(DateTime::FromUnixMillis(1'718'454'645'000 + millis));
+			}
+			return result;
+		}();
+		return times;
+	}
+
+	int MaxThreads()
+	{
+		return static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+	}
+
+	std::unique_ptr<TimeBucketAggregator<int64_t>> SharedAggregator;
+
+	/// The usual alternative: one map of buckets behind a mutex.
+	struct LockedBuckets
+	{
+		std::mutex mutex;
+		std::unordered_map<int64_t, std::pair<uint64_t, int64_t>> buckets;
+	};
+	std::unique_ptr<LockedBuckets> SharedLockedBuckets;
+} // namespace
+
+static void BM_TimeBucketAggregator(benchmark::State& state)
+{
+	const std::vector<DateTime>& times = EventTimes();
+	if (state.thread_index() == 0)
+	{
+		const auto shards = static_cast<std::size_t>(MaxThreads());
+		SharedAggregator = std::make_unique<TimeBucketAggregator<int64_t>>(TimeSpan::FromSeconds(1), shards);
+	}
+
+	for (auto _ : state)
+	{
+		auto& shard = SharedAggregator->shard(static_cast<std::size_t>(state.thread_index()));
+		for (std::size_t i = 0; i < times.size(); ++i)
+			shard.add(times[i], static_cast<int64_t>(i & 1023));
+	}
+	state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(times.size()));
+
+	if (state.thread_index() == 0)
+	{
+		benchmark::DoNotOptimize(SharedAggregator->buckets().size());
+		SharedAggregator.reset();
+	}
+}
+BENCHMARK(BM_TimeBucketAggregator)->ThreadRange(1, MaxThreads())->UseRealTime();
+
+static void BM_TimeBucketMutexMap(benchmark::State& state)
+{
+	const std::vector<DateTime>& times = EventTimes();
+	if (state.thread_index() == 0)
+		SharedLockedBuckets = std::make_unique<LockedBuckets>();
+
+	for (auto _ : state)
+	{
+		for (std::size_t i = 0; i < times.size(); ++i)
+		{
+			const int64_t key = times[i].toUnixMillis() / 1000;
+			std::lock_guard lock(SharedLockedBuckets->mutex);
+			auto& [count, sum] = SharedLockedBuckets->buckets[key];
+			++count;
+			sum += static_cast<int64_t>(i & 1023);
+		}
+	}
+	state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(times.size()));
+
+	if (state.thread_index() == 0)
+		SharedLockedBuckets.reset();
+}
+BENCHMARK(BM_TimeBucketMutexMap)->ThreadRange(1, MaxThreads())->UseRealTime();
+
+/// Merging the shards on read, for 10 000 one-second buckets spread over every shard.
+static void BM_TimeBucketMerge(benchmark::State& state)
+{
+	const std::vector<DateTime>& times = EventTimes();
+	TimeBucketAggregator<int64_t> aggregator(TimeSpan::FromSeconds(1), static_cast<std::size_t>(state.range(0)));
+	for (std::size_t i = 0; i < times.size(); ++i)
+		aggregator.shard(i % aggregator.shardCount()).add(times[i], 1);
+
+	for (auto _ : state)
+		benchmark::DoNotOptimize(aggregator.buckets().data());
+}
+BENCHMARK(BM_TimeBucketMerge)->ArgName("shards")->Arg(1)->Arg(8)->Arg(64);
@@ -0,0 +1,145 @@
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <queue>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include <onion/DateTime.hpp>
+#include <onion/TimerWheel.hpp>
+
+using namespace onion;
+
+namespace
+{
+	constexpr int64_t Horizon = 3'600'000; // timeouts up to one hour ahead, in milliseconds
+	constexpr std::size_t Batch = 4096;
+
+	const DateTime Start = DateTime::FromUnixMillis(1'718'454'645'000);
+
+	/// Random delays within the horizon.
+	std::vector<int64_t> Delays(std::size_t size, uint64_t seed)
+	{
+		std::mt19937_64 rng(seed);
+		std::uniform_int_distribution<int64_t> dist(1, Horizon);
+		std::vector<int64_t> result(size);
+		for (int64_t& delay : result)
+			delay = dist(rng);
+		return result;
+	}
+
+	/// A wheel with `pending` timers spread over the horizon.
+	TimerWheel<uint32_t> PendingWheel(std::size_t pending)
+	{
+		TimerWheel<uint32_t> wheel(Start);
+		wheel.reserve(pending + Batch);
+		const std::vector<int64_t> delays = Delays(pending, 1);
+		for (std::size_t i = 0; i < pending; ++i)
+			wheel.schedule(Start + TimeSpan::FromMilliseconds(delays[i]), static_cast<uint32_t>(i));
+		return wheel;
+	}
+
+	using QueueEntry = std::pair<int64_t, uint32_t>; // due Unix milliseconds, id
+	using Queue = std::priority_queue<QueueEntry, std::vector<QueueEntry>, std::greater<>>;
+
+	Queue PendingQueue(std::size_t pending)
+	{
+		std::vector<QueueEntry> entries;
+		entries.reserve(pending);
+		const std::vector<int64_t> delays = Delays(pending, 1);
+		for (std::size_t i = 0; i < pending; ++i)
+			entries.emplace_back(Start.toUnixMillis() + delays[i], static_cast<uint32_t>(i));
+		return Queue(std::greater<>(), std::move(entries));
+	}
+
+	// 100M pending timers need more than 5 GB, so they only run in builds configured with ONION_BENCH_LARGE.
+	void PendingCounts(benchmark::internal::Benchmark* benchmark)
+	{
+		benchmark->ArgName("pending")->Arg(1'000'000)->Arg(10'000'000);
+#ifdef ONION_BENCH_LARGE
+		benchmark->Arg(100'000'000);
+#endif
+	}
+} // namespace
+
+// Each iteration schedules (or cancels) a batch of 4096 timers in a wheel already holding `pending` timers.
+
+static void BM_TimerWheelSchedule(benchmark::State& state)
+{
+	TimerWheel<uint32_t> wheel = PendingWheel(static_cast<std::size_t>(state.range(0)));
+	const std::vector<int64_t> delays = Delays(Batch, 2);
+	std::vector<TimerWheel<uint32_t>::Handle> handles(Batch);
+	for (auto _ : state)
+	{
+		for (std::size_t i = 0; i < Batch; ++i)
+			handles[i] = wheel.schedule(Start + TimeSpan::FromMilliseconds(delays[i]), static_cast<uint32_t>(i));
+
+		state.PauseTiming();
+		for (const auto& handle : handles)
+			wheel.cancel(handle);
+		state.ResumeTiming();
+	}
+	state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(Batch));
+}
+BENCHMARK(BM_TimerWheelSchedule)->Apply(PendingCounts);
+
+static void BM_TimerWheelCancel(benchmark::State& state)
+{
+	TimerWheel<uint32_t> wheel = PendingWheel(static_cast<std::size_t>(state.range(0)));
+	const std::vector<int64_t> delays = Delays(Batch, 2);
+	std::vector<TimerWheel<uint32_t>::Handle> handles(Batch);
+	for (auto _ : state)
+	{
+		state.PauseTiming();
+		for (std::size_t i = 0; i < Batch; ++i)
+			handles[i] = wheel.schedule(Start + TimeSpan::FromMilliseconds(delays[i]), static_cast<uint32_t>(i));
+		state.ResumeTiming();
+
+		for (const auto& handle : handles)
+			benchmark::DoNotOptimize(wheel.cancel(handle));
+	}
+	state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(Batch));
+}
+BENCHMARK(BM_TimerWheelCancel)->Apply(PendingCounts);
+
+/// Advances by 10 ms per iteration; every expired timer is rescheduled one horizon later, so `pending` timers
+/// stay pending. Items are expired timers.
+static void BM_TimerWheelAdvance(benchmark::State& state)
+{
+	TimerWheel<uint32_t> wheel = PendingWheel(static_cast<std::size_t>(state.range(0)));
+	DateTime now = Start;
+	int64_t expired = 0;
+	const auto reschedule = [&wheel, &now](uint32_t id)
+	{ wheel.schedule(now + TimeSpan::FromMilliseconds(Horizon), id); };
+	for (auto _ : state)
+	{
+		now = now + TimeSpan::FromMilliseconds(10);
+		expired += static_cast<int64_t>(wheel.advance(now, reschedule));
+	}
+	state.SetItemsProcessed(expired);
+}
+BENCHMARK(BM_TimerWheelAdvance)->Apply(PendingCounts);
+
+/// The usual alternative: a binary heap of due times, which cannot cancel, as in BM_TimerWheelAdvance.
+static void BM_PriorityQueueAdvance(benchmark::State& state)
+{
+	Queue queue = PendingQueue(static_cast<std::size_t>(state.range(0)));
+	int64_t now = Start.toUnixMillis();
+	int64_t expired = 0;
+	for (auto _ : state)
+	{
+		now += 10;
+		while (queue.top().first <= now)
+		{
+			const uint32_t id = queue.top().second;
+			queue.pop();
+			queue.emplace(now + Horizon, id);
+			++expired;
+		}
+	}
+	state.SetItemsProcessed(expired);
+}
+BENCHMARK(BM_PriorityQueueAdvance)->Apply(PendingCounts);
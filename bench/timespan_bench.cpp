@@ -0,0 +1,165 @@
+#include <format>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include <onion/TimeSpan.hpp>
+
+using namespace onion;
+
+namespace
+{
+	constexpr std::size_t InputMask = 1023;
+
+	const std::vector<TimeSpan>& Inputs()
+	{
+		static const std::vector<TimeSpan> values = []()
+		{
+			std::vector<TimeSpan> result;
+			result.reserve(InputMask + 1);
+
+			// Mix of signs and magnitudes, from sub-second to several days.
+			int64_t nanoseconds = 1'234'567;
+			for (std::size_t i = 0; i <= InputMask; ++i)
+			{
+				result.push_back(TimeSpan::FromNanoseconds(i % 3 == 0 ? -nanoseconds : nanoseconds));
+				nanoseconds = (nanoseconds * 7 + 1'000'003) % 500'000'000'000'000;
+			}
+			return result;
+		}();
+		return values;
+	}
+} // namespace
+
+// ---- Construction ----
+
+template <typename Factory>
+static void BM_TimeSpanFactory(benchmark::State& state, Factory factory)
+{
+	int64_t value = 1;
+	for (auto _ : state)
+		benchmark::DoNotOptimize(factory(value++ & 1023));
+	state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK_CAPTURE(BM_TimeSpanFactory, FromDays, [](int64_t value) { return TimeSpan::FromDays(value); });
+BENCHMARK_CAPTURE(BM_TimeSpanFactory, FromHours, [](int64_t value) { return TimeSpan::FromHours(value); });
+BENCHMARK_CAPTURE(BM_TimeSpanFactory, FromMinutes, [](int64_t value) { return TimeSpan::FromMinutes(value); });
+BENCHMARK_CAPTURE(BM_TimeSpanFactory, FromSeconds, [](int64_t value) { return TimeSpan::FromSeconds(value); });
+BENCHMARK_CAPTURE(BM_TimeSpanFactory,
+				  FromMilliseconds,
+				  [](int64_t value) { return TimeSpan::FromMilliseconds(value); });
+BENCHMARK_CAPTURE(BM_TimeSpanFactory,
+				  FromMicroseconds,
+				  [](int64_t value) { return TimeSpan::FromMicroseconds(value); });
+BENCHMARK_CAPTURE(BM_TimeSpanFactory,
+				  FromNanoseconds,
+				  [](int64_t value) { return TimeSpan::FromNanoseconds(value); });
+BENCHMARK_CAPTURE(BM_TimeSpanFactory, Components, [](int64_t value) { return TimeSpan(1, 2, 3, 4, value); });
+
+// ---- Operations ----
+
+template <typename Operation>
+static void BM_TimeSpanOperation(benchmark::State& state, Operation operation)
+{
+	const auto& inputs = Inputs();
+	std::size_t i = 0;
+	for (auto _ : state)
+	{
+		benchmark::DoNotOptimize(operation(inputs[i & InputMask], inputs[(i + 1) & InputMask]));
+		++i;
+	}
+	state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK_CAPTURE(BM_TimeSpanOperation, Add, [](TimeSpan a, TimeSpan b) { return a + b; });
+BENCHMARK_CAPTURE(BM_TimeSpanOperation, Subtract, [](TimeSpan a, TimeSpan b) { return a - b; });
+BENCHMARK_CAPTURE(BM_TimeSpanOperation, AddAssign, [](TimeSpan a, TimeSpan b) { return a += b; });
+BENCHMARK_CAPTURE(BM_TimeSpanOperation, SubtractAssign, [](TimeSpan a, TimeSpan b) { return a -= b; });
+BENCHMARK_CAPTURE(BM_TimeSpanOperation, MultiplyInt, [](TimeSpan a, TimeSpan) { return a * 3; });
+BENCHMARK_CAPTURE(BM_TimeSpanOperation, MultiplyDouble, [](TimeSpan a, TimeSpan) { return a * 1.5; });
+BENCHMARK_CAPTURE(BM_TimeSpanOperation, MultiplyAssign, [](TimeSpan a, TimeSpan) { return a *= 3; });
+BENCHMARK_CAPTURE(BM_TimeSpanOperation, DivideInt, [](TimeSpan a, TimeSpan) { return a / 3; });
+BENCHMARK_CAPTURE(BM_TimeSpanOperation, DivideDouble, [](TimeSpan a, TimeSpan) { return a / 1.5; });
+BENCHMARK_CAPTURE(BM_TimeSpanOperation, DivideAssign, [](TimeSpan a, TimeSpan) { return a /= 3; });
+BENCHMARK_CAPTURE(BM_TimeSpanOperation, AddChecked, [](TimeSpan a, TimeSpan b) { return a.AddChecked(b); });
+BENCHMARK_CAPTURE(BM_TimeSpanOperation, AddSaturating, [](TimeSpan a, TimeSpan b) { return a.AddSaturating(b); });
+BENCHMARK_CAPTURE(BM_TimeSpanOperation,
+				  MultiplySaturating,
+				  [](TimeSpan a, TimeSpan) { return a.MultiplySaturating(3); });
+BENCHMARK_CAPTURE(BM_TimeSpanOperation, Equal, [](TimeSpan a, TimeSpan b) { return a == b; });
+BENCHMARK_CAPTURE(BM_TimeSpanOperation, Less, [](TimeSpan a, TimeSpan b) { return a < b; });
+BENCHMARK_CAPTURE(BM_TimeSpanOperation, Abs, [](TimeSpan a, TimeSpan) { return a.Abs(); });
+BENCHMARK_CAPTURE(BM_TimeSpanOperation, TotalDays, [](TimeSpan a, TimeSpan) { return a.TotalDays(); });
+BENCHMARK_CAPTURE(BM_TimeSpanOperation, TotalHours, [](TimeSpan a, TimeSpan) { return a.TotalHours(); });
+BENCHMARK_CAPTURE(BM_TimeSpanOperation, TotalMinutes, [](TimeSpan a, TimeSpan) { return a.TotalMinutes(); });
+BENCHMARK_CAPTURE(BM_TimeSpanOperation, TotalSeconds, [](TimeSpan a, TimeSpan) { return a.TotalSeconds(); });
+BENCHMARK_CAPTURE(BM_TimeSpanOperation,
+				  TotalMilliseconds,
+				  [](TimeSpan a, TimeSpan) { return a.TotalMilliseconds(); });
+BENCHMARK_CAPTURE(BM_TimeSpanOperation,
+				  TotalMicroseconds,
+				  [](TimeSpan a, TimeSpan) { return a.TotalMicroseconds(); });
+BENCHMARK_CAPTURE(BM_TimeSpanOperation, TotalNanoseconds, [](TimeSpan a, TimeSpan) { return a.TotalNanoseconds(); });
+
+// ---- Formatting ----
+
+static void BM_TimeSpanToString(benchmark::State& state)
+{
+	const auto& inputs = Inputs();
+	std::size_t i = 0;
+	for (auto _ : state)
+		benchmark::DoNotOptimize(inputs[i++ & InputMask].ToString());
+	state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_TimeSpanToString);
+
+static void BM_TimeSpanToString_ISO8601(benchmark::State& state)
+{
+	const auto& inputs = Inputs();
+	std::size_t i = 0;
+	for (auto _ : state)
+		benchmark::DoNotOptimize(inputs[i++ & InputMask].ToString_ISO8601());
+	state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_TimeSpanToString_ISO8601);
+
+static void BM_TimeSpanToChars(benchmark::State& state)
+{
+	const auto& inputs = Inputs();
+	char buffer[TimeSpan::MaxStringLength];
+	std::size_t i = 0;
+	for (auto _ : state)
+	{
+		benchmark::DoNotOptimize(inputs[i++ & InputMask].ToChars(buffer, buffer + sizeof(buffer)));
+		benchmark::ClobberMemory();
+	}
+	state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_TimeSpanToChars);
+
+static void BM_TimeSpanToChars_ISO8601(benchmark::State& state)
+{
+	const auto& inputs = Inputs();
+	char buffer[TimeSpan::MaxIsoStringLength];
+	std::size_t i = 0;
+	for (auto _ : state)
+	{
+		benchmark::DoNotOptimize(inputs[i++ & InputMask].ToChars_ISO8601(buffer, buffer + sizeof(buffer)));
+		benchmark::ClobberMemory();
+	}
+	state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_TimeSpanToChars_ISO8601);
+
+static void BM_TimeSpanFormatTo_Milliseconds(benchmark::State& state)
+{
+	const auto& inputs = Inputs();
+	char buffer[TimeSpan::MaxUnitStringLength];
+	std::size_t i = 0;
+	for (auto _ : state)
+	{
+		benchmark::DoNotOptimize(std::format_to(buffer, "{:ms.3}", inputs[i++ & InputMask]));
+		benchmark::ClobberMemory();
+	}
+	state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_TimeSpanFormatTo_Milliseconds);
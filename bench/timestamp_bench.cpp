@@ -0,0 +1,101 @@
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include <onion/DateTime.hpp>
+#include <onion/TimestampFormatter.hpp>
+
+using namespace onion;
+
+namespace
+{
+	constexpr std::size_t LineCount = 1 << 16;
+
+	/// Timestamps of consecutive log lines written at `linesPerSecond`.
+	std::vector<DateTime> LogTimestamps(int64_t linesPerSecond)
+	{
+		std::vector<DateTime> result(LineCount, DateTime::FromUnixMillis(0));
+		for (std::size_t i = 0; i < LineCount; ++i)
+			result[i] = DateTime::FromUnixMillis(1'718'454'645'000 + static_cast<int64_t>(i) * 1000 / linesPerSecond);
+		return result;
+	}
+
+	void ReportHitRate(benchmark::State& state)
+	{
+		const TimestampFormatter::Statistics statistics = TimestampFormatter::threadStatistics();
+		const auto total = static_cast<double>(statistics.hits + statistics.misses);
+		state.counters["hit_rate"] = total > 0 ? static_cast<double>(statistics.hits) / total : 0.0;
+	}
+} // namespace
+
+static void BM_DateTimeToChars_Iso(benchmark::State& state)
+{
+	const auto timestamps = LogTimestamps(state.range(0));
+	char buffer[64];
+
+	for (auto _ : state)
+		for (const DateTime& timestamp : timestamps)
+			benchmark::DoNotOptimize(timestamp.toChars(buffer, buffer + sizeof(buffer)));
+	state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(LineCount));
+}
+BENCHMARK(BM_DateTimeToChars_Iso)->ArgName("linesPerSecond")->Arg(1'000)->Arg(1'000'000);
+
+static void BM_TimestampFormatter_Iso(benchmark::State& state)
+{
+	const auto timestamps = LogTimestamps(state.range(0));
+	const TimestampFormatter formatter;
+	char buffer[64];
+
+	TimestampFormatter::resetThreadStatistics();
+	for (auto _ : state)
+		for (const DateTime& timestamp : timestamps)
+			benchmark::DoNotOptimize(formatter.formatTo(timestamp, buffer, buffer + sizeof(buffer)));
+	state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(LineCount));
+	ReportHitRate(state);
+}
+BENCHMARK(BM_TimestampFormatter_Iso)->ArgName("linesPerSecond")->Arg(1'000)->Arg(1'000'000);
+
+static void BM_PatternFormatTo(benchmark::State& state)
+{
+	const auto timestamps = LogTimestamps(state.range(0));
+	const DateTime::Pattern pattern("%a %d %b %Y %T");
+	char buffer[64];
+
+	for (auto _ : state)
+		for (const DateTime& timestamp : timestamps)
+			benchmark::DoNotOptimize(pattern.formatTo(timestamp, buffer, buffer + sizeof(buffer)));
+	state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(LineCount));
+}
+BENCHMARK(BM_PatternFormatTo)->ArgName("linesPerSecond")->Arg(1'000)->Arg(1'000'000);
+
+static void BM_TimestampFormatter_Pattern(benchmark::State& state)
+{
+	const auto timestamps = LogTimestamps(state.range(0));
+	const TimestampFormatter formatter("%a %d %b %Y %T");
+	char buffer[64];
+
+	TimestampFormatter::resetThreadStatistics();
+	for (auto _ : state)
+		for (const DateTime& timestamp : timestamps)
+			benchmark::DoNotOptimize(formatter.formatTo(timestamp, buffer, buffer + sizeof(buffer)));
+	state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(LineCount));
+	ReportHitRate(state);
+}
+BENCHMARK(BM_TimestampFormatter_Pattern)->ArgName("linesPerSecond")->Arg(1'000)->Arg(1'000'000);
+
+static void BM_Memcpy_Baseline(benchmark::State& state)
+{
+	const char text[] = "2024-06-15T12:30:45.500Z";
+	char buffer[64];
+
+	for (auto _ : state)
+		for (std::size_t i = 0; i < LineCount; ++i)
+		{
+			std::memcpy(buffer, text, sizeof(text) - 1);
+			benchmark::DoNotOptimize(buffer);
+		}
+	state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(LineCount));
+}
+BENCHMARK(BM_Memcpy_Baseline);
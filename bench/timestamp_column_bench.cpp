@@ -0,0 +1,106 @@
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include <onion/DateTime.hpp>
+#include <onion/TimestampColumn.hpp>
+
+using namespace onion;
+
+namespace
+{
+	constexpr std::size_t ValueCount = 1 << 20;
+	constexpr std::size_t InputMask = 1023;
+
+	/// Sorted timestamps: one per second (range(0) == 0), or one per second with up to 50 ms of jitter
+	/// (range(0) == 1).
+	std::vector<DateTime> Series(int64_t jitter)
+	{
+		std::vector<DateTime> result(ValueCount, DateTime::FromUnixMillis(0));
+		for (std::size_t i = 0; i < result.size(); ++i)
+		{
+			const auto index = static_cast<int64_t>(i);
+			result[i] = DateTime::FromUnixMillis(1'718'454'645'000 + index * 1'000 + jitter * (index * 7'919 % 51));
+		}
+		return result;
+	}
+
+	void SetBitsPerValue(benchmark::State& state, const TimestampColumn& column)
+	{
+		state.counters["bits_per_value"] =
+			static_cast<double>(column.compressedBytes() * 8) / static_cast<double>(column.size());
+	}
+} // namespace
+
+static void BM_TimestampColumnAppend(benchmark::State& state)
+{
+	const auto values = Series(state.range(0));
+	for (auto _ : state)
+	{
+		TimestampColumn column;
+		column.append(values);
+		benchmark::DoNotOptimize(column.size());
+	}
+	state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(values.size()));
+}
+BENCHMARK(BM_TimestampColumnAppend)->Arg(0)->Arg(1);
+
+static void BM_TimestampColumnDecode(benchmark::State& state)
+{
+	const auto values = Series(state.range(0));
+	TimestampColumn column;
+	column.append(values);
+
+	std::vector<DateTime> out(values.size(), DateTime::FromUnixMillis(0));
+	for (auto _ : state)
+	{
+		column.decode(out);
+		benchmark::DoNotOptimize(out.data());
+	}
+	state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(values.size()));
+	SetBitsPerValue(state, column);
+}
+BENCHMARK(BM_TimestampColumnDecode)->Arg(0)->Arg(1);
+
+static void BM_VectorCopy(benchmark::State& state)
+{
+	// Baseline: the same values, uncompressed.
+	const auto values = Series(state.range(0));
+	std::vector<DateTime> out(values.size(), DateTime::FromUnixMillis(0));
+	for (auto _ : state)
+	{
+		out = values;
+		benchmark::DoNotOptimize(out.data());
+	}
+	state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(values.size()));
+	state.counters["bits_per_value"] = 64;
+}
+BENCHMARK(BM_VectorCopy)->Arg(0)->Arg(1);
+
+static void BM_TimestampColumnAt(benchmark::State& state)
+{
+	const auto values = Series(state.range(0));
+	TimestampColumn column;
+	column.append(values);
+
+	std::size_t i = 0;
+	for (auto _ : state)
+		benchmark::DoNotOptimize(column.at((i++ & InputMask) * 1'021 % values.size()));
+	state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_TimestampColumnAt)->Arg(0)->Arg(1);
+
+static void BM_TimestampColumnLowerBound(benchmark::State& state)
+{
+	const auto values = Series(state.range(0));
+	TimestampColumn column;
+	column.append(values);
+
+	std::size_t i = 0;
+	for (auto _ : state)
+		benchmark::DoNotOptimize(column.lowerBound(values[(i++ & InputMask) * 1'021 % values.size()]));
+	state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_TimestampColumnLowerBound)->Arg(0)->Arg(1);
@@ -0,0 +1,152 @@
+#include <chrono>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include <onion/DateTime.hpp>
+#include <onion/TimeZone.hpp>
+
+using namespace onion;
+
+namespace
+{
+	constexpr std::size_t InputMask = 1023;
+
+	/// Instants spread over 1990-2050, so that lookups hit every part of the transition table.
+	const std::vector<DateTime>& Instants()
+	{
+		static const std::vector<DateTime> values = []()
+		{
+			std::vector<DateTime> result;
+			result.reserve(InputMask + 1);
+			for (std::size_t i = 0; i <= InputMask; ++i)
+				result.push_back(DateTime::FromUnixSeconds(631'152'000 + static_cast<int64_t>(i) * 1'849'243));
+			return result;
+		}();
+		return values;
+	}
+
+	/// Event timestamps one second apart, as in a sorted log.
+	std::vector<DateTime> Events()
+	{
+		std::vector<DateTime> result(1 << 16, DateTime::FromUnixMillis(0));
+		for (std::size_t i = 0; i < result.size(); ++i)
+			result[i] = DateTime::FromUnixSeconds(1'718'454'645 + static_cast<int64_t>(i));
+		return result;
+	}
+
+	/// Loads the zone, or skips the benchmark when the time zone database is not installed.
+	std::optional<TimeZone> LoadOrSkip(benchmark::State& state)
+	{
+		auto zone = TimeZone::TryLoad("Europe/Paris");
+		if (!zone)
+			state.SkipWithError("Europe/Paris not found in the time zone database");
+		return zone;
+	}
+} // namespace
+
+// ---- Single conversions ----
+
+static void BM_TimeZoneLoad(benchmark::State& state)
+{
+	for (auto _ : state)
+		benchmark::DoNotOptimize(TimeZone::TryLoad("Europe/Paris"));
+}
+BENCHMARK(BM_TimeZoneLoad);
+
+static void BM_TimeZoneToLocal(benchmark::State& state)
+{
+	const auto zone = LoadOrSkip(state);
+	if (!zone)
+		return;
+
+	const auto& inputs = Instants();
+	std::size_t i = 0;
+	for (auto _ : state)
+		benchmark::DoNotOptimize(zone->toLocal(inputs[i++ & InputMask]));
+	state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_TimeZoneToLocal);
+
+static void BM_TimeZoneFromLocal(benchmark::State& state)
+{
+	const auto zone = LoadOrSkip(state);
+	if (!zone)
+		return;
+
+	const auto& inputs = Instants();
+	std::size_t i = 0;
+	for (auto _ : state)
+		benchmark::DoNotOptimize(zone->fromLocal(inputs[i++ & InputMask]));
+	state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_TimeZoneFromLocal);
+
+static void BM_TimeZoneToLocal_Rule(benchmark::State& state)
+{
+	// Beyond TimeZone::ExpandedUntilYear, offsets come from the POSIX rule.
+	const auto zone = LoadOrSkip(state);
+	if (!zone)
+		return;
+
+	const DateTime instant(2300, 7, 1, 12, 0, 0);
+	for (auto _ : state)
+		benchmark::DoNotOptimize(zone->toLocal(instant));
+	state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_TimeZoneToLocal_Rule);
+
+#if defined(__cpp_lib_chrono) && __cpp_lib_chrono >= 201907L
+static void BM_StdZonedTime(benchmark::State& state)
+{
+	const std::chrono::time_zone* zone = std::chrono::locate_zone("Europe/Paris");
+	const auto& inputs = Instants();
+	std::size_t i = 0;
+	for (auto _ : state)
+	{
+		const auto utc = std::chrono::sys_time<std::chrono::milliseconds>(
+			std::chrono::milliseconds(inputs[i++ & InputMask].toUnixMillis()));
+		benchmark::DoNotOptimize(std::chrono::zoned_time(zone, utc).get_local_time());
+	}
+	state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_StdZonedTime);
+#endif
+
+// ---- Columns ----
+
+static void BM_TimeZoneToLocal_Batch(benchmark::State& state)
+{
+	const auto zone = LoadOrSkip(state);
+	if (!zone)
+		return;
+
+	const auto events = Events();
+	std::vector<DateTime> out(events.size(), DateTime::FromUnixMillis(0));
+	for (auto _ : state)
+	{
+		zone->toLocal(events, out);
+		benchmark::DoNotOptimize(out.data());
+	}
+	state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(events.size()));
+}
+BENCHMARK(BM_TimeZoneToLocal_Batch);
+
+static void BM_TimeZoneFromLocal_Batch(benchmark::State& state)
+{
+	const auto zone = LoadOrSkip(state);
+	if (!zone)
+		return;
+
+	const auto events = Events();
+	std::vector<DateTime> out(events.size(), DateTime::FromUnixMillis(0));
+	for (auto _ : state)
+	{
+		zone->fromLocal(events, out);
+		benchmark::DoNotOptimize(out.data());
+	}
+	state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(events.size()));
+}
+BENCHMARK(BM_TimeZoneFromLocal_Batch);
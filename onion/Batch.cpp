@@ -0,0 +1,531 @@
+#include "Batch.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <chrono>
+#include <cstddef>
+#include <stdexcept>
+#include <type_traits>
+
+#include "Config.hpp"
+#include "detail/Calendar.hpp"
+
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define ONION_BATCH_X86 1
+#define ONION_BATCH_KERNEL [[gnu::always_inline]] inline
+#else
+#define ONION_BATCH_X86 0
+#define ONION_BATCH_KERNEL inline
+#endif
+
+namespace onion::batch
+{
+	namespace
+	{
+		constexpr std::size_t ChunkSize = 256;
+
+		/// Column pointers for one chunk. Skipped columns point to distinct scratch storage, so the kernel has no
+		/// branches and the pointers never alias.
+		struct ChunkColumns
+		{
+			int32_t* years;
+			int32_t* months;
+			int32_t* days;
+			int32_t* hours;
+			int32_t* minutes;
+			int32_t* seconds;
+			int32_t* milliseconds;
+		};
+
+		// ---- Stage 1: split milliseconds into shifted days (see detail::civilFromShiftedDays) and ms of day ----
+
+		/// Exact 64-bit floor division; used where 64-bit lanes cannot be vectorized.
+		ONION_BATCH_KERNEL void splitDays(const int64_t* __restrict epochMs,
+										  uint32_t* __restrict shiftedDays,
+										  uint32_t* __restrict msOfDay,
+										  std::size_t count) noexcept
+		{
+			for (std::size_t i = 0; i < count; ++i)
+			{
+				const int64_t days = detail::floorDiv(epochMs[i], detail::MillisPerDay);
+				shiftedDays[i] = static_cast<uint32_t>(days + detail::CalendarDayShift);
+				msOfDay[i] = static_cast<uint32_t>(epochMs[i] - days * detail::MillisPerDay);
+			}
+		}
+
+		/// Division through a double reciprocal followed by an exact integer correction. Every supported
+		/// millisecond value is below 2^53, so the estimate is off by at most one day. Vectorizes with AVX-512DQ.
+		ONION_BATCH_KERNEL void splitDaysReciprocal(const int64_t* __restrict epochMs,
+													uint32_t* __restrict shiftedDays,
+													uint32_t* __restrict msOfDay,
+													std::size_t count) noexcept
+		{
+			constexpr double reciprocal = 1.0 / static_cast<double>(detail::MillisPerDay);
+			for (std::size_t i = 0; i < count; ++i)
+			{
+				int64_t days = static_cast<int64_t>(static_cast<double>(epochMs[i]) * reciprocal);
+				int64_t rest = epochMs[i] - days * detail::MillisPerDay;
+				days += static_cast<int64_t>(rest >= detail::MillisPerDay) - static_cast<int64_t>(rest < 0);
+				rest = epochMs[i] - days * detail::MillisPerDay;
+
+				shiftedDays[i] = static_cast<uint32_t>(days + detail::CalendarDayShift);
+				msOfDay[i] = static_cast<uint32_t>(rest);
+			}
+		}
+
+		// ---- Stage 2: 32-bit civil-from-days and time-of-day split ----
+		// Kept as two loops: GCC does not vectorize the fused loop.
+
+		ONION_BATCH_KERNEL void civilColumns(const uint32_t* __restrict shiftedDays,
+											 const uint32_t* __restrict msOfDay,
+											 const ChunkColumns& out,
+											 std::size_t count) noexcept
+		{
+			int32_t* __restrict years = out.years;
+			int32_t* __restrict months = out.months;
+			int32_t* __restrict days = out.days;
+			for (std::size_t i = 0; i < count; ++i)
+			{
+				const detail::CivilDate date = detail::civilFromShiftedDays(shiftedDays[i]);
+				years[i] = date.year;
+				months[i] = static_cast<int32_t>(date.month);
+				days[i] = static_cast<int32_t>(date.day);
+			}
+
+			int32_t* __restrict hours = out.hours;
+			int32_t* __restrict minutes = out.minutes;
+			int32_t* __restrict seconds = out.seconds;
+			int32_t* __restrict milliseconds = out.milliseconds;
+			for (std::size_t i = 0; i < count; ++i)
+			{
+				const uint32_t ms = msOfDay[i];
+				hours[i] = static_cast<int32_t>(ms / 3'600'000u);
+				minutes[i] = static_cast<int32_t>(ms / 60'000u % 60u);
+				seconds[i] = static_cast<int32_t>(ms / 1'000u % 60u);
+				milliseconds[i] = static_cast<int32_t>(ms % 1'000u);
+			}
+		}
+
+		template <bool Reciprocal>
+		ONION_BATCH_KERNEL void decomposeKernel(std::span<const int64_t> epochMs, const CalendarColumns& out) noexcept
+		{
+			alignas(64) uint32_t shiftedDays[ChunkSize];
+			alignas(64) uint32_t msOfDay[ChunkSize];
+			alignas(64) int32_t scratch[7][ChunkSize];
+
+			auto column = [&](std::span<int32_t> target, std::size_t index, std::size_t offset)
+			{ return target.empty() ? scratch[index] : target.data() + offset; };
+
+			for (std::size_t offset = 0; offset < epochMs.size(); offset += ChunkSize)
+			{
+				const std::size_t count = std::min(ChunkSize, epochMs.size() - offset);
+
+				if constexpr (Reciprocal)
+					splitDaysReciprocal(epochMs.data() + offset, shiftedDays, msOfDay, count);
+				else
+					splitDays(epochMs.data() + offset, shiftedDays, msOfDay, count);
+
+				const ChunkColumns chunk{column(out.years, 0, offset),
+										 column(out.months, 1, offset),
+										 column(out.days, 2, offset),
+										 column(out.hours, 3, offset),
+										 column(out.minutes, 4, offset),
+										 column(out.seconds, 5, offset),
+										 column(out.milliseconds, 6, offset)};
+				civilColumns(shiftedDays, msOfDay, chunk, count);
+			}
+		}
+
+		// ---- Instruction set variants ----
+
+		void decomposeScalar(std::span<const int64_t> epochMs, const CalendarColumns& out) noexcept
+		{
+			decomposeKernel<false>(epochMs, out);
+		}
+
+#if ONION_BATCH_X86
+		__attribute__((target("avx2"))) void decomposeAvx2(std::span<const int64_t> epochMs,
+														   const CalendarColumns& out) noexcept
+		{
+			decomposeKernel<false>(epochMs, out);
+		}
+
+		__attribute__((target("avx512f,avx512dq,avx512vl,avx512bw"))) void decomposeAvx512(
+			std::span<const int64_t> epochMs, const CalendarColumns& out) noexcept
+		{
+			decomposeKernel<true>(epochMs, out);
+		}
+#endif
+
+		bool isSupported(Isa isa) noexcept
+		{
+			switch (isa)
+			{
+#if ONION_BATCH_X86
+				case Isa::Avx512:
+					return __builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512dq") &&
+						__builtin_cpu_supports("avx512vl") && __builtin_cpu_supports("avx512bw");
+				case Isa::Avx2:
+					return __builtin_cpu_supports("avx2");
+#endif
+				case Isa::Scalar:
+					return true;
+				default:
+					return false;
+			}
+		}
+
+		void checkColumn(std::span<const int32_t> column, std::size_t size)
+		{
+			if (!column.empty() && column.size() < size)
+				detail::raise(std::invalid_argument("batch::decompose: output column is shorter than the input"));
+		}
+
+		// ---- Unix time columns ----
+
+		static_assert(sizeof(DateTime) == sizeof(int64_t) && std::is_trivially_copyable_v<DateTime>,
+					  "DateTime columns are converted as their Unix millisecond representation");
+
+		template <typename In, typename Out> void checkOutput(std::span<In> in, std::span<Out> out)
+		{
+			if (out.size() < in.size())
+				detail::raise(std::invalid_argument("batch: output column is shorter than the input"));
+		}
+
+		template <int64_t UnitsPerSecond> void fromUnixTime(std::span<const int64_t> values, std::span<DateTime> out)
+		{
+			checkOutput(values, out);
+
+			const int64_t* __restrict in = values.data();
+			DateTime* __restrict dateTimes = out.data();
+			for (std::size_t i = 0; i < values.size(); ++i)
+			{
+				if (in[i] < detail::MinUnixTime<UnitsPerSecond> || in[i] > detail::MaxUnixTime<UnitsPerSecond>)
+					detail::raise(std::out_of_range("batch: Unix time out of DateTime range"));
+				dateTimes[i] = std::bit_cast<DateTime>(detail::unixTimeToMillis<UnitsPerSecond>(in[i]));
+			}
+		}
+
+		template <int64_t UnitsPerSecond> void toUnixTime(std::span<const DateTime> dateTimes, std::span<int64_t> out)
+		{
+			checkOutput(dateTimes, out);
+
+			const DateTime* __restrict in = dateTimes.data();
+			int64_t* __restrict values = out.data();
+			for (std::size_t i = 0; i < dateTimes.size(); ++i)
+			{
+				const int64_t unixMillis = in[i].toUnixMillis();
+				if (unixMillis < detail::MinConvertibleMillis<UnitsPerSecond> ||
+					unixMillis > detail::MaxConvertibleMillis<UnitsPerSecond>)
+					detail::raise(std::out_of_range("batch: DateTime out of the int64 Unix time range"));
+				values[i] = detail::millisToUnixTime<UnitsPerSecond>(unixMillis);
+			}
+		}
+
+		// ---- Time buckets ----
+
+		/// Buckets of `bucketize`: fixed intervals of `interval` ms from `origin`, or calendar periods of `months`
+		/// months if it is not zero. Days and ISO weeks are fixed intervals.
+		struct BucketLayout
+		{
+			int64_t interval;
+			int64_t origin;
+			unsigned months;
+		};
+
+		BucketLayout calendarLayout(CalendarUnit unit) noexcept
+		{
+			switch (unit)
+			{
+				case CalendarUnit::Week:
+					return {7 * detail::MillisPerDay, -3 * detail::MillisPerDay, 0}; // from Monday 1969-12-29
+				case CalendarUnit::Month:
+					return {0, 0, 1};
+				case CalendarUnit::Quarter:
+					return {0, 0, 3};
+				case CalendarUnit::Year:
+					return {0, 0, 12};
+				default:
+					return {detail::MillisPerDay, 0, 0};
+			}
+		}
+
+		int64_t intervalMillis(const TimeSpan& interval)
+		{
+			const int64_t ms = std::chrono::duration_cast<std::chrono::milliseconds>(interval.GetDuration()).count();
+			if (ms <= 0)
+				detail::raise(std::invalid_argument("batch::bucketize: interval is shorter than 1 ms"));
+			return ms;
+		}
+
+		/// Fixed-interval bucket ids. The reciprocal variant shifts the values by a whole number of intervals to
+		/// make them non-negative; they stay below 2^50, so as in splitDaysReciprocal the double estimate of the
+		/// quotient is off by at most one and corrected exactly.
+		template <bool Reciprocal>
+		ONION_BATCH_KERNEL void intervalIds(const DateTime* __restrict in,
+											int64_t* __restrict ids,
+											std::size_t count,
+											int64_t interval,
+											int64_t origin) noexcept
+		{
+			if constexpr (Reciprocal)
+			{
+				const int64_t shift = detail::floorDiv(origin - detail::MinUnixMillis + interval - 1, interval);
+				const int64_t base = shift * interval - origin;
+				const double reciprocal = 1.0 / static_cast<double>(interval);
+				for (std::size_t i = 0; i < count; ++i)
+				{
+					const int64_t value = in[i].toUnixMillis() + base;
+					int64_t quotient = static_cast<int64_t>(static_cast<double>(value) * reciprocal);
+					const int64_t rest = value - quotient * interval;
+					quotient += static_cast<int64_t>(rest >= interval) - static_cast<int64_t>(rest < 0);
+					ids[i] = quotient - shift;
+				}
+			}
+			else
+			{
+				for (std::size_t i = 0; i < count; ++i)
+					ids[i] = detail::floorDiv(in[i].toUnixMillis() - origin, interval);
+			}
+		}
+
+		/// Calendar period ids, counted from 0001-01 so the division is unsigned; 1969 years are a whole number
+		/// of periods.
+		template <unsigned Months>
+		ONION_BATCH_KERNEL void periodIds(const uint32_t* __restrict shiftedDays,
+										  int64_t* __restrict ids,
+										  std::size_t count) noexcept
+		{
+			constexpr int64_t EpochPeriod = 1969 * 12 / Months;
+			for (std::size_t i = 0; i < count; ++i)
+			{
+				const detail::CivilDate date = detail::civilFromShiftedDays(shiftedDays[i]);
+				const auto monthIndex = static_cast<uint32_t>(date.year - 1) * 12u + date.month - 1u;
+				ids[i] = static_cast<int64_t>(monthIndex / Months) - EpochPeriod;
+			}
+		}
+
+		template <bool Reciprocal>
+		ONION_BATCH_KERNEL void bucketKernel(std::span<const DateTime> dateTimes,
+											 const BucketLayout& layout,
+											 int64_t* ids) noexcept
+		{
+			if (layout.months == 0)
+			{
+				intervalIds<Reciprocal>(dateTimes.data(), ids, dateTimes.size(), layout.interval, layout.origin);
+				return;
+			}
+
+			alignas(64) int64_t epochMs[ChunkSize];
+			alignas(64) uint32_t shiftedDays[ChunkSize];
+			alignas(64) uint32_t msOfDay[ChunkSize];
+
+			for (std::size_t offset = 0; offset < dateTimes.size(); offset += ChunkSize)
+			{
+				const std::size_t count = std::min(ChunkSize, dateTimes.size() - offset);
+				for (std::size_t i = 0; i < count; ++i)
+					epochMs[i] = dateTimes[offset + i].toUnixMillis();
+
+				if constexpr (Reciprocal)
+					splitDaysReciprocal(epochMs, shiftedDays, msOfDay, count);
+				else
+					splitDays(epochMs, shiftedDays, msOfDay, count);
+
+				if (layout.months == 1)
+					periodIds<1>(shiftedDays, ids + offset, count);
+				else if (layout.months == 3)
+					periodIds<3>(shiftedDays, ids + offset, count);
+				else
+					periodIds<12>(shiftedDays, ids + offset, count);
+			}
+		}
+
+		void bucketizeScalar(std::span<const DateTime> dateTimes, const BucketLayout& layout, int64_t* ids) noexcept
+		{
+			bucketKernel<false>(dateTimes, layout, ids);
+		}
+
+#if ONION_BATCH_X86
+		__attribute__((target("avx2"))) void bucketizeAvx2(std::span<const DateTime> dateTimes,
+														   const BucketLayout& layout,
+														   int64_t* ids) noexcept
+		{
+			bucketKernel<false>(dateTimes, layout, ids);
+		}
+
+		__attribute__((target("avx512f,avx512dq,avx512vl,avx512bw"))) void bucketizeAvx512(
+			std::span<const DateTime> dateTimes, const BucketLayout& layout, int64_t* ids) noexcept
+		{
+			bucketKernel<true>(dateTimes, layout, ids);
+		}
+#endif
+
+		DateTime intervalStart(int64_t bucketId, int64_t interval, int64_t origin)
+		{
+			int64_t offset = 0;
+			int64_t unixMillis = 0;
+			if (detail::mulOverflow(bucketId, interval, offset) || detail::addOverflow(origin, offset, unixMillis))
+				detail::raise(std::out_of_range("batch::bucketStart: bucket out of DateTime range"));
+			return DateTime::FromUnixMillis(unixMillis);
+		}
+
+		void bucketizeColumn(std::span<const DateTime> dateTimes,
+							 const BucketLayout& layout,
+							 std::span<int64_t> bucketIds,
+							 Isa isa)
+		{
+			checkOutput(dateTimes, bucketIds);
+
+			while (!isSupported(isa))
+				isa = static_cast<Isa>(static_cast<int>(isa) - 1);
+
+			switch (isa)
+			{
+#if ONION_BATCH_X86
+				case Isa::Avx512:
+					bucketizeAvx512(dateTimes, layout, bucketIds.data());
+					break;
+				case Isa::Avx2:
+					bucketizeAvx2(dateTimes, layout, bucketIds.data());
+					break;
+#endif
+				default:
+					bucketizeScalar(dateTimes, layout, bucketIds.data());
+					break;
+			}
+		}
+	} // namespace
+
+	ONION_INLINE Isa activeIsa() noexcept
+	{
+		static const Isa isa = isSupported(Isa::Avx512) ? Isa::Avx512
+			: isSupported(Isa::Avx2)					? Isa::Avx2
+														: Isa::Scalar;
+		return isa;
+	}
+
+	ONION_INLINE void decompose(std::span<const int64_t> epochMs, const CalendarColumns& out)
+	{
+		decompose(epochMs, out, activeIsa());
+	}
+
+	ONION_INLINE void decompose(std::span<const int64_t> epochMs, const CalendarColumns& out, Isa isa)
+	{
+		for (std::span<const int32_t> column :
+			 {out.years, out.months, out.days, out.hours, out.minutes, out.seconds, out.milliseconds})
+			checkColumn(column, epochMs.size());
+
+		while (!isSupported(isa))
+			isa = static_cast<Isa>(static_cast<int>(isa) - 1);
+
+		switch (isa)
+		{
+#if ONION_BATCH_X86
+			case Isa::Avx512:
+				decomposeAvx512(epochMs, out);
+				break;
+			case Isa::Avx2:
+				decomposeAvx2(epochMs, out);
+				break;
+#endif
+			default:
+				decomposeScalar(epochMs, out);
+				break;
+		}
+	}
+
+	// ---- Unix time columns ----
+
+	ONION_INLINE void fromUnixSeconds(std::span<const int64_t> seconds, std::span<DateTime> out)
+	{
+		fromUnixTime<1>(seconds, out);
+	}
+
+	ONION_INLINE void fromUnixMillis(std::span<const int64_t> milliseconds, std::span<DateTime> out)
+	{
+		fromUnixTime<1'000>(milliseconds, out);
+	}
+
+	ONION_INLINE void fromUnixMicros(std::span<const int64_t> microseconds, std::span<DateTime> out)
+	{
+		fromUnixTime<1'000'000>(microseconds, out);
+	}
+
+	ONION_INLINE void fromUnixNanos(std::span<const int64_t> nanoseconds, std::span<DateTime> out)
+	{
+		fromUnixTime<1'000'000'000>(nanoseconds, out);
+	}
+
+	ONION_INLINE void toUnixSeconds(std::span<const DateTime> dateTimes, std::span<int64_t> out)
+	{
+		toUnixTime<1>(dateTimes, out);
+	}
+
+	ONION_INLINE void toUnixMillis(std::span<const DateTime> dateTimes, std::span<int64_t> out)
+	{
+		toUnixTime<1'000>(dateTimes, out);
+	}
+
+	ONION_INLINE void toUnixMicros(std::span<const DateTime> dateTimes, std::span<int64_t> out)
+	{
+		toUnixTime<1'000'000>(dateTimes, out);
+	}
+
+	ONION_INLINE void toUnixNanos(std::span<const DateTime> dateTimes, std::span<int64_t> out)
+	{
+		toUnixTime<1'000'000'000>(dateTimes, out);
+	}
+
+	// ---- Time buckets ----
+
+	ONION_INLINE void bucketize(std::span<const DateTime> dateTimes, CalendarUnit unit, std::span<int64_t> bucketIds)
+	{
+		bucketize(dateTimes, unit, bucketIds, activeIsa());
+	}
+
+	ONION_INLINE void bucketize(std::span<const DateTime> dateTimes,
+								const TimeSpan& interval,
+								std::span<int64_t> bucketIds,
+								const DateTime& origin)
+	{
+		const BucketLayout layout{intervalMillis(interval), origin.toUnixMillis(), 0};
+		bucketizeColumn(dateTimes, layout, bucketIds, activeIsa());
+	}
+
+	ONION_INLINE void bucketize(std::span<const DateTime> dateTimes,
+								CalendarUnit unit,
+								std::span<int64_t> bucketIds,
+								Isa isa)
+	{
+		bucketizeColumn(dateTimes, calendarLayout(unit), bucketIds, isa);
+	}
+
+	ONION_INLINE DateTime bucketStart(int64_t bucketId, CalendarUnit unit)
+	{
+		const BucketLayout layout = calendarLayout(unit);
+		if (layout.months == 0)
+			return intervalStart(bucketId, layout.interval, layout.origin);
+
+		// Ids outside the DateTime range are rejected before the multiplication can overflow.
+		const int64_t periods = 9999 * 12 / static_cast<int64_t>(layout.months);
+		if (bucketId < -periods || bucketId > periods)
+			detail::raise(std::out_of_range("batch::bucketStart: bucket out of DateTime range"));
+
+		const int64_t monthIndex = bucketId * static_cast<int64_t>(layout.months);
+		const int64_t year = 1970 + detail::floorDiv(monthIndex, 12);
+		if (year < 1 || year > 9999)
+			detail::raise(std::out_of_range("batch::bucketStart: bucket out of DateTime range"));
+
+		const auto month = static_cast<unsigned>(monthIndex - (year - 1970) * 12) + 1;
+		return DateTime::FromUnixMillis(detail::daysFromCivil(static_cast<int>(year), month, 1) * detail::MillisPerDay);
+	}
+
+	ONION_INLINE DateTime bucketStart(int64_t bucketId, const TimeSpan& interval, const DateTime& origin)
+	{
+		return intervalStart(bucketId, intervalMillis(interval), origin.toUnixMillis());
+	}
+
+} // namespace onion::batch
+
+#undef ONION_BATCH_X86
+#undef ONION_BATCH_KERNEL
@@ -0,0 +1,131 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+
+#include "DateTime.hpp"
+
+namespace onion::batch
+{
+	/// Destination columns for `decompose`.
+	///
+	/// Every column is optional: an empty span is skipped. A non-empty span must hold at least as many
+	/// elements as the input.
+	struct CalendarColumns
+	{
+		std::span<int32_t> years{};
+		std::span<int32_t> months{};
+		std::span<int32_t> days{};
+		std::span<int32_t> hours{};
+		std::span<int32_t> minutes{};
+		std::span<int32_t> seconds{};
+		std::span<int32_t> milliseconds{};
+	};
+
+	/// Instruction sets the batch kernels can run on.
+	enum class Isa
+	{
+		Scalar,
+		Avx2,
+		Avx512,
+	};
+
+	/// Returns the best instruction set supported by the running CPU, which `decompose` uses by default.
+	Isa activeIsa() noexcept;
+
+	/// Converts a column of Unix epoch milliseconds into calendar columns.
+	///
+	/// Each output element is what the corresponding `DateTime` getter returns for that instant. Inputs are
+	/// expected to be in the DateTime range [0001-01-01, 9999-12-31]; other values produce unspecified components.
+	/// The integer civil-from-days math is vectorized with AVX-512 or AVX2 when the CPU supports it, with a
+	/// portable scalar fallback selected at runtime.
+	/// @param epochMs Milliseconds since 1970-01-01T00:00:00Z.
+	/// @param out Destination columns.
+	/// @throws std::invalid_argument If a non-empty column is shorter than `epochMs`.
+	void decompose(std::span<const int64_t> epochMs, const CalendarColumns& out);
+
+	/// Same as `decompose(epochMs, out)`, using the given instruction set instead of `activeIsa()`.
+	/// Falls back to a supported instruction set if the CPU does not support `isa`.
+	void decompose(std::span<const int64_t> epochMs, const CalendarColumns& out, Isa isa);
+
+	// ---- Unix time columns ----
+	// Each column is converted in a single pass whose range check is a well-predicted branch, so the loops run at
+	// memory bandwidth. If a value is out of range, the elements before it have already been written.
+	// DateTime's default constructor reads the clock, so allocate destination columns by copy,
+	// e.g. `std::vector<DateTime> out(size, DateTime::FromUnixMillis(0));`.
+
+	/// Converts a column of Unix seconds to DateTimes, like `DateTime::FromUnixSeconds`.
+	/// @throws std::invalid_argument If `out` is shorter than `seconds`.
+	/// @throws std::out_of_range If any value is outside the DateTime range.
+	void fromUnixSeconds(std::span<const int64_t> seconds, std::span<DateTime> out);
+
+	/// Converts a column of Unix milliseconds to DateTimes, like `DateTime::FromUnixMillis`.
+	/// @throws std::invalid_argument If `out` is shorter than `milliseconds`.
+	/// @throws std::out_of_range If any value is outside the DateTime range.
+	void fromUnixMillis(std::span<const int64_t> milliseconds, std::span<DateTime> out);
+
+	/// Converts a column of Unix microseconds to DateTimes, like `DateTime::FromUnixMicros`.
+	/// @throws std::invalid_argument If `out` is shorter than `microseconds`.
+	/// @throws std::out_of_range If any value is outside the DateTime range.
+	void fromUnixMicros(std::span<const int64_t> microseconds, std::span<DateTime> out);
+
+	/// Converts a column of Unix nanoseconds to DateTimes, like `DateTime::FromUnixNanos`.
+	/// @throws std::invalid_argument If `out` is shorter than `nanoseconds`.
+	void fromUnixNanos(std::span<const int64_t> nanoseconds, std::span<DateTime> out);
+
+	/// Converts DateTimes to a column of Unix seconds, like `DateTime::toUnixSeconds`.
+	/// @throws std::invalid_argument If `out` is shorter than `dateTimes`.
+	void toUnixSeconds(std::span<const DateTime> dateTimes, std::span<int64_t> out);
+
+	/// Converts DateTimes to a column of Unix milliseconds, like `DateTime::toUnixMillis`.
+	/// @throws std::invalid_argument If `out` is shorter than `dateTimes`.
+	void toUnixMillis(std::span<const DateTime> dateTimes, std::span<int64_t> out);
+
+	/// Converts DateTimes to a column of Unix microseconds, like `DateTime::toUnixMicros`.
+	/// @throws std::invalid_argument If `out` is shorter than `dateTimes`.
+	void toUnixMicros(std::span<const DateTime> dateTimes, std::span<int64_t> out);
+
+	/// Converts DateTimes to a column of Unix nanoseconds, like `DateTime::toUnixNanos`.
+	/// @throws std::invalid_argument If `out` is shorter than `dateTimes`.
+	/// @throws std::out_of_range If any value does not fit in int64_t.
+	void toUnixNanos(std::span<const DateTime> dateTimes, std::span<int64_t> out);
+
+	// ---- Time buckets ----
+	// Bucket ids are consecutive integers, negative before the Unix epoch, suitable as group-by keys or array
+	// indexes. Every DateTime is valid input, so the loops have no per-element check: they are pure integer math,
+	// vectorized like `decompose`. `bucketStart` maps an id back to the DateTime its bucket starts at.
+
+	/// Computes the calendar bucket of each DateTime: the number of days, ISO weeks, months, quarters or years
+	/// between the one containing 1970-01-01 and the one containing the DateTime, so that
+	/// `bucketStart(id, unit) == dateTime.floor(unit)`.
+	/// @throws std::invalid_argument If `bucketIds` is shorter than `dateTimes`.
+	void bucketize(std::span<const DateTime> dateTimes, CalendarUnit unit, std::span<int64_t> bucketIds);
+
+	/// Same as `bucketize(dateTimes, unit, bucketIds)`, using the given instruction set instead of `activeIsa()`.
+	/// Falls back to a supported instruction set if the CPU does not support `isa`.
+	void bucketize(std::span<const DateTime> dateTimes, CalendarUnit unit, std::span<int64_t> bucketIds, Isa isa);
+
+	/// Computes the fixed-interval bucket of each DateTime: the number of whole intervals from `origin` to it,
+	/// rounded down, so that `bucketStart(id, interval, origin) == dateTime.floor(interval, origin)`.
+	/// @throws std::invalid_argument If `bucketIds` is shorter than `dateTimes` or `interval` is shorter than 1 ms.
+	void bucketize(std::span<const DateTime> dateTimes,
+				   const TimeSpan& interval,
+				   std::span<int64_t> bucketIds,
+				   const DateTime& origin = DateTime::FromUnixSeconds(0));
+
+	/// Returns the start of a calendar bucket computed by `bucketize`.
+	/// @throws std::out_of_range If the bucket starts outside the DateTime range.
+	DateTime bucketStart(int64_t bucketId, CalendarUnit unit);
+
+	/// Returns the start of a fixed-interval bucket computed by `bucketize`.
+	/// @throws std::invalid_argument If `interval` is shorter than 1 ms.
+	/// @throws std::out_of_range If the bucket starts outside the DateTime range.
+	DateTime bucketStart(int64_t bucketId,
+						 const TimeSpan& interval,
+						 const DateTime& origin = DateTime::FromUnixSeconds(0));
+
+} // namespace onion::batch
+
+#ifdef ONION_HEADER_ONLY
+#include "Batch.cpp"
+#endif
@@ -0,0 +1,52 @@
+#include "CoarseClock.hpp"
+
+#include <cstdint>
+#include <stdexcept>
+
+#include "Config.hpp"
+#include "detail/CoarseTick.hpp"
+
+namespace onion
+{
+	namespace
+	{
+		inline void publishTick() noexcept
+		{
+			const auto now = std::chrono::floor<std::chrono::milliseconds>(std::chrono::system_clock::now());
+			detail::CoarseTickMillis.store(now.time_since_epoch().count(), std::memory_order_relaxed);
+		}
+	} // namespace
+
+	ONION_INLINE CoarseClockTicker::CoarseClockTicker(std::chrono::milliseconds interval) : m_interval(interval)
+	{
+		if (interval <= std::chrono::milliseconds::zero())
+			detail::raise(std::invalid_argument("CoarseClockTicker interval must be positive"));
+
+		// The thread first: if it cannot start, no ticker is counted and readers keep using the system clock.
+		m_thread = std::thread(&CoarseClockTicker::run, this);
+		detail::CoarseTickers.fetch_add(1, std::memory_order_relaxed);
+		publishTick();
+	}
+
+	ONION_INLINE CoarseClockTicker::~CoarseClockTicker()
+	{
+		{
+			std::lock_guard lock(m_mutex);
+			m_stopping = true;
+		}
+		m_wakeUp.notify_one();
+		m_thread.join();
+
+		// The last ticker hands readers back to the system clock.
+		if (detail::CoarseTickers.fetch_sub(1, std::memory_order_relaxed) == 1)
+			detail::CoarseTickMillis.store(detail::NoCoarseTick, std::memory_order_relaxed);
+	}
+
+	ONION_INLINE void CoarseClockTicker::run()
+	{
+		std::unique_lock lock(m_mutex);
+		while (!m_wakeUp.wait_for(lock, m_interval, [this] { return m_stopping; }))
+			publishTick();
+	}
+
+} // namespace onion
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+namespace onion
+{
+	/// Background thread that publishes the current time for `DateTime::UtcNowCoarse()`.
+	///
+	/// While at least one ticker is alive, `UtcNowCoarse()` is a single relaxed atomic load of the last published
+	/// time, which is at most one `interval` old. Without a ticker it falls back to `CLOCK_REALTIME_COARSE`.
+	///
+	/// Example:
+	///   onion::CoarseClockTicker ticker; // ticks every millisecond until it goes out of scope
+	///   onion::DateTime now = onion::DateTime::UtcNowCoarse();
+	class CoarseClockTicker
+	{
+	  public:
+		/// Starts the ticker thread, then publishes the current time once, so that readers see it before the first
+		/// tick.
+		/// @param interval Time between two updates.
+		/// @throws std::invalid_argument If the interval is not positive.
+		explicit CoarseClockTicker(std::chrono::milliseconds interval = std::chrono::milliseconds{1});
+
+		/// Stops and joins the ticker thread. `UtcNowCoarse()` falls back to the system clock once the last ticker
+		/// is destroyed.
+		~CoarseClockTicker();
+
+		CoarseClockTicker(const CoarseClockTicker&) = delete;
+		CoarseClockTicker& operator=(const CoarseClockTicker&) = delete;
+
+		/// Returns the time between two updates.
+		std::chrono::milliseconds interval() const noexcept { return m_interval; }
+
+	  private:
+		void run();
+
+		std::chrono::milliseconds m_interval;
+		std::mutex m_mutex;
+		std::condition_variable m_wakeUp;
+		bool m_stopping = false;
+		std::thread m_thread;
+	};
+
+} // namespace onion
+
+#ifdef ONION_HEADER_ONLY
+#include "CoarseClock.cpp"
+#endif
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <cstdio>
+#include <cstdlib>
+
+// ---- Header-only mode ----
+// When ONION_HEADER_ONLY is defined (CMake option of the same name), every public header includes its source file,
+// so the library is compiled into each translation unit that uses it and nothing has to be linked. The
+// definitions in the source files are marked ONION_INLINE so that this does not break the one-definition rule.
+#ifdef ONION_HEADER_ONLY
+#define ONION_INLINE inline
+#else
+#define ONION_INLINE
+#endif
+
+// ---- Exceptions ----
+// When ONION_NO_EXCEPTIONS is defined (CMake option of the same name, or automatically when the compiler has
+// exceptions disabled, e.g. with -fno-exceptions), errors that would throw print the exception message and abort.
+// Bad input can still be handled through the non-throwing APIs: `DateTime::TryCreate`, `DateTime::TryParse` and
+// `DateTimePattern::assign`.
+#if !defined(ONION_NO_EXCEPTIONS) && !defined(__cpp_exceptions)
+#define ONION_NO_EXCEPTIONS
+#endif
+
+namespace onion::detail
+{
+	/// Throws the given exception, or reports it and aborts when exceptions are disabled.
+	template <typename Exception> [[noreturn]] constexpr void raise(const Exception& exception)
+	{
+#ifdef ONION_NO_EXCEPTIONS
+		std::fprintf(stderr, "onion: %s\n", exception.what());
+		std::abort();
+#else
+		throw exception;
+#endif
+	}
+
+} // namespace onion::detail
@@ -1,207 +1,430 @@
 #include "DateTime.hpp"
 
 #include <chrono>
-#include <format>
+#include <cmath>
+#include <cstdint>
+#include <ctime>
 #include <stdexcept>
 #include <string>
 
-using namespace std::chrono;
+#include "Config.hpp"
+#include "detail/Calendar.hpp"
+#include "detail/CoarseTick.hpp"
+#include "detail/Digits.hpp"
 
 namespace onion
 {
-
-	DateTime::DateTime() : m_timePoint(std::chrono::floor<std::chrono::milliseconds>(std::chrono::system_clock::now()))
+	namespace
 	{
-	}
+		// ---- ISO 8601 parsing ----
 
-	DateTime::DateTime(int year, int month, int day, int hours, int minutes, int seconds, double milliseconds)
-	{
-		// ---- Validate ranges ----
-		if (year < 1 || year > 9999)
-			throw std::out_of_range("year out of range");
+		/// Reads `count` decimal digits starting at `p` into `value`. Returns false if any character is not a digit.
+		inline bool readDigits(const char* p, int count, unsigned& value) noexcept
+		{
+			unsigned result = 0;
+			unsigned invalid = 0;
+			for (int i = 0; i < count; ++i)
+			{
+				const unsigned digit = static_cast<unsigned>(p[i]) - '0';
+				invalid |= static_cast<unsigned>(digit > 9);
+				result = result * 10 + digit;
+			}
+
+			value = result;
+			return invalid == 0;
+		}
 
-		if (month < 1 || month > 12)
-			throw std::out_of_range("month out of range");
+		/// Validates the calendar and clock components and converts them to seconds since the Unix epoch.
+		inline bool composeUnixSeconds(unsigned year,
+									   unsigned month,
+									   unsigned day,
+									   unsigned hours,
+									   unsigned minutes,
+									   unsigned seconds,
+									   int64_t& unixSeconds) noexcept
+		{
+			if (year < 1 || month < 1 || month > 12 || day < 1 || day > detail::daysInMonth(int(year), month))
+				return false;
 
-		if (day < 1 || day > 31)
-			throw std::out_of_range("day out of range");
+			if (hours > 23 || minutes > 59 || seconds > 59)
+				return false;
 
-		if (hours < 0 || hours > 23)
-			throw std::out_of_range("hour out of range");
+			unixSeconds =
+				detail::daysFromCivil(int(year), month, day) * 86'400 + hours * 3'600 + minutes * 60 + seconds;
+			return true;
+		}
 
-		if (minutes < 0 || minutes > 59)
-			throw std::out_of_range("minute out of range");
+		/// Fast path for the exact `toString()` layout: "YYYY-MM-DDTHH:MM:SS.fffZ", with 3, 6 or 9 fractional digits.
+		inline bool parseIsoFixed(std::string_view text,
+								  int fractionDigits,
+								  int64_t& unixSeconds,
+								  unsigned& fraction) noexcept
+		{
+			const char* p = text.data();
+			if (p[4] != '-' || p[7] != '-' || p[10] != 'T' || p[13] != ':' || p[16] != ':' || p[19] != '.' ||
+				p[20 + fractionDigits] != 'Z')
+				return false;
 
-		if (seconds < 0 || seconds > 59)
-			throw std::out_of_range("second out of range");
+			unsigned year, month, day, hours, minutes, seconds;
+			const bool digits = readDigits(p, 4, year) & readDigits(p + 5, 2, month) & readDigits(p + 8, 2, day) &
+				readDigits(p + 11, 2, hours) & readDigits(p + 14, 2, minutes) & readDigits(p + 17, 2, seconds) &
+				readDigits(p + 20, fractionDigits, fraction);
 
-		if (milliseconds < 0.0 || milliseconds >= 1000.0)
-			throw std::out_of_range("millisecond out of range");
+			return digits && composeUnixSeconds(year, month, day, hours, minutes, seconds, unixSeconds);
+		}
 
-		// ---- Construct calendar date ----
-		year_month_day ymd{std::chrono::year{year},
-						   std::chrono::month{static_cast<unsigned>(month)},
-						   std::chrono::day{static_cast<unsigned>(day)}};
+		/// General path for the other supported ISO 8601 variants. The fraction is returned in nanoseconds.
+		inline bool parseIsoGeneral(std::string_view text, int64_t& unixSeconds, unsigned& nanoseconds) noexcept
+		{
+			const char* p = text.data();
+			const char* const end = p + text.size();
+
+			auto remaining = [&]() { return end - p; };
+
+			// ---- Date: YYYY-MM-DD ----
+			unsigned year, month, day;
+			if (remaining() < 10 || p[4] != '-' || p[7] != '-' || !readDigits(p, 4, year) ||
+				!readDigits(p + 5, 2, month) || !readDigits(p + 8, 2, day))
+				return false;
+			p += 10;
+
+			unsigned hours = 0, minutes = 0, seconds = 0;
+			int offsetMinutes = 0;
+			nanoseconds = 0;
+
+			if (p != end)
+			{
+				// ---- Separator ----
+				if (*p != 'T' && *p != 't' && *p != ' ')
+					return false;
+				++p;
+
+				// ---- Time: HH:MM[:SS[.fffffffff]] ----
+				if (remaining() < 5 || p[2] != ':' || !readDigits(p, 2, hours) || !readDigits(p + 3, 2, minutes))
+					return false;
+				p += 5;
+
+				if (remaining() >= 3 && *p == ':')
+				{
+					if (!readDigits(p + 1, 2, seconds))
+						return false;
+					p += 3;
+
+					if (p != end && (*p == '.' || *p == ','))
+					{
+						++p;
+						int fractionDigits = 0;
+						while (p != end && static_cast<unsigned>(*p) - '0' <= 9)
+						{
+							if (fractionDigits < 9)
+								nanoseconds = nanoseconds * 10 + static_cast<unsigned>(*p - '0');
+							++fractionDigits;
+							++p;
+						}
+
+						if (fractionDigits == 0 || fractionDigits > 9)
+							return false;
+
+						for (int i = fractionDigits; i < 9; ++i)
+							nanoseconds *= 10;
+					}
+				}
+
+				// ---- Zone designator: Z | +HH | +HHMM | +HH:MM ----
+				if (p != end)
+				{
+					if (*p == 'Z' || *p == 'z')
+					{
+						++p;
+					}
+					else if (*p == '+' || *p == '-')
+					{
+						const int sign = *p == '-' ? -1 : 1;
+						++p;
+
+						unsigned offsetHours = 0, offsetMins = 0;
+						if (remaining() < 2 || !readDigits(p, 2, offsetHours))
+							return false;
+						p += 2;
+
+						if (remaining() >= 3 && *p == ':')
+						{
+							if (!readDigits(p + 1, 2, offsetMins))
+								return false;
+							p += 3;
+						}
+						else if (remaining() >= 2)
+						{
+							if (!readDigits(p, 2, offsetMins))
+								return false;
+							p += 2;
+						}
+
+						if (offsetHours > 23 || offsetMins > 59)
+							return false;
+
+						offsetMinutes = sign * int(offsetHours * 60 + offsetMins);
+					}
+
+					if (p != end)
+						return false;
+				}
+			}
+
+			if (!composeUnixSeconds(year, month, day, hours, minutes, seconds, unixSeconds))
+				return false;
+
+			unixSeconds -= offsetMinutes * 60;
+			return true;
+		}
 
-		if (!ymd.ok())
-			throw std::invalid_argument("invalid calendar date");
+		/// Combines Unix seconds and a fraction of `TicksPerSecond` into ticks, and checks the supported range.
+		template <int64_t TicksPerSecond>
+		inline bool toTicks(int64_t unixSeconds, int64_t fraction, int64_t& ticks) noexcept
+		{
+			return detail::composeTicks<TicksPerSecond>(unixSeconds, fraction, ticks) &&
+				ticks >= detail::MinTicks<TicksPerSecond> && ticks <= detail::MaxTicks<TicksPerSecond>;
+		}
 
-		// ---- Convert to sys_days (UTC midnight) ----
-		sys_days dayPoint{ymd};
+		// ---- Decomposition ----
 
-		// ---- Convert milliseconds safely ----
-		auto ms = std::chrono::milliseconds{static_cast<long long>(milliseconds)};
+		/// Days since 1970-01-01 of the given tick count.
+		template <int64_t TicksPerSecond> inline int64_t unixDays(int64_t ticks) noexcept
+		{
+			return detail::floorDiv(ticks, TicksPerSecond * 86'400);
+		}
 
-		// ---- Build final sys_time<milliseconds> ----
-		m_timePoint = sys_time<std::chrono::milliseconds>{dayPoint} + std::chrono::hours{hours} +
-			std::chrono::minutes{minutes} + std::chrono::seconds{seconds} + ms;
-	}
+		/// Ticks since midnight of the given tick count.
+		template <int64_t TicksPerSecond> inline int64_t ticksOfDay(int64_t ticks) noexcept
+		{
+			return ticks - detail::floorDiv(ticks, TicksPerSecond * 86'400) * (TicksPerSecond * 86'400);
+		}
 
-	DateTime DateTime::UtcNow()
+		/// Nanoseconds within the second of the given tick count.
+		template <int64_t TicksPerSecond> inline int64_t nanosOfSecond(int64_t ticks) noexcept
+		{
+			return (ticks - detail::floorDiv(ticks, TicksPerSecond) * TicksPerSecond) *
+				(1'000'000'000 / TicksPerSecond);
+		}
+	} // namespace
+
+	template <DateTimePrecision Duration>
+	ONION_INLINE BasicDateTime<Duration>::BasicDateTime()
+		: m_timePoint(std::chrono::floor<Duration>(std::chrono::system_clock::now()))
 	{
-		return DateTime();
 	}
 
-	DateTime DateTime::FromUnixTimestamp(double unixTimestamp)
+	template <DateTimePrecision Duration> ONION_INLINE BasicDateTime<Duration> BasicDateTime<Duration>::UtcNow()
 	{
-		auto durationSinceEpoch = std::chrono::duration<double>(unixTimestamp);
-		auto timePoint = std::chrono::sys_time<std::chrono::milliseconds>{
-			duration_cast<std::chrono::milliseconds>(durationSinceEpoch)};
-
-		DateTime dt;
-		dt.m_timePoint = timePoint;
-
-		return dt;
+		return BasicDateTime();
 	}
 
-	// ---- Date components ----
+	template <DateTimePrecision Duration>
+	ONION_INLINE BasicDateTime<Duration> BasicDateTime<Duration>::UtcNowCoarse() noexcept
+	{
+		const int64_t tick = detail::CoarseTickMillis.load(std::memory_order_relaxed);
+		if (tick != detail::NoCoarseTick)
+			return fromTicks(detail::convertUnixTime<detail::MillisPerSecond, TicksPerSecond>(tick));
+
+#if defined(CLOCK_REALTIME_COARSE)
+		timespec now;
+		clock_gettime(CLOCK_REALTIME_COARSE, &now);
+		return fromTicks(int64_t{now.tv_sec} * TicksPerSecond + now.tv_nsec / (1'000'000'000 / TicksPerSecond));
+#else
+		return UtcNow();
+#endif
+	}
 
-	int DateTime::getYear() const
+	template <DateTimePrecision Duration>
+	ONION_INLINE BasicDateTime<Duration> BasicDateTime<Duration>::FromUnixTimestamp(double unixTimestamp)
 	{
-		auto days = floor<std::chrono::days>(m_timePoint);
-		year_month_day ymd{days};
-		return int(ymd.year());
+		// Rounding (rather than truncating) recovers the intended millisecond for values such as 1718454645.123,
+		// whose closest double is slightly below it.
+		// The upper bound is exclusive so that it stays exact when MaxTicks is the int64 maximum (2^63 - 1).
+		const double unixTicks = std::nearbyint(unixTimestamp * static_cast<double>(TicksPerSecond));
+		if (!(unixTicks >= static_cast<double>(detail::MinTicks<TicksPerSecond>) &&
+			  unixTicks < static_cast<double>(detail::MaxTicks<TicksPerSecond>) + 1.0))
+			detail::raise(std::out_of_range("Unix timestamp out of DateTime range"));
+
+		return fromTicks(static_cast<int64_t>(unixTicks));
 	}
 
-	int DateTime::getMonth() const
+	template <DateTimePrecision Duration>
+	ONION_INLINE BasicDateTime<Duration> BasicDateTime<Duration>::Parse(std::string_view text)
 	{
-		auto days = floor<std::chrono::days>(m_timePoint);
-		year_month_day ymd{days};
-		return unsigned(ymd.month());
+		auto result = TryParse(text);
+		if (!result)
+			detail::raise(std::invalid_argument("Invalid ISO 8601 DateTime string: " + std::string(text)));
+
+		return *result;
 	}
 
-	int DateTime::getDay() const
+	template <DateTimePrecision Duration>
+	ONION_INLINE std::optional<BasicDateTime<Duration>> BasicDateTime<Duration>::TryParse(
+		std::string_view text) noexcept
 	{
-		auto days = floor<std::chrono::days>(m_timePoint);
-		year_month_day ymd{days};
-		return unsigned(ymd.day());
+		int64_t unixSeconds = 0;
+		unsigned fraction = 0;
+		int64_t ticks = 0;
+
+		constexpr int Digits = static_cast<int>(FractionDigits);
+		if (text.size() == IsoStringLength && parseIsoFixed(text, Digits, unixSeconds, fraction))
+		{
+			if (!toTicks<TicksPerSecond>(unixSeconds, fraction, ticks))
+				return std::nullopt;
+		}
+		else
+		{
+			if (!parseIsoGeneral(text, unixSeconds, fraction) ||
+				!toTicks<TicksPerSecond>(unixSeconds, fraction / (1'000'000'000 / TicksPerSecond), ticks))
+				return std::nullopt;
+		}
+
+		return fromTicks(ticks);
 	}
 
-	// ---- Time components ----
+	// ---- Date components ----
 
-	int DateTime::getHours() const
+	template <DateTimePrecision Duration> ONION_INLINE int BasicDateTime<Duration>::getYear() const
 	{
-		auto dayPoint = floor<days>(m_timePoint);
-		hh_mm_ss<milliseconds> tod{m_timePoint - dayPoint};
-		return int(tod.hours().count());
+		return detail::civilFromDays(unixDays<TicksPerSecond>(ticks())).year;
 	}
 
-	int DateTime::getMinutes() const
+	template <DateTimePrecision Duration> ONION_INLINE int BasicDateTime<Duration>::getMonth() const
 	{
-		auto dayPoint = floor<days>(m_timePoint);
-		hh_mm_ss<milliseconds> tod{m_timePoint - dayPoint};
-		return int(tod.minutes().count());
+		return static_cast<int>(detail::civilFromDays(unixDays<TicksPerSecond>(ticks())).month);
 	}
 
-	int DateTime::getSeconds() const
+	template <DateTimePrecision Duration> ONION_INLINE int BasicDateTime<Duration>::getDay() const
 	{
-		auto dayPoint = floor<days>(m_timePoint);
-		hh_mm_ss<milliseconds> tod{m_timePoint - dayPoint};
-		return int(tod.seconds().count());
+		return static_cast<int>(detail::civilFromDays(unixDays<TicksPerSecond>(ticks())).day);
 	}
 
-	double DateTime::getMilliseconds() const
+	// ---- Time components ----
+
+	template <DateTimePrecision Duration> ONION_INLINE int BasicDateTime<Duration>::getHours() const
 	{
-		auto dayPoint = floor<days>(m_timePoint);
-		hh_mm_ss<milliseconds> tod{m_timePoint - dayPoint};
-		return static_cast<double>(tod.subseconds().count());
+		return static_cast<int>(ticksOfDay<TicksPerSecond>(ticks()) / (TicksPerSecond * 3'600));
 	}
 
-	// ---- Comparison operators ----
-	bool DateTime::operator==(const DateTime& other) const
+	template <DateTimePrecision Duration> ONION_INLINE int BasicDateTime<Duration>::getMinutes() const
 	{
-		return m_timePoint == other.m_timePoint;
+		return static_cast<int>(ticksOfDay<TicksPerSecond>(ticks()) / (TicksPerSecond * 60) % 60);
 	}
 
-	bool DateTime::operator!=(const DateTime& other) const
+	template <DateTimePrecision Duration> ONION_INLINE int BasicDateTime<Duration>::getSeconds() const
 	{
-		return m_timePoint != other.m_timePoint;
+		return static_cast<int>(ticksOfDay<TicksPerSecond>(ticks()) / TicksPerSecond % 60);
 	}
 
-	bool DateTime::operator<(const DateTime& other) const
+	template <DateTimePrecision Duration> ONION_INLINE double BasicDateTime<Duration>::getMilliseconds() const
 	{
-		return m_timePoint < other.m_timePoint;
+		return static_cast<double>(nanosOfSecond<TicksPerSecond>(ticks()) / 1'000'000);
 	}
 
-	bool DateTime::operator<=(const DateTime& other) const
+	template <DateTimePrecision Duration> ONION_INLINE int BasicDateTime<Duration>::getMicroseconds() const
 	{
-		return m_timePoint <= other.m_timePoint;
+		return static_cast<int>(nanosOfSecond<TicksPerSecond>(ticks()) / 1'000 % 1'000);
 	}
 
-	bool DateTime::operator>(const DateTime& other) const
+	template <DateTimePrecision Duration> ONION_INLINE int BasicDateTime<Duration>::getNanoseconds() const
 	{
-		return m_timePoint > other.m_timePoint;
+		return static_cast<int>(nanosOfSecond<TicksPerSecond>(ticks()) % 1'000);
 	}
 
-	bool DateTime::operator>=(const DateTime& other) const
+	template <DateTimePrecision Duration>
+	ONION_INLINE typename BasicDateTime<Duration>::Components BasicDateTime<Duration>::decompose() const noexcept
 	{
-		return m_timePoint >= other.m_timePoint;
+		const int64_t days = unixDays<TicksPerSecond>(ticks());
+		const int64_t secondOfDay = ticksOfDay<TicksPerSecond>(ticks()) / TicksPerSecond;
+		const int64_t nanoseconds = nanosOfSecond<TicksPerSecond>(ticks());
+		const detail::CivilDate date = detail::civilFromDays(days);
+
+		Components components;
+		components.year = date.year;
+		components.month = static_cast<int>(date.month);
+		components.day = static_cast<int>(date.day);
+		components.hours = static_cast<int>(secondOfDay / 3'600);
+		components.minutes = static_cast<int>(secondOfDay / 60 % 60);
+		components.seconds = static_cast<int>(secondOfDay % 60);
+		components.milliseconds = static_cast<int>(nanoseconds / 1'000'000);
+		components.dayOfWeek = static_cast<int>(detail::weekdayFromDays(days));
+		components.dayOfYear = static_cast<int>(date.dayOfYear);
+		components.microseconds = static_cast<int>(nanoseconds / 1'000 % 1'000);
+		components.nanoseconds = static_cast<int>(nanoseconds % 1'000);
+		return components;
 	}
 
-	TimeSpan DateTime::operator-(const DateTime& other) const
+	// ---- String representation ----
+	template <DateTimePrecision Duration> ONION_INLINE std::string BasicDateTime<Duration>::toString() const
 	{
-		using namespace std::chrono;
-		auto diff = m_timePoint - other.m_timePoint; // duration<milliseconds>
-		return TimeSpan(duration_cast<nanoseconds>(diff));
+		std::string result(IsoStringLength, '\0');
+		toChars(result.data(), result.data() + result.size());
+		return result;
 	}
 
-	DateTime DateTime::operator+(const TimeSpan& ts) const
+	template <DateTimePrecision Duration>
+	ONION_INLINE std::to_chars_result BasicDateTime<Duration>::toChars(char* first, char* last) const noexcept
 	{
-		return DateTime(m_timePoint + std::chrono::duration_cast<std::chrono::milliseconds>(ts.GetDuration()));
+		if (last - first < static_cast<std::ptrdiff_t>(IsoStringLength))
+			return {last, std::errc::value_too_large};
+
+		const int64_t tickOfDay = ticksOfDay<TicksPerSecond>(ticks());
+		const detail::CivilDate date = detail::civilFromDays(unixDays<TicksPerSecond>(ticks()));
+
+		const auto secondOfDay = static_cast<unsigned>(tickOfDay / TicksPerSecond);
+		const auto fraction = static_cast<unsigned>(tickOfDay % TicksPerSecond);
+
+		// ---- YYYY-MM-DDTHH:MM:SS.fffZ ----
+		detail::writeDigits4(first, static_cast<unsigned>(date.year));
+		first[4] = '-';
+		detail::writeDigits2(first + 5, date.month);
+		first[7] = '-';
+		detail::writeDigits2(first + 8, date.day);
+		first[10] = 'T';
+		detail::writeDigits2(first + 11, secondOfDay / 3'600);
+		first[13] = ':';
+		detail::writeDigits2(first + 14, secondOfDay / 60 % 60);
+		first[16] = ':';
+		detail::writeDigits2(first + 17, secondOfDay % 60);
+		first[19] = '.';
+		detail::writeDigitGroups(first + 20, fraction, FractionDigits);
+		first[20 + FractionDigits] = 'Z';
+
+		return {first + IsoStringLength, std::errc{}};
 	}
 
-	DateTime DateTime::operator-(const TimeSpan& ts) const
+	template <DateTimePrecision Duration> ONION_INLINE void BasicDateTime<Duration>::appendTo(std::string& out) const
 	{
-		return DateTime(m_timePoint - std::chrono::duration_cast<std::chrono::milliseconds>(ts.GetDuration()));
+		const std::size_t size = out.size();
+		out.resize(size + IsoStringLength);
+		toChars(out.data() + size, out.data() + out.size());
 	}
 
-	// ---- String representation ----
-	std::string DateTime::toString() const
+	template <DateTimePrecision Duration>
+	ONION_INLINE std::string BasicDateTime<Duration>::toString(const std::string& format) const
 	{
-		auto secondsPart = floor<seconds>(m_timePoint);
-		auto msPart = duration_cast<milliseconds>(m_timePoint - secondsPart).count();
-
-		return std::format("{:%Y-%m-%dT%H:%M:%S}.{:03}Z", secondsPart, msPart);
+		return Pattern(format).format(*this);
 	}
 
-	std::string DateTime::toString(const std::string& format) const
+	template <DateTimePrecision Duration>
+	ONION_INLINE std::string BasicDateTime<Duration>::toString(const Pattern& pattern) const
 	{
-		try
-		{
-			return std::vformat("{:" + format + "}", std::make_format_args(m_timePoint));
-		}
-		catch (const std::format_error&)
-		{
-			throw std::invalid_argument("Invalid DateTime format string: " + format);
-		}
+		return pattern.format(*this);
 	}
 
 	// ---- Converts the DateTime to a Unix timestamp (number of seconds since January 1, 1970, UTC) ----
-	long long DateTime::toUnixTimestamp() const
+	template <DateTimePrecision Duration> ONION_INLINE long long BasicDateTime<Duration>::toUnixTimestamp() const
 	{
-		auto epoch = sys_time<seconds>{};
+		auto epoch = std::chrono::sys_time<std::chrono::seconds>{};
 		auto durationSinceEpoch = m_timePoint - epoch;
-		return duration_cast<seconds>(durationSinceEpoch).count();
+		return std::chrono::duration_cast<std::chrono::seconds>(durationSinceEpoch).count();
 	}
 
+#ifndef ONION_HEADER_ONLY
+	template class BasicDateTime<std::chrono::milliseconds>;
+	template class BasicDateTime<std::chrono::microseconds>;
+	template class BasicDateTime<std::chrono::nanoseconds>;
+#endif
+
 } // namespace onion
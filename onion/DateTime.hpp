@@ -1,23 +1,117 @@
 #pragma once
 
+#include <charconv>
 #include <chrono>
+#include <compare>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <stdexcept>
 #include <string>
+#include <string_view>
 
+#include "Config.hpp"
+#include "DateTimeFwd.hpp"
+#include "DateTimePattern.hpp"
+#include "Expected.hpp"
 #include "TimeSpan.hpp"
+#include "detail/Calendar.hpp"
+#include "detail/Hash.hpp"
 
 namespace onion
 {
 
-	/// Represents a date and time in Coordinated Universal Time (UTC) with millisecond precision.
+	/// Reasons for which `DateTime::TryCreate` rejects its components.
+	enum class DateTimeError
+	{
+		YearOutOfRange,		   ///< Year outside [1, 9999], or the date outside the range of the precision.
+		MonthOutOfRange,	   ///< Month outside [1, 12].
+		DayOutOfRange,		   ///< Day outside [1, 31].
+		HourOutOfRange,		   ///< Hour outside [0, 23].
+		MinuteOutOfRange,	   ///< Minute outside [0, 59].
+		SecondOutOfRange,	   ///< Second outside [0, 59].
+		MillisecondOutOfRange, ///< Millisecond outside [0, 1000), or not a number.
+		InvalidDate,		   ///< The day does not exist in that month and year (e.g. February 30th).
+	};
+
+	/// Returns a short description of the error, e.g. "year out of range".
+	constexpr std::string_view toString(DateTimeError error) noexcept
+	{
+		switch (error)
+		{
+			case DateTimeError::YearOutOfRange:
+				return "year out of range";
+			case DateTimeError::MonthOutOfRange:
+				return "month out of range";
+			case DateTimeError::DayOutOfRange:
+				return "day out of range";
+			case DateTimeError::HourOutOfRange:
+				return "hour out of range";
+			case DateTimeError::MinuteOutOfRange:
+				return "minute out of range";
+			case DateTimeError::SecondOutOfRange:
+				return "second out of range";
+			case DateTimeError::MillisecondOutOfRange:
+				return "millisecond out of range";
+			case DateTimeError::InvalidDate:
+				return "invalid calendar date";
+		}
+		return "unknown error";
+	}
+
+	/// Calendar periods that DateTimes can be rounded to, see `DateTime::floor` and `batch::bucketize`.
+	enum class CalendarUnit
+	{
+		Day,
+		Week,	 ///< ISO 8601 week, starting on Monday.
+		Month,
+		Quarter, ///< January to March, April to June, July to September, or October to December.
+		Year,
+	};
+
+	/// Represents a date and time in Coordinated Universal Time (UTC) as a number of `Duration` ticks since the Unix
+	/// epoch. `DateTime` (milliseconds), `DateTimeMicros` and `DateTimeNanos` are the available precisions.
 	///
 	/// Instances are always valid and represent a precise point in time.
-	/// The supported year range is [1, 9999].
-	class DateTime
+	/// The supported year range is [1, 9999], clamped to the int64 tick range for nanoseconds
+	/// ([1677-09-21T00:12:43.145224192Z, 2262-04-11T23:47:16.854775807Z]).
+	/// Arithmetic and conversions between Unix units are exact int64 math on the tick count.
+	template <DateTimePrecision Duration> class BasicDateTime
 	{
 
+	  public:
+		/// A chrono-style format pattern parsed once and reusable across calls. See `DateTimePattern`.
+		using Pattern = DateTimePattern;
+
+		/// The precision of the DateTime.
+		using Precision = Duration;
+
+		/// Number of ticks in a second.
+		static constexpr int64_t TicksPerSecond = Duration::period::den;
+
+		/// Number of fractional second digits written by `toString()` and `%S` (3, 6 or 9).
+		static constexpr std::size_t FractionDigits = TicksPerSecond == 1'000 ? 3 : TicksPerSecond == 1'000'000 ? 6 : 9;
+
+		/// All date and time components of a DateTime, as returned by `decompose()`.
+		struct Components
+		{
+			int year;		  ///< Year in range [1, 9999].
+			int month;		  ///< Month in range [1, 12].
+			int day;		  ///< Day in range [1, 31].
+			int hours;		  ///< Hour in range [0, 23].
+			int minutes;	  ///< Minute in range [0, 59].
+			int seconds;	  ///< Second in range [0, 59].
+			int milliseconds; ///< Millisecond in range [0, 999].
+			int dayOfWeek;	  ///< Day of week in range [0, 6], 0 being Sunday.
+			int dayOfYear;	  ///< Day of year in range [1, 366].
+			int microseconds; ///< Microsecond of the millisecond in range [0, 999]. Always 0 for `DateTime`.
+			int nanoseconds;  ///< Nanosecond of the microsecond in range [0, 999]. Always 0 above nanosecond precision.
+		};
+
 	  public:
 		/// Creates a DateTime object representing the current UTC date and time.
-		DateTime();
+		BasicDateTime();
 
 		/// Constructs a DateTime object with the specified UTC date and time components.
 		/// @param year Year component in range [1, 9999].
@@ -26,16 +120,83 @@ namespace onion
 		/// @param hours Hour component in range [0, 23].
 		/// @param minutes Minute component in range [0, 59].
 		/// @param seconds Second component in range [0, 59].
-		/// @param milliseconds Millisecond component in range [0, 999].
+		/// @param milliseconds Millisecond component in range [0, 1000). Truncated to whole milliseconds for
+		///        `DateTime`, and rounded to the nearest tick for finer precisions.
 		/// @throws std::out_of_range If any component is outside its valid range.
 		/// @throws std::invalid_argument If the calendar date is invalid.
-		DateTime(int year, int month, int day, int hours, int minutes, int seconds, double milliseconds = 0);
+		constexpr BasicDateTime(
+			int year, int month, int day, int hours, int minutes, int seconds, double milliseconds = 0);
+
+		/// Converts from another precision. Converting to a coarser precision rounds towards negative infinity.
+		/// @throws std::out_of_range If the value is outside the range of this precision (only possible when
+		///         converting to `DateTimeNanos`).
+		template <DateTimePrecision OtherDuration>
+		constexpr explicit BasicDateTime(const BasicDateTime<OtherDuration>& other);
+
+		/// Creates a DateTime from UTC date and time components without throwing.
+		///
+		/// Accepts the same components as the constructor, and reports invalid ones through the result instead of
+		/// an exception, which is much cheaper when bad input is expected.
+		/// @return The DateTime, or the first invalid component as a `DateTimeError`.
+		static constexpr Expected<BasicDateTime, DateTimeError> TryCreate(
+			int year, int month, int day, int hours, int minutes, int seconds, double milliseconds = 0) noexcept;
 
 		/// Returns the current UTC date and time.
 		/// @return A DateTime representing the current UTC time.
-		static DateTime UtcNow();
+		static BasicDateTime UtcNow();
+
+		/// Returns the current UTC date and time from a cheap, coarse clock.
+		///
+		/// Intended for hot paths (logging, request tagging) where a few milliseconds of staleness are acceptable.
+		/// While a `CoarseClockTicker` is running this is a single relaxed atomic load of the time it last published;
+		/// otherwise it reads `CLOCK_REALTIME_COARSE` where available (typically 1-4 ms resolution) and
+		/// falls back to `UtcNow()` elsewhere.
+		/// @return A DateTime that is at most one clock tick behind the current UTC time.
+		static BasicDateTime UtcNowCoarse() noexcept;
+
+		/// Creates a DateTime from a Unix timestamp in fractional seconds, rounded to the nearest tick.
+		/// Prefer the exact integer factories (`FromUnixSeconds`, `FromUnixMillis`, ...) when the source is integral.
+		/// @param unixTimestamp Seconds since 1970-01-01T00:00:00Z.
+		/// @throws std::out_of_range If the timestamp is not finite or is outside the year range [1, 9999].
+		static BasicDateTime FromUnixTimestamp(double unixTimestamp);
 
-		static DateTime FromUnixTimestamp(double unixTimestamp);
+		/// Creates a DateTime from whole seconds since 1970-01-01T00:00:00Z.
+		/// @throws std::out_of_range If the result would be outside the supported range.
+		static constexpr BasicDateTime FromUnixSeconds(int64_t seconds);
+
+		/// Creates a DateTime from milliseconds since 1970-01-01T00:00:00Z. The conversion is exact.
+		/// @throws std::out_of_range If the result would be outside the supported range.
+		static constexpr BasicDateTime FromUnixMillis(int64_t milliseconds);
+
+		/// Creates a DateTime from microseconds since 1970-01-01T00:00:00Z, rounded down to the tick.
+		/// @throws std::out_of_range If the result would be outside the supported range.
+		static constexpr BasicDateTime FromUnixMicros(int64_t microseconds);
+
+		/// Creates a DateTime from nanoseconds since 1970-01-01T00:00:00Z, rounded down to the tick.
+		/// Every int64_t value is in range.
+		static constexpr BasicDateTime FromUnixNanos(int64_t nanoseconds) noexcept;
+
+		/// Parses an ISO 8601 UTC date and time string without allocating.
+		///
+		/// The exact `toString()` layout of the precision ("2024-06-15T12:30:45.500Z" for `DateTime`) is handled by a
+		/// fixed-layout fast path.
+		/// Other ISO 8601 extended variants are accepted as well:
+		///   - a date alone ("2024-06-15"), or a date and time separated by 'T', 't' or a space;
+		///   - a time as HH:MM, HH:MM:SS or HH:MM:SS followed by '.' or ',' and 1 to 9 fractional digits
+		///     (truncated to the precision);
+		///   - an optional 'Z'/'z' designator or UTC offset (+HH, +HHMM, +HH:MM, or the same with '-').
+		///
+		/// A time without designator is taken as UTC. Offsets are applied, so the result is the matching UTC instant.
+		/// @param text The string to parse.
+		/// @return The parsed DateTime.
+		/// @throws std::invalid_argument If the text is not a valid ISO 8601 date and time in the supported range.
+		static BasicDateTime Parse(std::string_view text);
+
+		/// Parses an ISO 8601 UTC date and time string without throwing.
+		/// Accepts the same inputs as `Parse`.
+		/// @param text The string to parse.
+		/// @return The parsed DateTime, or `std::nullopt` if the text is not valid.
+		static std::optional<BasicDateTime> TryParse(std::string_view text) noexcept;
 
 	  public:
 		/// Returns the year component of the UTC date.
@@ -66,23 +227,91 @@ namespace onion
 		/// @return Millisecond in range [0, 999].
 		double getMilliseconds() const;
 
+		/// Returns the microsecond component of the UTC time, within the millisecond.
+		/// @return Microsecond in range [0, 999]. Always 0 for `DateTime`.
+		int getMicroseconds() const;
+
+		/// Returns the nanosecond component of the UTC time, within the microsecond.
+		/// @return Nanosecond in range [0, 999]. Always 0 above nanosecond precision.
+		int getNanoseconds() const;
+
+		/// Returns every date and time component at once.
+		///
+		/// The components are computed in a single integer-only pass, which is cheaper than calling each getter
+		/// when several components are needed.
+		/// @return The date and time components, including day of week and day of year.
+		Components decompose() const noexcept;
+
 	  public:
-		bool operator==(const DateTime& other) const;
-		bool operator!=(const DateTime& other) const;
-		bool operator<(const DateTime& other) const;
-		bool operator<=(const DateTime& other) const;
-		bool operator>(const DateTime& other) const;
-		bool operator>=(const DateTime& other) const;
+		constexpr bool operator==(const BasicDateTime& other) const = default;
+		constexpr auto operator<=>(const BasicDateTime& other) const = default;
+
+		constexpr TimeSpan operator-(const BasicDateTime& other) const;
 
-		TimeSpan operator-(const DateTime& other) const;
-		DateTime operator+(const TimeSpan& ts) const;
-		DateTime operator-(const TimeSpan& ts) const;
+		/// Adds a TimeSpan, truncated towards zero to the precision (exact for `DateTimeNanos`).
+		/// @throws std::out_of_range If the result is outside the supported range.
+		constexpr BasicDateTime operator+(const TimeSpan& ts) const;
+		/// Subtracts a TimeSpan, truncated towards zero to the precision (exact for `DateTimeNanos`).
+		/// @throws std::out_of_range If the result is outside the supported range.
+		constexpr BasicDateTime operator-(const TimeSpan& ts) const;
 
 	  public:
-		/// @brief Returns a string representation of the DateTime in ISO 8601 format (e.g., "2024-06-15T12:30:45.500Z").
+		// ---- Rounding ----
+		// Fixed intervals are counted from an origin, the Unix epoch by default: 15 minute intervals start at :00,
+		// :15, :30 and :45, and 7 day intervals on Thursdays unless the origin is a Monday. Calendar units follow the
+		// calendar instead, e.g. months of 28 to 31 days. `round` rounds halfway values up.
+
+		/// Rounds down to the start of the interval since `origin` that contains the DateTime.
+		/// @param interval Length of the intervals, truncated to the precision.
+		/// @throws std::invalid_argument If `interval` is shorter than one tick.
+		/// @throws std::out_of_range If the result is outside the supported range.
+		constexpr BasicDateTime floor(const TimeSpan& interval, const BasicDateTime& origin = FromUnixSeconds(0)) const;
+
+		/// Rounds up to the start of an interval since `origin`.
+		/// @throws std::invalid_argument If `interval` is shorter than one tick.
+		/// @throws std::out_of_range If the result is outside the supported range.
+		constexpr BasicDateTime ceil(const TimeSpan& interval, const BasicDateTime& origin = FromUnixSeconds(0)) const;
+
+		/// Rounds to the nearest start of an interval since `origin`.
+		/// @throws std::invalid_argument If `interval` is shorter than one tick.
+		/// @throws std::out_of_range If the result is outside the supported range.
+		constexpr BasicDateTime round(const TimeSpan& interval, const BasicDateTime& origin = FromUnixSeconds(0)) const;
+
+		/// Rounds down to the start of the day, ISO week, month, quarter or year, e.g. 2024-05-17T10:00:00Z is
+		/// rounded down to 2024-04-01T00:00:00Z for `CalendarUnit::Quarter`.
+		/// @throws std::out_of_range If the result is outside the supported range (only possible for `DateTimeNanos`).
+		constexpr BasicDateTime floor(CalendarUnit unit) const;
+
+		/// Rounds up to the start of the next day, ISO week, month, quarter or year, unless already at one.
+		/// @throws std::out_of_range If the result is outside the supported range, e.g. after 9999-12-31.
+		constexpr BasicDateTime ceil(CalendarUnit unit) const;
+
+		/// Rounds to the nearest start of a day, ISO week, month, quarter or year.
+		/// @throws std::out_of_range If the result is outside the supported range.
+		constexpr BasicDateTime round(CalendarUnit unit) const;
+
+	  public:
+		/// Length of the ISO 8601 representation written by `toString()`, `toChars()` and `appendTo()`:
+		/// 24 for `DateTime`, 27 for `DateTimeMicros` and 30 for `DateTimeNanos`.
+		static constexpr std::size_t IsoStringLength = 21 + FractionDigits;
+
+		/// Returns a string representation of the DateTime in ISO 8601 format (e.g., "2024-06-15T12:30:45.500Z"),
+		/// with as many fractional digits as the precision has.
 		/// @return A string representing the DateTime in ISO 8601 format.
 		std::string toString() const;
 
+		/// Writes the ISO 8601 representation (e.g., "2024-06-15T12:30:45.500Z") into [first, last),
+		/// in the manner of `std::to_chars`. Does not allocate and does not use the locale.
+		/// @param first Beginning of the destination buffer.
+		/// @param last End of the destination buffer. At least `IsoStringLength` characters are required.
+		/// @return `{first + IsoStringLength, std::errc{}}` on success, or `{last, std::errc::value_too_large}`
+		///         if the buffer is too small (nothing is written in that case).
+		std::to_chars_result toChars(char* first, char* last) const noexcept;
+
+		/// Appends the ISO 8601 representation (e.g., "2024-06-15T12:30:45.500Z") to the given string.
+		/// @param out The string to append to.
+		void appendTo(std::string& out) const;
+
 		/// Returns a string representation of the DateTime formatted according to the provided chrono format string.
 		///
 		/// The format string follows the C++20 `std::chrono` formatting rules
@@ -122,31 +351,403 @@ namespace onion
 		///   dt.toString("%F %T");
 		///   dt.toString("%Y/%m/%d %H:%M");
 		///
+		/// To format many DateTimes with the same format string, parse it once into a `Pattern` and use
+		/// the `toString(const Pattern&)` overload instead.
+		///
 		/// @param format A C++20 chrono format string.
 		/// @return A formatted string representing the UTC DateTime.
 		/// @throws std::invalid_argument If the format string is invalid.
 		std::string toString(const std::string& format) const;
 
+		/// Returns a string representation of the DateTime formatted with a precompiled pattern.
+		/// @param pattern A pattern created from a C++20 chrono format string.
+		/// @return A formatted string representing the UTC DateTime.
+		std::string toString(const Pattern& pattern) const;
+
 		/// @brief Converts the DateTime to a Unix timestamp (number of seconds since January 1, 1970, UTC).
 		/// @return The Unix timestamp representing the DateTime.
 		long long toUnixTimestamp() const;
 
+		/// Returns the number of whole seconds since 1970-01-01T00:00:00Z, rounded down.
+		constexpr int64_t toUnixSeconds() const noexcept;
+
+		/// Returns the number of milliseconds since 1970-01-01T00:00:00Z, rounded down.
+		constexpr int64_t toUnixMillis() const noexcept;
+
+		/// Returns the number of microseconds since 1970-01-01T00:00:00Z, rounded down.
+		constexpr int64_t toUnixMicros() const noexcept;
+
+		/// Returns the number of nanoseconds since 1970-01-01T00:00:00Z.
+		/// @throws std::out_of_range If the value does not fit in int64_t (years before 1678 or after 2261).
+		constexpr int64_t toUnixNanos() const;
+
+		/// Returns the number of ticks since 1970-01-01T00:00:00Z.
+		constexpr int64_t ticks() const noexcept { return m_timePoint.time_since_epoch().count(); }
+
 	  private:
-		using TimePoint = std::chrono::sys_time<std::chrono::milliseconds>;
+		using TimePoint = std::chrono::sys_time<Duration>;
 		TimePoint m_timePoint;
 
 	  private:
-		explicit DateTime(const TimePoint& tp) : m_timePoint(tp) {}
-		const TimePoint& timePoint() const noexcept { return m_timePoint; }
-		friend struct std::formatter<DateTime>;
+		constexpr explicit BasicDateTime(const TimePoint& tp) : m_timePoint(tp) {}
+
+		/// Creates a DateTime from a tick count known to be in range.
+		static constexpr BasicDateTime fromTicks(int64_t ticks) noexcept
+		{
+			return BasicDateTime(TimePoint{Duration{ticks}});
+		}
+
+		template <int64_t UnitsPerSecond> static constexpr BasicDateTime fromUnixTime(int64_t value);
+		template <int64_t UnitsPerSecond> constexpr int64_t toUnixTime() const noexcept;
+
+		static constexpr int64_t TicksPerDay = TicksPerSecond * 86'400;
+
+		/// Returns the interval in ticks. @throws std::invalid_argument If it is shorter than one tick.
+		static constexpr int64_t intervalTicks(const TimeSpan& interval);
+
+		/// Returns the ticks since the last start of an interval of `step` ticks since `origin`, in [0, step).
+		constexpr int64_t intervalOffset(int64_t step, const BasicDateTime& origin) const noexcept
+		{
+			// Reduced separately first, as the difference of the tick counts can overflow for nanoseconds.
+			return detail::floorMod(detail::floorMod(ticks(), step) - detail::floorMod(origin.ticks(), step), step);
+		}
+
+		/// Returns the DateTime `offset` ticks later. @throws std::out_of_range If it is outside the supported range.
+		constexpr BasicDateTime addTicks(int64_t offset) const;
+
+		/// Returns the start of a day. @throws std::out_of_range If it is outside the supported range.
+		static constexpr BasicDateTime fromDays(int64_t days);
+
+		/// Returns the first day of the calendar unit containing the given day.
+		static constexpr int64_t unitStart(int64_t days, CalendarUnit unit) noexcept;
+
+		/// Returns the first day of the calendar unit following the one starting on `start`.
+		static constexpr int64_t nextUnitStart(int64_t start, CalendarUnit unit) noexcept;
+
+		/// Returns the first invalid component, or `std::nullopt` if all of them are valid.
+		/// On success, stores the ticks since the Unix epoch in `ticks`.
+		static constexpr std::optional<DateTimeError> composeTicks(int year,
+																	 int month,
+																	 int day,
+																	 int hours,
+																	 int minutes,
+																	 int seconds,
+																	 double milliseconds,
+																	 int64_t& ticks) noexcept;
+
+		template <DateTimePrecision> friend class BasicDateTime;
 	};
 
+#ifndef ONION_HEADER_ONLY
+	extern template class BasicDateTime<std::chrono::milliseconds>;
+	extern template class BasicDateTime<std::chrono::microseconds>;
+	extern template class BasicDateTime<std::chrono::nanoseconds>;
+#endif
+
+	// ----- Inline Implementations -----
+	template <DateTimePrecision Duration>
+	constexpr std::optional<DateTimeError> BasicDateTime<Duration>::composeTicks(int year,
+																				   int month,
+																				   int day,
+																				   int hours,
+																				   int minutes,
+																				   int seconds,
+																				   double milliseconds,
+																				   int64_t& ticks) noexcept
+	{
+		// ---- Validate ranges ----
+		if (year < 1 || year > 9999)
+			return DateTimeError::YearOutOfRange;
+
+		if (month < 1 || month > 12)
+			return DateTimeError::MonthOutOfRange;
+
+		if (day < 1 || day > 31)
+			return DateTimeError::DayOutOfRange;
+
+		if (hours < 0 || hours > 23)
+			return DateTimeError::HourOutOfRange;
+
+		if (minutes < 0 || minutes > 59)
+			return DateTimeError::MinuteOutOfRange;
+
+		if (seconds < 0 || seconds > 59)
+			return DateTimeError::SecondOutOfRange;
+
+		if (!(milliseconds >= 0.0 && milliseconds < 1000.0))
+			return DateTimeError::MillisecondOutOfRange;
+
+		// ---- Validate calendar date ----
+		if (static_cast<unsigned>(day) > detail::daysInMonth(year, static_cast<unsigned>(month)))
+			return DateTimeError::InvalidDate;
+
+		// ---- Compose ----
+		// Whole milliseconds are truncated like they always were; finer precisions round to the nearest tick.
+		int64_t subsecondTicks;
+		if constexpr (TicksPerSecond == detail::MillisPerSecond)
+		{
+			subsecondTicks = static_cast<int64_t>(milliseconds);
+		}
+		else
+		{
+			constexpr int64_t TicksPerMilli = TicksPerSecond / detail::MillisPerSecond;
+			subsecondTicks = static_cast<int64_t>(milliseconds * TicksPerMilli + 0.5);
+			if (subsecondTicks >= TicksPerSecond)
+				subsecondTicks = TicksPerSecond - 1;
+		}
+
+		const int64_t unixSeconds =
+			detail::daysFromCivil(year, static_cast<unsigned>(month), static_cast<unsigned>(day)) * 86'400 +
+			hours * 3'600 + minutes * 60 + seconds;
+
+		// Only nanoseconds can overflow, outside [1677, 2262].
+		if (!detail::composeTicks<TicksPerSecond>(unixSeconds, subsecondTicks, ticks))
+			return DateTimeError::YearOutOfRange;
+
+		return std::nullopt;
+	}
+
+	template <DateTimePrecision Duration>
+	constexpr BasicDateTime<Duration>::BasicDateTime(
+		int year, int month, int day, int hours, int minutes, int seconds, double milliseconds)
+	{
+		int64_t ticks = 0;
+		if (const auto error = composeTicks(year, month, day, hours, minutes, seconds, milliseconds, ticks))
+		{
+			if (*error == DateTimeError::InvalidDate)
+				detail::raise(std::invalid_argument(onion::toString(*error).data()));
+			detail::raise(std::out_of_range(onion::toString(*error).data()));
+		}
+
+		m_timePoint = TimePoint{Duration{ticks}};
+	}
+
+	template <DateTimePrecision Duration>
+	template <DateTimePrecision OtherDuration>
+	constexpr BasicDateTime<Duration>::BasicDateTime(const BasicDateTime<OtherDuration>& other)
+		: m_timePoint(fromUnixTime<BasicDateTime<OtherDuration>::TicksPerSecond>(other.ticks()).m_timePoint)
+	{
+	}
+
+	template <DateTimePrecision Duration>
+	constexpr Expected<BasicDateTime<Duration>, DateTimeError> BasicDateTime<Duration>::TryCreate(
+		int year, int month, int day, int hours, int minutes, int seconds, double milliseconds) noexcept
+	{
+		int64_t ticks = 0;
+		if (const auto error = composeTicks(year, month, day, hours, minutes, seconds, milliseconds, ticks))
+			return Unexpected(*error);
+
+		return fromTicks(ticks);
+	}
+
+	template <DateTimePrecision Duration>
+	template <int64_t UnitsPerSecond>
+	constexpr BasicDateTime<Duration> BasicDateTime<Duration>::fromUnixTime(int64_t value)
+	{
+		if (value < detail::MinUnixTime<UnitsPerSecond, TicksPerSecond> ||
+			value > detail::MaxUnixTime<UnitsPerSecond, TicksPerSecond>)
+			detail::raise(std::out_of_range("Unix time out of DateTime range"));
+
+		return fromTicks(detail::convertUnixTime<UnitsPerSecond, TicksPerSecond>(value));
+	}
+
+	template <DateTimePrecision Duration>
+	template <int64_t UnitsPerSecond>
+	constexpr int64_t BasicDateTime<Duration>::toUnixTime() const noexcept
+	{
+		return detail::convertUnixTime<TicksPerSecond, UnitsPerSecond>(ticks());
+	}
+
+	template <DateTimePrecision Duration>
+	constexpr BasicDateTime<Duration> BasicDateTime<Duration>::FromUnixSeconds(int64_t seconds)
+	{
+		return fromUnixTime<1>(seconds);
+	}
+
+	template <DateTimePrecision Duration>
+	constexpr BasicDateTime<Duration> BasicDateTime<Duration>::FromUnixMillis(int64_t milliseconds)
+	{
+		return fromUnixTime<1'000>(milliseconds);
+	}
+
+	template <DateTimePrecision Duration>
+	constexpr BasicDateTime<Duration> BasicDateTime<Duration>::FromUnixMicros(int64_t microseconds)
+	{
+		return fromUnixTime<1'000'000>(microseconds);
+	}
+
+	template <DateTimePrecision Duration>
+	constexpr BasicDateTime<Duration> BasicDateTime<Duration>::FromUnixNanos(int64_t nanoseconds) noexcept
+	{
+		// The int64 nanosecond range is inside the supported range at every precision.
+		return fromTicks(detail::convertUnixTime<1'000'000'000, TicksPerSecond>(nanoseconds));
+	}
+
+	template <DateTimePrecision Duration> constexpr int64_t BasicDateTime<Duration>::toUnixSeconds() const noexcept
+	{
+		return toUnixTime<1>();
+	}
+
+	template <DateTimePrecision Duration> constexpr int64_t BasicDateTime<Duration>::toUnixMillis() const noexcept
+	{
+		return toUnixTime<1'000>();
+	}
+
+	template <DateTimePrecision Duration> constexpr int64_t BasicDateTime<Duration>::toUnixMicros() const noexcept
+	{
+		return toUnixTime<1'000'000>();
+	}
+
+	template <DateTimePrecision Duration> constexpr int64_t BasicDateTime<Duration>::toUnixNanos() const
+	{
+		if (ticks() < detail::MinConvertibleTicks<1'000'000'000, TicksPerSecond> ||
+			ticks() > detail::MaxConvertibleTicks<1'000'000'000, TicksPerSecond>)
+			detail::raise(std::out_of_range("DateTime out of the int64 Unix nanoseconds range"));
+
+		return toUnixTime<1'000'000'000>();
+	}
+
+	template <DateTimePrecision Duration>
+	constexpr TimeSpan BasicDateTime<Duration>::operator-(const BasicDateTime& other) const
+	{
+		return TimeSpan(std::chrono::duration_cast<std::chrono::nanoseconds>(m_timePoint - other.m_timePoint));
+	}
+
+	template <DateTimePrecision Duration>
+	constexpr BasicDateTime<Duration> BasicDateTime<Duration>::operator+(const TimeSpan& ts) const
+	{
+		return addTicks(std::chrono::duration_cast<Duration>(ts.GetDuration()).count());
+	}
+
+	template <DateTimePrecision Duration>
+	constexpr BasicDateTime<Duration> BasicDateTime<Duration>::operator-(const TimeSpan& ts) const
+	{
+		int64_t result = 0;
+		if (detail::subOverflow(ticks(), std::chrono::duration_cast<Duration>(ts.GetDuration()).count(), result))
+			detail::raise(std::out_of_range("Unix time out of DateTime range"));
+		return fromUnixTime<TicksPerSecond>(result);
+	}
+
+	template <DateTimePrecision Duration>
+	constexpr int64_t BasicDateTime<Duration>::intervalTicks(const TimeSpan& interval)
+	{
+		const int64_t ticks = std::chrono::duration_cast<Duration>(interval.GetDuration()).count();
+		if (ticks <= 0)
+			detail::raise(std::invalid_argument("DateTime rounding interval is shorter than the precision"));
+		return ticks;
+	}
+
+	template <DateTimePrecision Duration>
+	constexpr BasicDateTime<Duration> BasicDateTime<Duration>::addTicks(int64_t offset) const
+	{
+		int64_t result = 0;
+		if (detail::addOverflow(ticks(), offset, result))
+			detail::raise(std::out_of_range("Unix time out of DateTime range"));
+		return fromUnixTime<TicksPerSecond>(result);
+	}
+
+	template <DateTimePrecision Duration>
+	constexpr BasicDateTime<Duration> BasicDateTime<Duration>::fromDays(int64_t days)
+	{
+		int64_t result = 0;
+		if (detail::mulOverflow(days, TicksPerDay, result))
+			detail::raise(std::out_of_range("Unix time out of DateTime range"));
+		return fromUnixTime<TicksPerSecond>(result);
+	}
+
+	template <DateTimePrecision Duration>
+	constexpr int64_t BasicDateTime<Duration>::unitStart(int64_t days, CalendarUnit unit) noexcept
+	{
+		switch (unit)
+		{
+			case CalendarUnit::Week:
+				return detail::weekStartFromDays(days);
+			case CalendarUnit::Month:
+				return detail::periodStartFromDays(days, 1);
+			case CalendarUnit::Quarter:
+				return detail::periodStartFromDays(days, 3);
+			case CalendarUnit::Year:
+				return detail::periodStartFromDays(days, 12);
+			default:
+				return days;
+		}
+	}
+
+	template <DateTimePrecision Duration>
+	constexpr int64_t BasicDateTime<Duration>::nextUnitStart(int64_t start, CalendarUnit unit) noexcept
+	{
+		// The longest day, week, month, quarter and year after `start` all end in the following unit.
+		constexpr int64_t longest[] = {1, 7, 31, 92, 366};
+		return unitStart(start + longest[static_cast<int>(unit)], unit);
+	}
+
+	template <DateTimePrecision Duration>
+	constexpr BasicDateTime<Duration> BasicDateTime<Duration>::floor(const TimeSpan& interval,
+																	 const BasicDateTime& origin) const
+	{
+		const int64_t step = intervalTicks(interval);
+		const int64_t offset = intervalOffset(step, origin);
+		return addTicks(-offset);
+	}
+
+	template <DateTimePrecision Duration>
+	constexpr BasicDateTime<Duration> BasicDateTime<Duration>::ceil(const TimeSpan& interval,
+																	const BasicDateTime& origin) const
+	{
+		const int64_t step = intervalTicks(interval);
+		const int64_t offset = intervalOffset(step, origin);
+		return offset == 0 ? *this : addTicks(step - offset);
+	}
+
+	template <DateTimePrecision Duration>
+	constexpr BasicDateTime<Duration> BasicDateTime<Duration>::round(const TimeSpan& interval,
+																	 const BasicDateTime& origin) const
+	{
+		const int64_t step = intervalTicks(interval);
+		const int64_t offset = intervalOffset(step, origin);
+		return offset < step - offset ? addTicks(-offset) : addTicks(step - offset);
+	}
+
+	template <DateTimePrecision Duration>
+	constexpr BasicDateTime<Duration> BasicDateTime<Duration>::floor(CalendarUnit unit) const
+	{
+		return fromDays(unitStart(detail::floorDiv(ticks(), TicksPerDay), unit));
+	}
+
+	template <DateTimePrecision Duration>
+	constexpr BasicDateTime<Duration> BasicDateTime<Duration>::ceil(CalendarUnit unit) const
+	{
+		const int64_t days = detail::floorDiv(ticks(), TicksPerDay);
+		const int64_t start = unitStart(days, unit);
+		if (start == days && detail::floorMod(ticks(), TicksPerDay) == 0)
+			return *this;
+		return fromDays(nextUnitStart(start, unit));
+	}
+
+	template <DateTimePrecision Duration>
+	constexpr BasicDateTime<Duration> BasicDateTime<Duration>::round(CalendarUnit unit) const
+	{
+		// Distances are at most a year, so they fit in int64_t at every precision.
+		const int64_t days = detail::floorDiv(ticks(), TicksPerDay);
+		const int64_t timeOfDay = detail::floorMod(ticks(), TicksPerDay);
+		const int64_t start = unitStart(days, unit);
+		const int64_t next = nextUnitStart(start, unit);
+		const int64_t sinceStart = (days - start) * TicksPerDay + timeOfDay;
+		const int64_t untilNext = (next - days) * TicksPerDay - timeOfDay;
+		return fromDays(sinceStart < untilNext ? start : next);
+	}
+
 } // namespace onion
 
 /// @brief Provides a custom formatter for `onion::DateTime` to enable formatting with `std::format` and `std::vformat`.
-template <> struct std::formatter<onion::DateTime>
+///
+/// The format spec is compiled into a `DateTime::Pattern` once in `parse()`, so formatting does not re-parse it.
+/// `%S` writes as many fractional digits as the precision has.
+template <onion::DateTimePrecision Duration> struct std::formatter<onion::BasicDateTime<Duration>>
 {
-	std::string chronoFormat = "%d-%m-%Y %H:%M:%S";
+	static constexpr onion::DateTime::Pattern DefaultPattern = onion::DateTime::Pattern::Compile("%d-%m-%Y %H:%M:%S");
+
+	onion::DateTime::Pattern pattern = DefaultPattern;
 
 	constexpr auto parse(std::format_parse_context& ctx)
 	{
@@ -159,16 +760,29 @@ template <> struct std::formatter<onion::DateTime>
 			while (it != end && *it != '}')
 				++it;
 
-			chronoFormat = std::string(start, it);
+			if (!pattern.assign(std::string_view(start, it)))
+				onion::detail::raise(std::format_error("Invalid DateTime format string"));
 		}
 
 		return it;
 	}
 
-	template <typename FormatContext> auto format(const onion::DateTime& dt, FormatContext& ctx) const
+	template <typename FormatContext> auto format(const onion::BasicDateTime<Duration>& dt, FormatContext& ctx) const
 	{
-		return std::vformat_to(
-			ctx.out(), "{:" + chronoFormat + "}", std::make_format_args(dt.timePoint()) // requires friend access
-		);
+		return pattern.formatTo(ctx.out(), dt);
 	}
 };
+
+/// Hashes a DateTime by its tick count, mixed so that nearby instants land in distant buckets.
+template <onion::DateTimePrecision Duration> struct std::hash<onion::BasicDateTime<Duration>>
+{
+	std::size_t operator()(const onion::BasicDateTime<Duration>& dt) const noexcept
+	{
+		return static_cast<std::size_t>(onion::detail::mixBits(static_cast<uint64_t>(dt.ticks())));
+	}
+};
+
+#ifdef ONION_HEADER_ONLY
+#include "DateTime.cpp"
+#include "DateTimePattern.cpp"
+#endif
@@ -0,0 +1,24 @@
+#pragma once
+
+#include <chrono>
+#include <concepts>
+
+namespace onion
+{
+	/// Precisions a `BasicDateTime` can be instantiated with.
+	template <typename Duration>
+	concept DateTimePrecision = std::same_as<Duration, std::chrono::milliseconds> ||
+		std::same_as<Duration, std::chrono::microseconds> || std::same_as<Duration, std::chrono::nanoseconds>;
+
+	template <DateTimePrecision Duration> class BasicDateTime;
+
+	/// A UTC date and time with millisecond precision.
+	using DateTime = BasicDateTime<std::chrono::milliseconds>;
+
+	/// A UTC date and time with microsecond precision.
+	using DateTimeMicros = BasicDateTime<std::chrono::microseconds>;
+
+	/// A UTC date and time with nanosecond precision, limited to the int64 range [1677-09-21, 2262-04-11].
+	using DateTimeNanos = BasicDateTime<std::chrono::nanoseconds>;
+
+} // namespace onion
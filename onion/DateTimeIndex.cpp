@@ -0,0 +1,260 @@
+#include "DateTimeIndex.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <limits>
+#include <stdexcept>
+
+#include "Batch.hpp"
+#include "Config.hpp"
+
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define ONION_INDEX_X86 1
+#define ONION_INDEX_KERNEL [[gnu::always_inline]] inline
+#else
+#define ONION_INDEX_X86 0
+#define ONION_INDEX_KERNEL inline
+#endif
+
+namespace onion
+{
+	namespace
+	{
+		constexpr std::size_t Fanout = DateTimeIndex::NodeSize + 1;
+		constexpr int64_t PaddingKey = std::numeric_limits<int64_t>::max();
+
+		/// Queries searched together by `lowerBounds`, each one's next node being prefetched while the others are
+		/// compared.
+		constexpr std::size_t QueryGroupSize = 16;
+
+		/// The tree, as seen by the search kernels.
+		struct Tree
+		{
+			const int64_t* keys;
+			const std::size_t* layerStart;
+			std::size_t height;
+		};
+
+		ONION_INDEX_KERNEL void prefetch(const void* address) noexcept
+		{
+#if defined(__GNUC__) || defined(__clang__)
+			__builtin_prefetch(address);
+#else
+			(void)address;
+#endif
+		}
+
+		/// Number of keys of a node less than `key`.
+		ONION_INDEX_KERNEL unsigned rankScalar(const int64_t* node, int64_t key) noexcept
+		{
+			unsigned rank = 0;
+			for (std::size_t i = 0; i < DateTimeIndex::NodeSize; ++i)
+				rank += node[i] < key ? 1u : 0u;
+			return rank;
+		}
+
+#if ONION_INDEX_X86
+		__attribute__((target("avx2,popcnt"))) inline unsigned rankAvx2(const int64_t* node, int64_t key) noexcept
+		{
+			const __m256i query = _mm256_set1_epi64x(key);
+			const __m256i low = _mm256_load_si256(reinterpret_cast<const __m256i*>(node));
+			const __m256i high = _mm256_load_si256(reinterpret_cast<const __m256i*>(node + 4));
+			const __m256i lowLess = _mm256_cmpgt_epi64(query, low);
+			const __m256i highLess = _mm256_cmpgt_epi64(query, high);
+			const auto mask = static_cast<unsigned>(_mm256_movemask_pd(_mm256_castsi256_pd(lowLess)) |
+													 _mm256_movemask_pd(_mm256_castsi256_pd(highLess)) << 4);
+			return static_cast<unsigned>(__builtin_popcount(mask));
+		}
+#endif
+
+		ONION_INDEX_KERNEL const int64_t* node(const Tree& tree, std::size_t layer, std::size_t index) noexcept
+		{
+			return tree.keys + (tree.layerStart[layer] + index) * DateTimeIndex::NodeSize;
+		}
+
+		/// Descends from the root to the position of the first key not less than `key`, which must not exceed the
+		/// greatest key.
+		template <unsigned (*Rank)(const int64_t*, int64_t) noexcept>
+		ONION_INDEX_KERNEL std::size_t searchKernel(const Tree& tree, int64_t key) noexcept
+		{
+			std::size_t index = 0;
+			for (std::size_t layer = tree.height - 1; layer > 0; --layer)
+				index = index * Fanout + Rank(node(tree, layer, index), key);
+			return index * DateTimeIndex::NodeSize + Rank(node(tree, 0, index), key);
+		}
+
+		/// Searches a group of keys level by level, prefetching the next node of each key.
+		template <unsigned (*Rank)(const int64_t*, int64_t) noexcept>
+		ONION_INDEX_KERNEL void searchGroupKernel(const Tree& tree,
+												  const int64_t* __restrict keys,
+												  std::size_t* __restrict positions,
+												  std::size_t count) noexcept
+		{
+			std::size_t indexes[QueryGroupSize] = {};
+			for (std::size_t layer = tree.height - 1; layer > 0; --layer)
+			{
+				for (std::size_t i = 0; i < count; ++i)
+				{
+					indexes[i] = indexes[i] * Fanout + Rank(node(tree, layer, indexes[i]), keys[i]);
+					prefetch(node(tree, layer - 1, indexes[i]));
+				}
+			}
+			for (std::size_t i = 0; i < count; ++i)
+				positions[i] = indexes[i] * DateTimeIndex::NodeSize + Rank(node(tree, 0, indexes[i]), keys[i]);
+		}
+
+		std::size_t searchScalar(const Tree& tree, int64_t key) noexcept
+		{
+			return searchKernel<rankScalar>(tree, key);
+		}
+
+		void searchGroupScalar(const Tree& tree,
+							   const int64_t* keys,
+							   std::size_t* positions,
+							   std::size_t count) noexcept
+		{
+			searchGroupKernel<rankScalar>(tree, keys, positions, count);
+		}
+
+#if ONION_INDEX_X86
+		__attribute__((target("avx2,popcnt"))) std::size_t searchAvx2(const Tree& tree, int64_t key) noexcept
+		{
+			return searchKernel<rankAvx2>(tree, key);
+		}
+
+		__attribute__((target("avx2,popcnt"))) void searchGroupAvx2(const Tree& tree,
+																	 const int64_t* keys,
+																	 std::size_t* positions,
+																	 std::size_t count) noexcept
+		{
+			searchGroupKernel<rankAvx2>(tree, keys, positions, count);
+		}
+#endif
+
+		bool useAvx2() noexcept
+		{
+			static const bool supported = batch::activeIsa() != batch::Isa::Scalar;
+			return supported;
+		}
+	} // namespace
+
+	ONION_INLINE DateTimeIndex::DateTimeIndex(std::span<const DateTime> sorted)
+		: m_size(sorted.size())
+	{
+		if (!std::is_sorted(sorted.begin(), sorted.end()))
+			detail::raise(std::invalid_argument("DateTimeIndex: values are not sorted"));
+		if (sorted.empty())
+			return;
+
+		m_last = sorted.back().toUnixMillis();
+
+		// Layer sizes, from the leaves up to the root.
+		std::vector<std::size_t> layerSizes{(m_size + NodeSize - 1) / NodeSize};
+		while (layerSizes.back() > 1)
+			layerSizes.push_back((layerSizes.back() + Fanout - 1) / Fanout);
+
+		m_layerStart.resize(layerSizes.size());
+		std::size_t start = 0;
+		for (std::size_t layer = layerSizes.size(); layer-- > 0;)
+		{
+			m_layerStart[layer] = start;
+			start += layerSizes[layer];
+		}
+		m_nodes.resize(start);
+
+		// Leaves: the values in order, padded with keys greater than any query.
+		int64_t* leaves = m_nodes[m_layerStart[0]].keys;
+		for (std::size_t i = 0; i < layerSizes[0] * NodeSize; ++i)
+			leaves[i] = i < m_size ? sorted[i].toUnixMillis() : PaddingKey;
+
+		// Internal nodes: key i is the greatest value under child i, the last child having no key.
+		std::size_t childSpan = NodeSize; // values under a node of the layer below
+		for (std::size_t layer = 1; layer < layerSizes.size(); ++layer)
+		{
+			for (std::size_t index = 0; index < layerSizes[layer]; ++index)
+			{
+				int64_t* keys = m_nodes[m_layerStart[layer] + index].keys;
+				for (std::size_t i = 0; i < NodeSize; ++i)
+				{
+					const std::size_t first = (index * Fanout + i) * childSpan;
+					keys[i] = first < m_size ? leaves[std::min(first + childSpan, m_size) - 1] : PaddingKey;
+				}
+			}
+			childSpan *= Fanout;
+		}
+	}
+
+	ONION_INLINE std::size_t DateTimeIndex::lowerBound(int64_t unixMillis) const noexcept
+	{
+		// Past the greatest value, the search would descend into missing children.
+		if (m_size == 0 || unixMillis > m_last)
+			return m_size;
+
+		const Tree tree{m_nodes.front().keys, m_layerStart.data(), m_layerStart.size()};
+#if ONION_INDEX_X86
+		if (useAvx2())
+			return searchAvx2(tree, unixMillis);
+#endif
+		return searchScalar(tree, unixMillis);
+	}
+
+	ONION_INLINE std::size_t DateTimeIndex::lowerBound(const DateTime& dateTime) const noexcept
+	{
+		return lowerBound(dateTime.toUnixMillis());
+	}
+
+	ONION_INLINE std::size_t DateTimeIndex::upperBound(const DateTime& dateTime) const noexcept
+	{
+		// Keys are integers, so the first one greater than x is the first one not less than x + 1.
+		return lowerBound(dateTime.toUnixMillis() + 1);
+	}
+
+	ONION_INLINE std::pair<std::size_t, std::size_t> DateTimeIndex::equalRange(const DateTime& dateTime) const noexcept
+	{
+		return {lowerBound(dateTime), upperBound(dateTime)};
+	}
+
+	ONION_INLINE std::pair<std::size_t, std::size_t> DateTimeIndex::range(const DateTime& from,
+																		  const DateTime& to) const noexcept
+	{
+		const std::size_t first = lowerBound(from);
+		return {first, std::max(first, lowerBound(to))};
+	}
+
+	ONION_INLINE void DateTimeIndex::lowerBounds(std::span<const DateTime> queries, std::span<std::size_t> out) const
+	{
+		if (out.size() < queries.size())
+			detail::raise(std::invalid_argument("DateTimeIndex: output column is shorter than the input"));
+		if (m_size == 0)
+		{
+			std::fill_n(out.begin(), queries.size(), 0);
+			return;
+		}
+
+		const Tree tree{m_nodes.front().keys, m_layerStart.data(), m_layerStart.size()};
+#if ONION_INDEX_X86
+		const bool avx2 = useAvx2();
+#endif
+		int64_t keys[QueryGroupSize];
+		for (std::size_t first = 0; first < queries.size(); first += QueryGroupSize)
+		{
+			// Queries past the greatest value are searched as the greatest value, then moved to the end.
+			const std::size_t count = std::min(QueryGroupSize, queries.size() - first);
+			for (std::size_t i = 0; i < count; ++i)
+				keys[i] = std::min(queries[first + i].toUnixMillis(), m_last);
+
+			std::size_t* positions = out.data() + first;
+#if ONION_INDEX_X86
+			if (avx2)
+				searchGroupAvx2(tree, keys, positions, count);
+			else
+#endif
+				searchGroupScalar(tree, keys, positions, count);
+
+			for (std::size_t i = 0; i < count; ++i)
+				positions[i] = queries[first + i].toUnixMillis() > m_last ? m_size : positions[i];
+		}
+	}
+
+} // namespace onion
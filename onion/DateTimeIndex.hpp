@@ -0,0 +1,86 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <utility>
+#include <vector>
+
+#include "Config.hpp"
+#include "DateTime.hpp"
+
+namespace onion
+{
+	/// A static search index over a sorted array of DateTimes, for range queries on large arrays.
+	///
+	/// The values are copied into an implicit B+ tree (an "S+ tree") whose nodes hold `NodeSize` keys and fill one
+	/// 64-byte cache line, so a search touches one cache line per level instead of one per halving as
+	/// `std::lower_bound` does: 7 levels for 100 million values. Within a node, the child is picked by counting
+	/// the keys less than the query, without branches, with AVX2 compares when the CPU supports them. The bulk
+	/// `lowerBounds` interleaves several queries and prefetches their next nodes, hiding most of the memory latency.
+	///
+	/// The leaves hold the values in their original order, so positions returned are indexes in the input array.
+	/// The index takes about 1.15 times the memory of the input, and does not reference the input once built.
+	///
+	/// Example:
+	///   const onion::DateTimeIndex index(timestamps); // sorted
+	///   const auto [first, last] = index.range(from, to); // timestamps[first, last) are in [from, to)
+	class DateTimeIndex
+	{
+	  public:
+		/// Number of keys per node.
+		static constexpr std::size_t NodeSize = 8;
+
+	  public:
+		/// Creates an empty index.
+		DateTimeIndex() = default;
+
+		/// Builds the index of a sorted array of DateTimes.
+		/// @throws std::invalid_argument If the values are not sorted in non-decreasing order.
+		explicit DateTimeIndex(std::span<const DateTime> sorted);
+
+	  public:
+		/// Returns the number of indexed values.
+		std::size_t size() const noexcept { return m_size; }
+
+		/// Returns true if the index has no value.
+		bool empty() const noexcept { return m_size == 0; }
+
+		/// Returns the position of the first value not less than `dateTime`, or `size()` if there is none,
+		/// like `std::lower_bound`.
+		std::size_t lowerBound(const DateTime& dateTime) const noexcept;
+
+		/// Returns the position of the first value greater than `dateTime`, or `size()` if there is none,
+		/// like `std::upper_bound`.
+		std::size_t upperBound(const DateTime& dateTime) const noexcept;
+
+		/// Returns the positions of the values equal to `dateTime`, like `std::equal_range`.
+		std::pair<std::size_t, std::size_t> equalRange(const DateTime& dateTime) const noexcept;
+
+		/// Returns the positions of the values in [from, to).
+		std::pair<std::size_t, std::size_t> range(const DateTime& from, const DateTime& to) const noexcept;
+
+		/// Computes `lowerBound` for a column of queries.
+		/// @throws std::invalid_argument If `out` is shorter than `queries`.
+		void lowerBounds(std::span<const DateTime> queries, std::span<std::size_t> out) const;
+
+	  private:
+		struct alignas(64) Node
+		{
+			int64_t keys[NodeSize];
+		};
+
+		std::size_t lowerBound(int64_t unixMillis) const noexcept;
+
+	  private:
+		std::vector<Node> m_nodes;			   // layers from the root down to the leaves
+		std::vector<std::size_t> m_layerStart; // index in m_nodes of each layer, leaves first
+		std::size_t m_size = 0;
+		int64_t m_last = 0; // Unix milliseconds of the greatest value
+	};
+
+} // namespace onion
+
+#ifdef ONION_HEADER_ONLY
+#include "DateTimeIndex.cpp"
+#endif
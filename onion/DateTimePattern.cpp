@@ -0,0 +1,294 @@
+#include "DateTimePattern.hpp"
+
+#include <cstring>
+
+#include "Config.hpp"
+#include "DateTime.hpp"
+#include "detail/Calendar.hpp"
+#include "detail/Digits.hpp"
+
+namespace onion
+{
+	namespace
+	{
+		constexpr std::string_view MonthNames[12] = {"January",
+													 "February",
+													 "March",
+													 "April",
+													 "May",
+													 "June",
+													 "July",
+													 "August",
+													 "September",
+													 "October",
+													 "November",
+													 "December"};
+
+		constexpr std::string_view WeekdayNames[7] = {
+			"Sunday", "Monday", "Tuesday", "Wednesday", "Thursday", "Friday", "Saturday"};
+
+		/// The components of a DateTime as unsigned values, computed once per formatting call.
+		struct Fields
+		{
+			int year;
+			unsigned month;
+			unsigned day;
+			unsigned hours;
+			unsigned minutes;
+			unsigned seconds;
+			unsigned weekday;   // 0 = Sunday
+			unsigned dayOfYear; // 1-based
+		};
+
+		Fields computeFields(int64_t unixSeconds) noexcept
+		{
+			const int64_t days = detail::floorDiv(unixSeconds, 86'400);
+			const auto secondOfDay = static_cast<unsigned>(unixSeconds - days * 86'400);
+			const detail::CivilDate date = detail::civilFromDays(days);
+
+			Fields fields{};
+			fields.year = date.year;
+			fields.month = date.month;
+			fields.day = date.day;
+			fields.hours = secondOfDay / 3'600;
+			fields.minutes = secondOfDay / 60 % 60;
+			fields.seconds = secondOfDay % 60;
+			fields.weekday = detail::weekdayFromDays(days);
+			fields.dayOfYear = date.dayOfYear;
+			return fields;
+		}
+
+		/// Number of ISO 8601 weeks (52 or 53) in the given year.
+		unsigned isoWeeksInYear(int year) noexcept
+		{
+			auto p = [](int y) { return (y + y / 4 - y / 100 + y / 400) % 7; };
+			return (p(year) == 4 || p(year - 1) == 3) ? 53u : 52u;
+		}
+
+		/// Computes the ISO 8601 week-based year and week number.
+		void isoWeek(const Fields& fields, int& isoYear, unsigned& week) noexcept
+		{
+			const int isoWeekday = fields.weekday == 0 ? 7 : static_cast<int>(fields.weekday);
+			const int w = (static_cast<int>(fields.dayOfYear) - isoWeekday + 10) / 7;
+
+			isoYear = fields.year;
+			if (w < 1)
+			{
+				isoYear = fields.year - 1;
+				week = isoWeeksInYear(isoYear);
+			}
+			else if (static_cast<unsigned>(w) > isoWeeksInYear(fields.year))
+			{
+				isoYear = fields.year + 1;
+				week = 1;
+			}
+			else
+			{
+				week = static_cast<unsigned>(w);
+			}
+		}
+
+		inline char* writeName(char* out, std::string_view name) noexcept
+		{
+			std::memcpy(out, name.data(), name.size());
+			return out + name.size();
+		}
+	} // namespace
+
+	ONION_INLINE char* DateTimePattern::render(const Instant& instant,
+											   char* out,
+											   MillisecondDigits* digits) const noexcept
+	{
+		const Fields f = computeFields(instant.unixSeconds);
+		char* const start = out;
+
+		for (std::size_t i = 0; i < m_count; ++i)
+		{
+			const Operation& op = m_operations[i];
+			switch (op.code)
+			{
+				case Code::Literal:
+					*out++ = op.literal;
+					break;
+
+				// ---- Date ----
+				case Code::Year:
+					detail::writeDigits4(out, static_cast<unsigned>(f.year));
+					out += 4;
+					break;
+				case Code::YearTwoDigits:
+					detail::writeDigits2(out, static_cast<unsigned>(f.year % 100));
+					out += 2;
+					break;
+				case Code::Century:
+					detail::writeDigits2(out, static_cast<unsigned>(f.year / 100));
+					out += 2;
+					break;
+				case Code::Month:
+					detail::writeDigits2(out, f.month);
+					out += 2;
+					break;
+				case Code::MonthAbbreviated:
+					out = writeName(out, MonthNames[f.month - 1].substr(0, 3));
+					break;
+				case Code::MonthName:
+					out = writeName(out, MonthNames[f.month - 1]);
+					break;
+				case Code::Day:
+					detail::writeDigits2(out, f.day);
+					out += 2;
+					break;
+				case Code::DaySpacePadded:
+					detail::writeDigits2(out, f.day);
+					if (f.day < 10)
+						out[0] = ' ';
+					out += 2;
+					break;
+				case Code::DayOfYear:
+					detail::writeDigits3(out, f.dayOfYear);
+					out += 3;
+					break;
+				case Code::WeekdayAbbreviated:
+					out = writeName(out, WeekdayNames[f.weekday].substr(0, 3));
+					break;
+				case Code::WeekdayName:
+					out = writeName(out, WeekdayNames[f.weekday]);
+					break;
+				case Code::WeekdayIso:
+					*out++ = static_cast<char>('0' + (f.weekday == 0 ? 7 : f.weekday));
+					break;
+				case Code::Weekday:
+					*out++ = static_cast<char>('0' + f.weekday);
+					break;
+				case Code::IsoYear:
+				case Code::IsoYearTwoDigits:
+				case Code::IsoWeek:
+					{
+						int year;
+						unsigned week;
+						isoWeek(f, year, week);
+						if (op.code == Code::IsoYear)
+						{
+							detail::writeDigits4(out, static_cast<unsigned>(year));
+							out += 4;
+						}
+						else
+						{
+							const unsigned value = op.code == Code::IsoWeek ? week : static_cast<unsigned>(year) % 100;
+							detail::writeDigits2(out, value);
+							out += 2;
+						}
+						break;
+					}
+				case Code::WeekOfYearSunday:
+					detail::writeDigits2(out, (f.dayOfYear + 6 - f.weekday) / 7);
+					out += 2;
+					break;
+				case Code::WeekOfYearMonday:
+					detail::writeDigits2(out, (f.dayOfYear + 6 - (f.weekday + 6) % 7) / 7);
+					out += 2;
+					break;
+
+				// ---- Time ----
+				case Code::Hours:
+					detail::writeDigits2(out, f.hours);
+					out += 2;
+					break;
+				case Code::Hours12:
+					detail::writeDigits2(out, f.hours % 12 == 0 ? 12 : f.hours % 12);
+					out += 2;
+					break;
+				case Code::Minutes:
+					detail::writeDigits2(out, f.minutes);
+					out += 2;
+					break;
+				case Code::Seconds:
+					detail::writeDigits2(out, f.seconds);
+					out[2] = '.';
+					detail::writeDigitGroups(out + 3, instant.fraction, instant.fractionDigits);
+					if (digits != nullptr)
+						digits->add(static_cast<std::size_t>(out + 3 - start));
+					out += 3 + instant.fractionDigits;
+					break;
+				case Code::WholeSeconds:
+					detail::writeDigits2(out, f.seconds);
+					out += 2;
+					break;
+				case Code::AmPm:
+					out[0] = f.hours < 12 ? 'A' : 'P';
+					out[1] = 'M';
+					out += 2;
+					break;
+
+				// ---- Time zone (always UTC) ----
+				case Code::UtcOffset:
+					out = writeName(out, "+0000");
+					break;
+				case Code::UtcOffsetColon:
+					out = writeName(out, "+00:00");
+					break;
+				case Code::ZoneName:
+					out = writeName(out, "UTC");
+					break;
+			}
+		}
+
+		return out;
+	}
+
+	ONION_INLINE char* DateTimePattern::formatInPlace(const Instant& instant,
+													  char* begin,
+													  MillisecondDigits* digits) const noexcept
+	{
+		char* end = render(instant, begin, digits);
+
+		// ---- Padding to width ----
+		const auto length = static_cast<std::size_t>(end - begin);
+		if (length < m_width)
+		{
+			const std::size_t padding = m_width - length;
+			const std::size_t before = m_align == Align::Right ? padding : m_align == Align::Center ? padding / 2 : 0;
+
+			std::memmove(begin + before, begin, length);
+			std::memset(begin, m_fill, before);
+			std::memset(begin + before + length, m_fill, padding - before);
+			end = begin + m_width;
+
+			if (digits != nullptr)
+				for (std::size_t i = 0; i < digits->count; ++i)
+					digits->offsets[i] = static_cast<uint16_t>(digits->offsets[i] + before);
+		}
+
+		return end;
+	}
+
+	ONION_INLINE std::to_chars_result DateTimePattern::formatTo(const Instant& instant,
+																char* first,
+																char* last) const noexcept
+	{
+		char buffer[MaxFormattedLength];
+		const bool direct = last - first >= static_cast<std::ptrdiff_t>(m_maxLength);
+
+		char* const begin = direct ? first : buffer;
+		char* const end = formatInPlace(instant, begin, nullptr);
+
+		if (direct)
+			return {end, std::errc{}};
+
+		const auto size = static_cast<std::size_t>(end - begin);
+		if (static_cast<std::size_t>(last - first) < size)
+			return {last, std::errc::value_too_large};
+
+		std::memcpy(first, begin, size);
+		return {first + size, std::errc{}};
+	}
+
+	ONION_INLINE void DateTimePattern::appendTo(const Instant& instant, std::string& out) const
+	{
+		const std::size_t size = out.size();
+		out.resize(size + m_maxLength);
+		const std::to_chars_result result = formatTo(instant, out.data() + size, out.data() + out.size());
+		out.resize(static_cast<std::size_t>(result.ptr - out.data()));
+	}
+
+} // namespace onion
@@ -0,0 +1,478 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+#include "Config.hpp"
+#include "DateTimeFwd.hpp"
+#include "detail/Calendar.hpp"
+
+namespace onion
+{
+	/// A chrono-style format pattern, parsed once into a compact list of operations and reusable for any DateTime.
+	///
+	/// The pattern syntax is the C++20 `std::chrono` format-spec for a UTC time point:
+	///   [[fill]align][width][L][chrono-specs]
+	/// where chrono-specs starts with a conversion specifier (e.g. "%F %T", "%Y/%m/%d %H:%M").
+	/// An empty chrono-specs is equivalent to "%F %T".
+	///
+	/// All conversion specifiers valid for `std::chrono::sys_time` are supported, including the E and O modifiers.
+	/// Formatting does not allocate and does not use the locale: names and AM/PM are those of the "C" locale,
+	/// which is what `std::format` produces without the L option.
+	///
+	/// Patterns known at compile time can be checked with `Compile`:
+	///   constexpr auto pattern = DateTime::Pattern::Compile("%F %T");
+	class DateTimePattern
+	{
+	  public:
+		/// Maximum number of operations a pattern can hold. Each literal character and each conversion specifier
+		/// counts as one operation, composite specifiers (%F, %T, %c, ...) count as the operations they expand to.
+		static constexpr std::size_t MaxOperations = 128;
+
+		/// Maximum number of characters a single operation writes ("%S" with nanoseconds, "12.345678901").
+		static constexpr std::size_t MaxOperationLength = 12;
+
+		/// Upper bound of the number of characters written by any pattern, padding included.
+		static constexpr std::size_t MaxFormattedLength = MaxOperations * MaxOperationLength;
+
+	  public:
+		/// Creates an empty pattern, equivalent to "%F %T".
+		constexpr DateTimePattern() noexcept { assign(""); }
+
+		/// Parses the given pattern.
+		/// @param pattern A C++20 chrono format-spec.
+		/// @throws std::invalid_argument If the pattern is invalid or longer than `MaxOperations`.
+		constexpr explicit DateTimePattern(std::string_view pattern)
+		{
+			if (!assign(pattern))
+				detail::raise(std::invalid_argument("Invalid DateTime format string: " + std::string(pattern)));
+		}
+
+		/// Parses a pattern at compile time. An invalid pattern is a compilation error.
+		/// @param pattern A C++20 chrono format-spec.
+		/// @return The compiled pattern.
+		static consteval DateTimePattern Compile(std::string_view pattern) { return DateTimePattern(pattern); }
+
+		/// Replaces this pattern with the given one, without throwing.
+		/// @param pattern A C++20 chrono format-spec.
+		/// @return True on success. On failure the pattern is left empty and false is returned.
+		constexpr bool assign(std::string_view pattern) noexcept;
+
+	  public:
+		/// Returns an upper bound of the number of characters written by `formatTo`.
+		constexpr std::size_t maxFormattedSize() const noexcept { return m_maxLength; }
+
+		/// Writes the formatted DateTime into [first, last), in the manner of `std::to_chars`.
+		/// `%S` writes as many fractional digits as the precision of the DateTime has.
+		/// @return `{end of output, std::errc{}}` on success, or `{last, std::errc::value_too_large}` if the
+		///         buffer is too small.
+		template <DateTimePrecision Duration>
+		std::to_chars_result formatTo(const BasicDateTime<Duration>& dateTime, char* first, char* last) const noexcept
+		{
+			return formatTo(instant(dateTime), first, last);
+		}
+
+		/// Writes the formatted DateTime to an output iterator.
+		template <typename OutputIt, DateTimePrecision Duration>
+		OutputIt formatTo(OutputIt out, const BasicDateTime<Duration>& dateTime) const;
+
+		/// Returns the formatted DateTime as a string.
+		template <DateTimePrecision Duration> std::string format(const BasicDateTime<Duration>& dateTime) const
+		{
+			std::string result;
+			appendTo(instant(dateTime), result);
+			return result;
+		}
+
+		/// Appends the formatted DateTime to the given string.
+		template <DateTimePrecision Duration>
+		void appendTo(const BasicDateTime<Duration>& dateTime, std::string& out) const
+		{
+			appendTo(instant(dateTime), out);
+		}
+
+	  private:
+		/// A DateTime of any precision, as whole Unix seconds and a fraction of `fractionDigits` decimal digits.
+		/// Formatting goes through it so that the precisions share one non-template implementation.
+		struct Instant
+		{
+			int64_t unixSeconds;
+			uint32_t fraction;
+			uint8_t fractionDigits;
+		};
+
+		template <DateTimePrecision Duration>
+		static constexpr Instant instant(const BasicDateTime<Duration>& dateTime) noexcept
+		{
+			constexpr int64_t TicksPerSecond = BasicDateTime<Duration>::TicksPerSecond;
+			const int64_t ticks = dateTime.ticks();
+			const int64_t unixSeconds = detail::floorDiv(ticks, TicksPerSecond);
+			return Instant{unixSeconds,
+						   static_cast<uint32_t>(ticks - unixSeconds * TicksPerSecond),
+						   static_cast<uint8_t>(BasicDateTime<Duration>::FractionDigits)};
+		}
+
+		std::to_chars_result formatTo(const Instant& instant, char* first, char* last) const noexcept;
+		void appendTo(const Instant& instant, std::string& out) const;
+
+		enum class Code : uint8_t
+		{
+			Literal,
+			Year,
+			YearTwoDigits,
+			Century,
+			Month,
+			MonthAbbreviated,
+			MonthName,
+			Day,
+			DaySpacePadded,
+			DayOfYear,
+			Hours,
+			Hours12,
+			Minutes,
+			Seconds,
+			WholeSeconds,
+			AmPm,
+			WeekdayAbbreviated,
+			WeekdayName,
+			WeekdayIso,
+			Weekday,
+			IsoYear,
+			IsoYearTwoDigits,
+			IsoWeek,
+			WeekOfYearSunday,
+			WeekOfYearMonday,
+			UtcOffset,
+			UtcOffsetColon,
+			ZoneName,
+		};
+
+		struct Operation
+		{
+			Code code = Code::Literal;
+			char literal = '\0';
+		};
+
+		enum class Align : uint8_t
+		{
+			Left,
+			Right,
+			Center,
+		};
+
+		/// Offsets of the fractional digits written by %S, recorded for `TimestampFormatter`.
+		struct MillisecondDigits
+		{
+			static constexpr std::size_t Capacity = 4;
+
+			std::array<uint16_t, Capacity> offsets{};
+			uint8_t count = 0;
+			bool overflow = false; // more than Capacity millisecond fields
+
+			void add(std::size_t offset) noexcept
+			{
+				if (count == Capacity)
+					overflow = true;
+				else
+					offsets[count++] = static_cast<uint16_t>(offset);
+			}
+		};
+
+		static constexpr std::size_t maxLength(Code code) noexcept;
+		constexpr bool push(Code code, char literal = '\0') noexcept;
+		constexpr bool pushSpecifier(char specifier, char modifier) noexcept;
+
+		/// Writes the operations, recording fractional digits into `digits` if it is not null.
+		char* render(const Instant& instant, char* out, MillisecondDigits* digits) const noexcept;
+
+		/// Renders and pads into `begin`, which must hold at least `m_maxLength` characters. Returns the end.
+		char* formatInPlace(const Instant& instant, char* begin, MillisecondDigits* digits) const noexcept;
+
+		friend class TimestampFormatter;
+
+	  private:
+		std::array<Operation, MaxOperations> m_operations{};
+		uint16_t m_count = 0;
+		uint16_t m_width = 0;
+		uint16_t m_maxLength = 0;
+		char m_fill = ' ';
+		Align m_align = Align::Left;
+	};
+
+	// ----- Implementations -----
+	constexpr std::size_t DateTimePattern::maxLength(Code code) noexcept
+	{
+		switch (code)
+		{
+			case Code::Literal:
+				return 1;
+			case Code::DayOfYear:
+				return 3;
+			case Code::Year:
+			case Code::IsoYear:
+				return 4;
+			case Code::UtcOffset:
+				return 5;
+			case Code::UtcOffsetColon:
+				return 6;
+			case Code::Seconds:
+				return 12;
+			case Code::MonthName:
+			case Code::WeekdayName:
+				return 9;
+			case Code::WeekdayIso:
+			case Code::Weekday:
+				return 1;
+			case Code::MonthAbbreviated:
+			case Code::WeekdayAbbreviated:
+			case Code::ZoneName:
+				return 3;
+			default:
+				return 2;
+		}
+	}
+
+	constexpr bool DateTimePattern::push(Code code, char literal) noexcept
+	{
+		if (m_count == MaxOperations)
+			return false;
+
+		m_operations[m_count++] = Operation{code, literal};
+		m_maxLength = static_cast<uint16_t>(m_maxLength + maxLength(code));
+		return true;
+	}
+
+	constexpr bool DateTimePattern::pushSpecifier(char specifier, char modifier) noexcept
+	{
+		// ---- Modifiers: in the "C" locale %E and %O only change %Ez / %Oz ----
+		if (modifier == 'E' && std::string_view("cCxXyYz").find(specifier) == std::string_view::npos)
+			return false;
+
+		if (modifier == 'O' && std::string_view("deHImMSuUVwWyz").find(specifier) == std::string_view::npos)
+			return false;
+
+		switch (specifier)
+		{
+			// ---- Date ----
+			case 'Y':
+				return push(Code::Year);
+			case 'y':
+				return push(Code::YearTwoDigits);
+			case 'C':
+				return push(Code::Century);
+			case 'm':
+				return push(Code::Month);
+			case 'b':
+			case 'h':
+				return push(Code::MonthAbbreviated);
+			case 'B':
+				return push(Code::MonthName);
+			case 'd':
+				return push(Code::Day);
+			case 'e':
+				return push(Code::DaySpacePadded);
+			case 'j':
+				return push(Code::DayOfYear);
+			case 'a':
+				return push(Code::WeekdayAbbreviated);
+			case 'A':
+				return push(Code::WeekdayName);
+			case 'u':
+				return push(Code::WeekdayIso);
+			case 'w':
+				return push(Code::Weekday);
+			case 'G':
+				return push(Code::IsoYear);
+			case 'g':
+				return push(Code::IsoYearTwoDigits);
+			case 'V':
+				return push(Code::IsoWeek);
+			case 'U':
+				return push(Code::WeekOfYearSunday);
+			case 'W':
+				return push(Code::WeekOfYearMonday);
+
+			// ---- Time ----
+			case 'H':
+				return push(Code::Hours);
+			case 'I':
+				return push(Code::Hours12);
+			case 'M':
+				return push(Code::Minutes);
+			case 'S':
+				return push(Code::Seconds);
+			case 'p':
+				return push(Code::AmPm);
+
+			// ---- Time zone ----
+			case 'z':
+				return push(modifier == '\0' ? Code::UtcOffset : Code::UtcOffsetColon);
+			case 'Z':
+				return push(Code::ZoneName);
+
+			// ---- Composites ----
+			case 'F':
+				return push(Code::Year) && push(Code::Literal, '-') && push(Code::Month) && push(Code::Literal, '-') &&
+					push(Code::Day);
+			case 'D':
+			case 'x':
+				return push(Code::Month) && push(Code::Literal, '/') && push(Code::Day) && push(Code::Literal, '/') &&
+					push(Code::YearTwoDigits);
+			case 'T':
+				return push(Code::Hours) && push(Code::Literal, ':') && push(Code::Minutes) &&
+					push(Code::Literal, ':') && push(Code::Seconds);
+			case 'R':
+				return push(Code::Hours) && push(Code::Literal, ':') && push(Code::Minutes);
+			case 'X':
+				return push(Code::Hours) && push(Code::Literal, ':') && push(Code::Minutes) &&
+					push(Code::Literal, ':') && push(Code::WholeSeconds);
+			case 'r':
+				return push(Code::Hours12) && push(Code::Literal, ':') && push(Code::Minutes) &&
+					push(Code::Literal, ':') && push(Code::WholeSeconds) && push(Code::Literal, ' ') &&
+					push(Code::AmPm);
+			case 'c':
+				return push(Code::WeekdayAbbreviated) && push(Code::Literal, ' ') && push(Code::MonthAbbreviated) &&
+					push(Code::Literal, ' ') && push(Code::DaySpacePadded) && push(Code::Literal, ' ') &&
+					push(Code::Hours) && push(Code::Literal, ':') && push(Code::Minutes) &&
+					push(Code::Literal, ':') && push(Code::WholeSeconds) && push(Code::Literal, ' ') &&
+					push(Code::Year);
+
+			// ---- Characters ----
+			case 'n':
+				return push(Code::Literal, '\n');
+			case 't':
+				return push(Code::Literal, '\t');
+			case '%':
+				return push(Code::Literal, '%');
+
+			default:
+				return false;
+		}
+	}
+
+	constexpr bool DateTimePattern::assign(std::string_view pattern) noexcept
+	{
+		m_count = 0;
+		m_width = 0;
+		m_maxLength = 0;
+		m_fill = ' ';
+		m_align = Align::Left;
+
+		auto fail = [this]()
+		{
+			assign("");
+			return false;
+		};
+
+		auto toAlign = [](char c, Align& align)
+		{
+			switch (c)
+			{
+				case '<':
+					align = Align::Left;
+					return true;
+				case '>':
+					align = Align::Right;
+					return true;
+				case '^':
+					align = Align::Center;
+					return true;
+				default:
+					return false;
+			}
+		};
+
+		std::size_t i = 0;
+		const std::size_t size = pattern.size();
+
+		// ---- [[fill]align] ----
+		if (size >= 2 && pattern[0] != '{' && pattern[0] != '}' && toAlign(pattern[1], m_align))
+		{
+			m_fill = pattern[0];
+			i = 2;
+		}
+		else if (size >= 1 && toAlign(pattern[0], m_align))
+		{
+			i = 1;
+		}
+
+		// ---- [width] ----
+		if (i < size && pattern[i] == '0')
+			return fail();
+
+		std::size_t width = 0;
+		while (i < size && pattern[i] >= '0' && pattern[i] <= '9')
+		{
+			width = width * 10 + static_cast<std::size_t>(pattern[i] - '0');
+			if (width > MaxFormattedLength)
+				return fail();
+			++i;
+		}
+
+		// ---- [L] (always "C" locale) ----
+		if (i < size && pattern[i] == 'L')
+			++i;
+
+		// ---- [chrono-specs] ----
+		if (i == size)
+		{
+			if (!pushSpecifier('F', '\0') || !push(Code::Literal, ' ') || !pushSpecifier('T', '\0'))
+				return fail();
+		}
+		else if (pattern[i] != '%')
+		{
+			return fail();
+		}
+
+		while (i < size)
+		{
+			const char c = pattern[i++];
+			if (c == '{' || c == '}')
+				return fail();
+
+			if (c != '%')
+			{
+				if (!push(Code::Literal, c))
+					return fail();
+				continue;
+			}
+
+			if (i == size)
+				return fail();
+
+			char modifier = '\0';
+			if (pattern[i] == 'E' || pattern[i] == 'O')
+			{
+				modifier = pattern[i++];
+				if (i == size)
+					return fail();
+			}
+
+			if (!pushSpecifier(pattern[i++], modifier))
+				return fail();
+		}
+
+		m_width = static_cast<uint16_t>(width);
+		m_maxLength = static_cast<uint16_t>(std::max<std::size_t>(m_maxLength, width));
+		return true;
+	}
+
+	template <typename OutputIt, DateTimePrecision Duration>
+	OutputIt DateTimePattern::formatTo(OutputIt out, const BasicDateTime<Duration>& dateTime) const
+	{
+		char buffer[MaxFormattedLength];
+		const std::to_chars_result result = formatTo(dateTime, buffer, buffer + sizeof(buffer));
+		return std::copy(buffer, result.ptr, out);
+	}
+
+} // namespace onion
+
+#ifdef ONION_HEADER_ONLY
+#include "DateTime.hpp"
+#endif
@@ -0,0 +1,145 @@
+#include "Encoding.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <stdexcept>
+
+#include "Config.hpp"
+#include "detail/Calendar.hpp"
+#include "detail/Varint.hpp"
+
+namespace onion::encoding
+{
+	namespace
+	{
+		constexpr int64_t MaxDelta = detail::MaxUnixMillis - detail::MinUnixMillis;
+
+		void checkSize(std::size_t available, std::size_t required)
+		{
+			if (available < required)
+				detail::raise(std::invalid_argument("encoding: output buffer is too small"));
+		}
+
+		[[noreturn]] void raiseMalformed()
+		{
+			detail::raise(std::invalid_argument("encoding: truncated or malformed varint"));
+		}
+	} // namespace
+
+	// ---- Sortable keys ----
+
+	ONION_INLINE void encodeKeys(std::span<const DateTime> dateTimes, std::span<std::byte> out)
+	{
+		checkSize(out.size() / KeySize, dateTimes.size());
+
+		const DateTime* __restrict in = dateTimes.data();
+		std::byte* __restrict keys = out.data();
+		for (std::size_t i = 0; i < dateTimes.size(); ++i)
+			detail::storeBigEndian64(keys + i * KeySize, std::bit_cast<uint64_t>(in[i]) ^ KeySignBit);
+	}
+
+	ONION_INLINE void decodeKeys(std::span<const std::byte> in, std::span<DateTime> out)
+	{
+		if (in.size() / KeySize < out.size())
+			detail::raise(std::invalid_argument("encoding: input is shorter than the output column"));
+
+		const std::byte* __restrict keys = in.data();
+		DateTime* __restrict dateTimes = out.data();
+		for (std::size_t i = 0; i < out.size(); ++i)
+		{
+			const auto unixMillis = static_cast<int64_t>(detail::loadBigEndian64(keys + i * KeySize) ^ KeySignBit);
+			if (unixMillis < detail::MinUnixMillis || unixMillis > detail::MaxUnixMillis)
+				detail::raise(std::out_of_range("encoding: key out of DateTime range"));
+			dateTimes[i] = std::bit_cast<DateTime>(unixMillis);
+		}
+	}
+
+	// ---- Varints ----
+
+	ONION_INLINE std::size_t encodeVarints(std::span<const TimeSpan> timeSpans, std::span<std::byte> out)
+	{
+		std::byte* it = out.data();
+		std::byte* const end = it + out.size();
+		for (const TimeSpan& timeSpan : timeSpans)
+		{
+			// Only the last MaxVarintSize bytes need an exact size check.
+			if (static_cast<std::size_t>(end - it) < MaxVarintSize)
+			{
+				std::byte buffer[MaxVarintSize];
+				const auto size = static_cast<std::size_t>(encodeVarint(timeSpan, buffer) - buffer);
+				checkSize(static_cast<std::size_t>(end - it), size);
+				it = std::copy(buffer, buffer + size, it);
+			}
+			else
+				it = encodeVarint(timeSpan, it);
+		}
+		return static_cast<std::size_t>(it - out.data());
+	}
+
+	ONION_INLINE std::size_t decodeVarints(std::span<const std::byte> in, std::span<TimeSpan> out)
+	{
+		const std::byte* it = in.data();
+		const std::byte* const end = it + in.size();
+		for (TimeSpan& timeSpan : out)
+		{
+			it = decodeVarint(it, end, timeSpan);
+			if (it == nullptr)
+				raiseMalformed();
+		}
+		return static_cast<std::size_t>(it - in.data());
+	}
+
+	// ---- Delta-encoded DateTime columns ----
+
+	ONION_INLINE std::size_t encodeDeltas(std::span<const DateTime> dateTimes, std::span<std::byte> out)
+	{
+		std::byte* it = out.data();
+		std::byte* const end = it + out.size();
+		int64_t previous = 0;
+		for (const DateTime& dateTime : dateTimes)
+		{
+			// Both values are within the DateTime range, so the difference cannot overflow.
+			const int64_t unixMillis = dateTime.toUnixMillis();
+			const uint64_t code = detail::zigzag(unixMillis - previous);
+			previous = unixMillis;
+
+			if (static_cast<std::size_t>(end - it) < MaxVarintSize)
+			{
+				std::byte buffer[MaxVarintSize];
+				const auto size = static_cast<std::size_t>(detail::writeVarint(buffer, code) - buffer);
+				checkSize(static_cast<std::size_t>(end - it), size);
+				it = std::copy(buffer, buffer + size, it);
+			}
+			else
+				it = detail::writeVarint(it, code);
+		}
+		return static_cast<std::size_t>(it - out.data());
+	}
+
+	ONION_INLINE std::size_t decodeDeltas(std::span<const std::byte> in, std::span<DateTime> out)
+	{
+		const std::byte* it = in.data();
+		const std::byte* const end = it + in.size();
+		DateTime* __restrict dateTimes = out.data();
+		int64_t unixMillis = 0;
+		for (std::size_t i = 0; i < out.size(); ++i)
+		{
+			uint64_t code;
+			it = detail::readVarint(it, end, code);
+			if (it == nullptr)
+				raiseMalformed();
+
+			// Deltas wider than the DateTime range are rejected before they can overflow the sum.
+			const int64_t delta = detail::unzigzag(code);
+			if (delta < -MaxDelta || delta > MaxDelta)
+				detail::raise(std::out_of_range("encoding: delta out of DateTime range"));
+			unixMillis += delta;
+			if (unixMillis < detail::MinUnixMillis || unixMillis > detail::MaxUnixMillis)
+				detail::raise(std::out_of_range("encoding: delta out of DateTime range"));
+			dateTimes[i] = std::bit_cast<DateTime>(unixMillis);
+		}
+		return static_cast<std::size_t>(it - in.data());
+	}
+
+} // namespace onion::encoding
@@ -0,0 +1,137 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <stdexcept>
+
+#include "Config.hpp"
+#include "DateTime.hpp"
+#include "TimeSpan.hpp"
+#include "detail/Calendar.hpp"
+#include "detail/Varint.hpp"
+
+namespace onion::encoding
+{
+	// ---- Sortable keys ----
+	// A key is the Unix millisecond count with its sign bit flipped, stored big-endian, so that comparing keys with
+	// memcmp orders them like the DateTimes they encode. It is fixed-size, exact, and independent of the host.
+
+	/// Number of bytes of a DateTime key.
+	constexpr std::size_t KeySize = 8;
+
+	/// Flipping the sign bit maps int64_t order onto unsigned order.
+	constexpr uint64_t KeySignBit = uint64_t{1} << 63;
+
+	/// Writes the 8-byte sortable key of a DateTime.
+	/// @return `out + KeySize`.
+	inline std::byte* encodeKey(const DateTime& dateTime, std::byte* out) noexcept;
+
+	/// Reads a DateTime from its 8-byte key.
+	/// @throws std::out_of_range If the key does not encode a DateTime in the supported range.
+	inline DateTime decodeKey(const std::byte* in);
+
+	/// Reads a DateTime from its 8-byte key without throwing.
+	/// @return The DateTime, or `std::nullopt` if the key does not encode a DateTime in the supported range.
+	inline std::optional<DateTime> tryDecodeKey(const std::byte* in) noexcept;
+
+	/// Writes the keys of a column of DateTimes back to back.
+	/// @throws std::invalid_argument If `out` is shorter than `KeySize * dateTimes.size()` bytes.
+	void encodeKeys(std::span<const DateTime> dateTimes, std::span<std::byte> out);
+
+	/// Reads a column of DateTimes from keys stored back to back.
+	/// @throws std::invalid_argument If `in` is shorter than `KeySize * out.size()` bytes.
+	/// @throws std::out_of_range If a key does not encode a DateTime in the supported range.
+	void decodeKeys(std::span<const std::byte> in, std::span<DateTime> out);
+
+	// ---- Varints ----
+	// Signed values are zigzag-mapped (0, -1, 1, -2, ... to 0, 1, 2, 3, ...) and written as LEB128: 7 bits per
+	// byte, least significant group first, with the high bit set on every byte but the last. Small magnitudes
+	// take few bytes whatever their sign, e.g. a TimeSpan of 1 ms takes 3 bytes and a DateTime delta of 1 s takes 2.
+
+	/// Maximum number of bytes of a varint.
+	constexpr std::size_t MaxVarintSize = 10;
+
+	/// Writes a TimeSpan as a varint of its nanoseconds.
+	/// @param out Destination, with room for at least `MaxVarintSize` bytes.
+	/// @return The end of the written bytes.
+	inline std::byte* encodeVarint(const TimeSpan& timeSpan, std::byte* out) noexcept;
+
+	/// Reads a TimeSpan varint from [first, last).
+	/// @return The end of the read bytes, or `nullptr` if the varint is truncated or malformed.
+	inline const std::byte* decodeVarint(const std::byte* first, const std::byte* last, TimeSpan& timeSpan) noexcept;
+
+	/// Writes a column of TimeSpans as varints.
+	/// @return The number of bytes written.
+	/// @throws std::invalid_argument If `out` is too small. `MaxVarintSize * timeSpans.size()` bytes always suffice.
+	std::size_t encodeVarints(std::span<const TimeSpan> timeSpans, std::span<std::byte> out);
+
+	/// Reads `out.size()` TimeSpan varints.
+	/// @return The number of bytes read.
+	/// @throws std::invalid_argument If `in` is truncated or malformed.
+	std::size_t decodeVarints(std::span<const std::byte> in, std::span<TimeSpan> out);
+
+	// ---- Delta-encoded DateTime columns ----
+	// The first DateTime is written as the varint of its Unix milliseconds, and each following one as the varint of
+	// the milliseconds elapsed since the previous one, so that sorted or clustered timestamps take 1 to 3 bytes.
+
+	/// Number of bytes that always suffices for `count` delta-encoded DateTimes.
+	constexpr std::size_t maxDeltasSize(std::size_t count) noexcept { return count * MaxVarintSize; }
+
+	/// Writes a column of DateTimes as varint deltas.
+	/// @return The number of bytes written.
+	/// @throws std::invalid_argument If `out` is too small. `maxDeltasSize(dateTimes.size())` bytes always suffice.
+	std::size_t encodeDeltas(std::span<const DateTime> dateTimes, std::span<std::byte> out);
+
+	/// Reads `out.size()` delta-encoded DateTimes.
+	/// @return The number of bytes read.
+	/// @throws std::invalid_argument If `in` is truncated or malformed.
+	/// @throws std::out_of_range If a value is outside the DateTime range.
+	std::size_t decodeDeltas(std::span<const std::byte> in, std::span<DateTime> out);
+
+	// ----- Inline Implementations -----
+
+	inline std::byte* encodeKey(const DateTime& dateTime, std::byte* out) noexcept
+	{
+		detail::storeBigEndian64(out, static_cast<uint64_t>(dateTime.toUnixMillis()) ^ KeySignBit);
+		return out + KeySize;
+	}
+
+	inline std::optional<DateTime> tryDecodeKey(const std::byte* in) noexcept
+	{
+		const auto unixMillis = static_cast<int64_t>(detail::loadBigEndian64(in) ^ KeySignBit);
+		if (unixMillis < detail::MinUnixMillis || unixMillis > detail::MaxUnixMillis)
+			return std::nullopt;
+
+		return DateTime::FromUnixMillis(unixMillis);
+	}
+
+	inline DateTime decodeKey(const std::byte* in)
+	{
+		const auto dateTime = tryDecodeKey(in);
+		if (!dateTime)
+			detail::raise(std::out_of_range("encoding: key out of DateTime range"));
+
+		return *dateTime;
+	}
+
+	inline std::byte* encodeVarint(const TimeSpan& timeSpan, std::byte* out) noexcept
+	{
+		return detail::writeVarint(out, detail::zigzag(timeSpan.TotalNanoseconds()));
+	}
+
+	inline const std::byte* decodeVarint(const std::byte* first, const std::byte* last, TimeSpan& timeSpan) noexcept
+	{
+		uint64_t value = 0;
+		const std::byte* end = detail::readVarint(first, last, value);
+		if (end != nullptr)
+			timeSpan = TimeSpan::FromNanoseconds(detail::unzigzag(value));
+		return end;
+	}
+
+} // namespace onion::encoding
+
+#ifdef ONION_HEADER_ONLY
+#include "Encoding.cpp"
+#endif
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <stdexcept>
+#include <type_traits>
+
+#include "Config.hpp"
+
+namespace onion
+{
+	/// Wraps an error to construct a failed `Expected`, in the manner of C++23 `std::unexpected`.
+	template <typename E> class Unexpected
+	{
+	  public:
+		constexpr explicit Unexpected(const E& error) noexcept : m_error(error) {}
+
+		constexpr const E& error() const noexcept { return m_error; }
+
+	  private:
+		E m_error;
+	};
+
+	/// Holds either a value or an error, a small subset of C++23 `std::expected` for trivially copyable types.
+	///
+	/// Example:
+	///   auto result = DateTime::TryCreate(2024, 2, 30, 0, 0, 0);
+	///   if (!result)
+	///       log(toString(result.error())); // "invalid calendar date"
+	template <typename T, typename E> class Expected
+	{
+		static_assert(std::is_trivially_copyable_v<T> && std::is_trivially_copyable_v<E>,
+					  "Expected only supports trivially copyable value and error types");
+
+	  public:
+		constexpr Expected(const T& value) noexcept : m_value(value), m_hasValue(true) {}
+		constexpr Expected(const Unexpected<E>& unexpected) noexcept : m_error(unexpected.error()), m_hasValue(false)
+		{
+		}
+
+		/// Returns true if this holds a value.
+		constexpr bool hasValue() const noexcept { return m_hasValue; }
+		constexpr explicit operator bool() const noexcept { return m_hasValue; }
+
+		/// Returns the value.
+		/// @throws std::logic_error If this holds an error.
+		constexpr const T& value() const
+		{
+			if (!m_hasValue)
+				detail::raise(std::logic_error("Expected::value() called on an error"));
+			return m_value;
+		}
+
+		/// Returns the value, or `fallback` if this holds an error.
+		constexpr T valueOr(const T& fallback) const noexcept { return m_hasValue ? m_value : fallback; }
+
+		/// Returns the value. This must hold a value.
+		constexpr const T& operator*() const noexcept { return m_value; }
+		constexpr const T* operator->() const noexcept { return &m_value; }
+
+		/// Returns the error. This must hold an error.
+		constexpr const E& error() const noexcept { return m_error; }
+
+	  private:
+		union
+		{
+			T m_value;
+			E m_error;
+		};
+		bool m_hasValue;
+	};
+
+} // namespace onion
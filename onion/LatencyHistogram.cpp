@@ -0,0 +1,202 @@
+#include "LatencyHistogram.hpp"
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+
+#include "Config.hpp"
+#include "Encoding.hpp"
+#include "detail/Varint.hpp"
+
+namespace onion
+{
+	namespace
+	{
+		[[noreturn]] void raiseMalformed()
+		{
+			detail::raise(std::invalid_argument("LatencyHistogram: truncated or malformed snapshot"));
+		}
+
+		const std::byte* readField(const std::byte* first, const std::byte* last, uint64_t& value)
+		{
+			first = detail::readVarint(first, last, value);
+			if (!first)
+				raiseMalformed();
+			return first;
+		}
+	} // namespace
+
+	// ---- Snapshot ----
+
+	ONION_INLINE LatencyHistogram::Snapshot::Snapshot() : m_counts(BucketCount) {}
+
+	ONION_INLINE void LatencyHistogram::Snapshot::record(const TimeSpan& latency) noexcept
+	{
+		const int64_t nanoseconds = latency.TotalNanoseconds();
+		const auto value = static_cast<uint64_t>(nanoseconds > 0 ? nanoseconds : 0);
+		++m_counts[BucketIndex(value)];
+		++m_count;
+		m_sum += value;
+	}
+
+	ONION_INLINE LatencyHistogram::Snapshot& LatencyHistogram::Snapshot::operator+=(const Snapshot& other) noexcept
+	{
+		for (std::size_t i = 0; i < BucketCount; ++i)
+			m_counts[i] += other.m_counts[i];
+		m_count += other.m_count;
+		m_sum += other.m_sum;
+		return *this;
+	}
+
+	ONION_INLINE LatencyHistogram::Snapshot& LatencyHistogram::Snapshot::operator-=(const Snapshot& earlier) noexcept
+	{
+		for (std::size_t i = 0; i < BucketCount; ++i)
+			m_counts[i] -= earlier.m_counts[i];
+		m_count -= earlier.m_count;
+		m_sum -= earlier.m_sum;
+		return *this;
+	}
+
+	ONION_INLINE TimeSpan LatencyHistogram::Snapshot::mean() const noexcept
+	{
+		if (m_count == 0)
+			return TimeSpan::Zero();
+		return TimeSpan::FromNanoseconds(static_cast<int64_t>(m_sum / m_count));
+	}
+
+	ONION_INLINE TimeSpan LatencyHistogram::Snapshot::percentile(double percent) const
+	{
+		if (!(percent >= 0 && percent <= 100))
+			detail::raise(std::invalid_argument("LatencyHistogram: percentile must be within [0, 100]"));
+		if (m_count == 0)
+			return TimeSpan::Zero();
+
+		// The rank of the latency, from 1: the smallest one at 0%, the largest one at 100%.
+		const auto rank = static_cast<uint64_t>(std::ceil(percent / 100 * static_cast<double>(m_count)));
+		const uint64_t target = rank < 1 ? 1 : (rank > m_count ? m_count : rank);
+
+		uint64_t seen = 0;
+		for (std::size_t i = 0; i < BucketCount; ++i)
+		{
+			seen += m_counts[i];
+			if (seen >= target)
+				return TimeSpan::FromNanoseconds(static_cast<int64_t>(BucketHighest(i)));
+		}
+		return max();
+	}
+
+	ONION_INLINE TimeSpan LatencyHistogram::Snapshot::min() const noexcept
+	{
+		for (std::size_t i = 0; i < BucketCount; ++i)
+		{
+			if (m_counts[i] != 0)
+				return TimeSpan::FromNanoseconds(static_cast<int64_t>(BucketLowest(i)));
+		}
+		return TimeSpan::Zero();
+	}
+
+	ONION_INLINE TimeSpan LatencyHistogram::Snapshot::max() const noexcept
+	{
+		for (std::size_t i = BucketCount; i-- > 0;)
+		{
+			if (m_counts[i] != 0)
+				return TimeSpan::FromNanoseconds(static_cast<int64_t>(BucketHighest(i)));
+		}
+		return TimeSpan::Zero();
+	}
+
+	// Layout: the sum, the number of non-empty buckets, then for each of them the number of empty buckets before
+	// it (since the previous one) and its count. The total count is the sum of the bucket counts.
+	ONION_INLINE std::vector<std::byte> LatencyHistogram::Snapshot::encode() const
+	{
+		uint64_t buckets = 0;
+		for (const uint64_t count : m_counts)
+			buckets += count != 0;
+
+		std::vector<std::byte> bytes((2 + 2 * buckets) * encoding::MaxVarintSize);
+		std::byte* out = detail::writeVarint(bytes.data(), m_sum);
+		out = detail::writeVarint(out, buckets);
+
+		std::size_t next = 0;
+		for (std::size_t i = 0; i < BucketCount; ++i)
+		{
+			if (m_counts[i] == 0)
+				continue;
+			out = detail::writeVarint(out, i - next);
+			out = detail::writeVarint(out, m_counts[i]);
+			next = i + 1;
+		}
+
+		bytes.resize(static_cast<std::size_t>(out - bytes.data()));
+		return bytes;
+	}
+
+	ONION_INLINE LatencyHistogram::Snapshot LatencyHistogram::Snapshot::Decode(std::span<const std::byte> bytes)
+	{
+		const std::byte* in = bytes.data();
+		const std::byte* const end = in + bytes.size();
+
+		Snapshot snapshot;
+		uint64_t buckets = 0;
+		in = readField(in, end, snapshot.m_sum);
+		in = readField(in, end, buckets);
+		if (buckets > BucketCount)
+			raiseMalformed();
+
+		std::size_t next = 0;
+		for (uint64_t bucket = 0; bucket < buckets; ++bucket)
+		{
+			uint64_t gap = 0;
+			uint64_t count = 0;
+			in = readField(in, end, gap);
+			in = readField(in, end, count);
+			if (gap >= BucketCount - next || count == 0)
+				raiseMalformed();
+
+			next += static_cast<std::size_t>(gap);
+			snapshot.m_counts[next++] = count;
+			snapshot.m_count += count;
+		}
+
+		if (in != end)
+			raiseMalformed();
+		return snapshot;
+	}
+
+	// ---- LatencyHistogram ----
+
+	ONION_INLINE LatencyHistogram::LatencyHistogram(std::size_t recorders)
+	{
+		if (recorders == 0)
+			detail::raise(std::invalid_argument("LatencyHistogram: at least one recorder is required"));
+
+		m_recorders.reserve(recorders);
+		for (std::size_t i = 0; i < recorders; ++i)
+			m_recorders.push_back(Recorder());
+	}
+
+	ONION_INLINE LatencyHistogram::Recorder& LatencyHistogram::recorder(std::size_t index)
+	{
+		if (index >= m_recorders.size())
+			detail::raise(std::out_of_range("LatencyHistogram: recorder index out of range"));
+		return m_recorders[index];
+	}
+
+	ONION_INLINE LatencyHistogram::Snapshot LatencyHistogram::snapshot() const
+	{
+		Snapshot result;
+		for (const Recorder& source : m_recorders)
+		{
+			for (std::size_t i = 0; i < BucketCount; ++i)
+			{
+				const uint64_t count = source.m_counters[i].load(std::memory_order_relaxed);
+				result.m_counts[i] += count;
+				result.m_count += count;
+			}
+			result.m_sum += source.m_counters[BucketCount].load(std::memory_order_relaxed);
+		}
+		return result;
+	}
+
+} // namespace onion
@@ -0,0 +1,276 @@
+#include "LogScanner.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <functional>
+#include <system_error>
+#include <thread>
+#include <utility>
+
+#include "Config.hpp"
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace onion
+{
+	namespace
+	{
+		/// Longest prefix of a line searched for a timestamp.
+		constexpr std::size_t MaxTimestampLength = 64;
+
+		/// Minimum number of bytes per thread.
+		constexpr std::size_t MinThreadBytes = std::size_t{1} << 20;
+
+		/// Chunks per thread, so that threads finishing early take over the remaining work.
+		constexpr std::size_t ChunksPerThread = 4;
+
+		inline bool isDigit(char c) noexcept
+		{
+			return c >= '0' && c <= '9';
+		}
+
+		/// Returns true for the characters that end a timestamp.
+		inline bool isDelimiter(char c) noexcept
+		{
+			return c == ' ' || c == '\t' || c == ']' || c == '\r';
+		}
+
+		/// Returns the position of the first delimiter from `position`, or the size of the text.
+		/// A plain loop: `std::string_view::find_first_of` costs more than the parsing itself.
+		std::size_t timestampEnd(std::string_view text, std::size_t position) noexcept
+		{
+			while (position < text.size() && !isDelimiter(text[position]))
+				++position;
+			return position;
+		}
+
+		/// Timestamps and line count of the lines starting in one chunk.
+		struct ChunkScan
+		{
+			std::vector<LogTimestamp> timestamps;
+			uint64_t lines = 0;
+		};
+
+		/// Returns the start of the first line beginning at or after `position`.
+		std::size_t lineStart(std::string_view text, std::size_t position) noexcept
+		{
+			if (position == 0 || position >= text.size())
+				return std::min(position, text.size());
+			const void* newline = std::memchr(text.data() + position - 1, '\n', text.size() - position + 1);
+			return newline ? static_cast<std::size_t>(static_cast<const char*>(newline) - text.data()) + 1
+						   : text.size();
+		}
+
+		void scanLines(std::string_view text, std::size_t begin, std::size_t end, ChunkScan& out)
+		{
+			std::size_t position = begin;
+			while (position < end)
+			{
+				const void* newline = std::memchr(text.data() + position, '\n', text.size() - position);
+				const std::size_t lineEnd =
+					newline ? static_cast<std::size_t>(static_cast<const char*>(newline) - text.data()) : text.size();
+
+				if (const auto time = parseLineTimestamp(text.substr(position, lineEnd - position)))
+					out.timestamps.push_back({position, *time});
+				++out.lines;
+				position = lineEnd + 1;
+			}
+		}
+
+		/// Scans chunks until none is left; run by every thread.
+		void scanChunks(std::string_view text, std::vector<ChunkScan>& chunks, std::atomic<std::size_t>& next)
+		{
+			for (std::size_t chunk = next++; chunk < chunks.size(); chunk = next++)
+			{
+				const std::size_t begin = lineStart(text, text.size() * chunk / chunks.size());
+				const std::size_t end = lineStart(text, text.size() * (chunk + 1) / chunks.size());
+				scanLines(text, begin, end, chunks[chunk]);
+			}
+		}
+	} // namespace
+
+	// ---- MappedFile ----
+
+#ifdef _WIN32
+	ONION_INLINE MappedFile::MappedFile(const std::string& path)
+	{
+		const HANDLE file = CreateFileA(
+			path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+		if (file == INVALID_HANDLE_VALUE)
+			detail::raise(std::system_error(
+				static_cast<int>(GetLastError()), std::system_category(), "MappedFile: cannot open " + path));
+
+		LARGE_INTEGER size{};
+		if (!GetFileSizeEx(file, &size))
+		{
+			const auto error = static_cast<int>(GetLastError());
+			CloseHandle(file);
+			detail::raise(
+				std::system_error(error, std::system_category(), "MappedFile: cannot read the size of " + path));
+		}
+		if (size.QuadPart == 0)
+		{
+			CloseHandle(file);
+			return;
+		}
+
+		const HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		const void* view = mapping ? MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0) : nullptr;
+		const auto error = static_cast<int>(GetLastError());
+		if (mapping)
+			CloseHandle(mapping);
+		CloseHandle(file);
+		if (!view)
+			detail::raise(std::system_error(error, std::system_category(), "MappedFile: cannot map " + path));
+
+		m_data = static_cast<const char*>(view);
+		m_size = static_cast<std::size_t>(size.QuadPart);
+	}
+
+	ONION_INLINE void MappedFile::unmap() noexcept
+	{
+		if (m_data)
+			UnmapViewOfFile(m_data);
+	}
+#else
+	ONION_INLINE MappedFile::MappedFile(const std::string& path)
+	{
+		const int file = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+		if (file < 0)
+			detail::raise(std::system_error(errno, std::generic_category(), "MappedFile: cannot open " + path));
+
+		struct stat status{};
+		if (::fstat(file, &status) != 0)
+		{
+			const int error = errno;
+			::close(file);
+			detail::raise(
+				std::system_error(error, std::generic_category(), "MappedFile: cannot read the size of " + path));
+		}
+		if (status.st_size == 0)
+		{
+			::close(file);
+			return;
+		}
+
+		const auto size = static_cast<std::size_t>(status.st_size);
+		void* view = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, file, 0);
+		const int error = errno;
+		::close(file); // the mapping keeps the file open
+		if (view == MAP_FAILED)
+			detail::raise(std::system_error(error, std::generic_category(), "MappedFile: cannot map " + path));
+
+		::madvise(view, size, MADV_SEQUENTIAL);
+		m_data = static_cast<const char*>(view);
+		m_size = size;
+	}
+
+	ONION_INLINE void MappedFile::unmap() noexcept
+	{
+		if (m_data)
+			::munmap(const_cast<char*>(m_data), m_size);
+	}
+#endif
+
+	ONION_INLINE MappedFile::MappedFile(MappedFile&& other) noexcept
+		: m_data(std::exchange(other.m_data, nullptr)), m_size(std::exchange(other.m_size, 0))
+	{
+	}
+
+	ONION_INLINE MappedFile& MappedFile::operator=(MappedFile&& other) noexcept
+	{
+		if (this != &other)
+		{
+			unmap();
+			m_data = std::exchange(other.m_data, nullptr);
+			m_size = std::exchange(other.m_size, 0);
+		}
+		return *this;
+	}
+
+	ONION_INLINE MappedFile::~MappedFile()
+	{
+		unmap();
+	}
+
+	// ---- Scanning ----
+
+	ONION_INLINE std::optional<DateTime> parseLineTimestamp(std::string_view line) noexcept
+	{
+		if (!line.empty() && line.front() == '[')
+			line.remove_prefix(1);
+		line = line.substr(0, MaxTimestampLength);
+		if (line.empty() || !isDigit(line.front()))
+			return std::nullopt;
+
+		// A date alone is 10 characters; a space after it separates the time.
+		// Fast path for the `toString()` layout.
+		constexpr std::size_t IsoLength = DateTime::IsoStringLength;
+		if (line.size() >= IsoLength && line[IsoLength - 1] == 'Z' &&
+			(line.size() == IsoLength || isDelimiter(line[IsoLength])))
+		{
+			if (const auto time = DateTime::TryParse(line.substr(0, IsoLength)))
+				return time;
+		}
+
+		std::size_t end = timestampEnd(line, 0);
+		if (end == 10 && end + 1 < line.size() && line[end] == ' ' && isDigit(line[end + 1]))
+			end = timestampEnd(line, end + 1);
+
+		return DateTime::TryParse(line.substr(0, end));
+	}
+
+	ONION_INLINE LogScan scanLogTimestamps(std::string_view text, unsigned threads)
+	{
+		if (threads == 0)
+			threads = std::max(1u, std::thread::hardware_concurrency());
+		threads = static_cast<unsigned>(std::clamp<std::size_t>(text.size() / MinThreadBytes, 1, threads));
+
+		const std::size_t chunkCount = threads == 1 ? 1 : threads * ChunksPerThread;
+		std::vector<ChunkScan> chunks(chunkCount);
+		std::atomic<std::size_t> next{0};
+
+		std::vector<std::thread> workers;
+		workers.reserve(threads - 1);
+		for (unsigned thread = 1; thread < threads; ++thread)
+			workers.emplace_back(scanChunks, text, std::ref(chunks), std::ref(next));
+		scanChunks(text, chunks, next);
+		for (std::thread& worker : workers)
+			worker.join();
+
+		LogScan result;
+		result.bytes = text.size();
+		std::size_t total = 0;
+		for (const ChunkScan& chunk : chunks)
+			total += chunk.timestamps.size();
+		result.timestamps.reserve(total);
+		for (const ChunkScan& chunk : chunks)
+		{
+			result.timestamps.insert(result.timestamps.end(), chunk.timestamps.begin(), chunk.timestamps.end());
+			result.lines += chunk.lines;
+		}
+		return result;
+	}
+
+	ONION_INLINE LogScan scanLogFile(const std::string& path, unsigned threads)
+	{
+		const MappedFile file(path);
+		return scanLogTimestamps(file.contents(), threads);
+	}
+
+} // namespace onion
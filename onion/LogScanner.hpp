@@ -0,0 +1,78 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "Config.hpp"
+#include "DateTime.hpp"
+
+namespace onion
+{
+	/// The timestamp of a log line and the byte offset at which the line starts.
+	struct LogTimestamp
+	{
+		uint64_t offset;
+		DateTime time;
+	};
+
+	/// Result of `scanLogTimestamps` and `scanLogFile`.
+	struct LogScan
+	{
+		std::vector<LogTimestamp> timestamps; // in file order
+		uint64_t lines = 0;					  // including those without a timestamp
+		uint64_t bytes = 0;
+	};
+
+	/// A read-only memory mapping of a whole file.
+	class MappedFile
+	{
+	  public:
+		/// Maps the file at `path`. An empty file is not mapped, and has empty contents.
+		/// @throws std::system_error If the file cannot be opened or mapped.
+		explicit MappedFile(const std::string& path);
+
+		MappedFile(MappedFile&& other) noexcept;
+		MappedFile& operator=(MappedFile&& other) noexcept;
+		MappedFile(const MappedFile&) = delete;
+		MappedFile& operator=(const MappedFile&) = delete;
+		~MappedFile();
+
+		/// Returns the contents of the file.
+		std::string_view contents() const noexcept { return {m_data, m_size}; }
+
+	  private:
+		void unmap() noexcept;
+
+	  private:
+		const char* m_data = nullptr;
+		std::size_t m_size = 0;
+	};
+
+	/// Parses the timestamp at the start of a log line, e.g. "2024-06-15T12:30:45.500Z GET /index.html" or
+	/// "[2024-06-15 12:30:45,500] INFO ...".
+	///
+	/// The timestamp is any ISO 8601 form accepted by `DateTime::TryParse`, optionally after a '['. It ends at the
+	/// first space, tab, ']' or carriage return, except for the space between a date and a time.
+	/// @return The timestamp, or `std::nullopt` if the line does not start with one.
+	std::optional<DateTime> parseLineTimestamp(std::string_view line) noexcept;
+
+	/// Extracts the leading timestamp of every line of a text, without copying the lines.
+	///
+	/// The text is split into newline-aligned chunks that `threads` threads parse concurrently (all the hardware
+	/// threads if 0); each thread is given at least 1 MiB. Lines without a timestamp, such as the continuation lines
+	/// of a stack trace, are counted but produce no entry.
+	LogScan scanLogTimestamps(std::string_view text, unsigned threads = 0);
+
+	/// Maps the file at `path` and scans it with `scanLogTimestamps`.
+	/// @throws std::system_error If the file cannot be opened or mapped.
+	LogScan scanLogFile(const std::string& path, unsigned threads = 0);
+
+} // namespace onion
+
+#ifdef ONION_HEADER_ONLY
+#include "LogScanner.cpp"
+#endif
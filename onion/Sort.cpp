@@ -0,0 +1,270 @@
+#include "Sort.hpp"
+
+#include <algorithm>
+#include <array>
+#include <barrier>
+#include <bit>
+#include <cstddef>
+#include <stdexcept>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "Config.hpp"
+
+namespace onion
+{
+	namespace
+	{
+		constexpr unsigned DigitBits = 8;
+		constexpr std::size_t DigitValues = std::size_t{1} << DigitBits;
+		constexpr uint64_t DigitMask = DigitValues - 1;
+		constexpr unsigned MaxPasses = 64 / DigitBits;
+
+		/// Below this size, a comparison sort is faster than the radix passes.
+		constexpr std::size_t SmallSize = 256;
+
+		/// Minimum number of values per thread.
+		constexpr std::size_t MinThreadSize = std::size_t{1} << 16;
+
+		using Histogram = std::array<std::size_t, DigitValues>;
+
+		inline int64_t keyOf(const DateTime& dateTime) noexcept
+		{
+			return dateTime.toUnixMillis();
+		}
+
+		inline int64_t keyOf(int64_t unixMillis) noexcept
+		{
+			return unixMillis;
+		}
+
+		unsigned threadCount(unsigned requested, std::size_t size) noexcept
+		{
+			if (requested == 0)
+				requested = std::max(1u, std::thread::hardware_concurrency());
+			return static_cast<unsigned>(std::clamp<std::size_t>(size / MinThreadSize, 1, requested));
+		}
+
+		/// LSD radix sort of `Key`s (DateTimes or Unix milliseconds), moving `indexes` along if `WithIndexes`.
+		///
+		/// Every thread runs `work` on its slice. The few decisions shared between threads (range, passes, offsets)
+		/// are computed redundantly by each thread from the per-slice results, so the only synchronization is one
+		/// barrier after each phase.
+		template <typename Key, bool WithIndexes> class RadixSorter
+		{
+		  public:
+			RadixSorter(std::span<Key> keys, std::span<std::size_t> indexes, unsigned threads)
+				: m_size(keys.size()), m_threads(threads), m_barrier(threads), m_slices(threads),
+				  m_keyBuffer(keys.begin(), keys.end())
+			{
+				m_keys = {keys.data(), m_keyBuffer.data()};
+				if constexpr (WithIndexes)
+				{
+					m_indexBuffer.resize(keys.size());
+					m_indexes = {indexes.data(), m_indexBuffer.data()};
+				}
+			}
+
+			void sort()
+			{
+				std::vector<std::thread> workers;
+				workers.reserve(m_threads - 1);
+				for (unsigned thread = 1; thread < m_threads; ++thread)
+					workers.emplace_back(&RadixSorter::work, this, thread);
+				work(0);
+				for (std::thread& worker : workers)
+					worker.join();
+			}
+
+		  private:
+			/// Results of one thread, read by the others after a barrier.
+			struct Slice
+			{
+				int64_t min = 0;
+				int64_t max = 0;
+				std::array<Histogram, MaxPasses> counts{};
+			};
+
+			void sync()
+			{
+				if (m_threads > 1)
+					m_barrier.arrive_and_wait();
+			}
+
+			void work(unsigned thread)
+			{
+				const std::size_t begin = m_size * thread / m_threads;
+				const std::size_t end = m_size * (thread + 1) / m_threads;
+				Slice& slice = m_slices[thread];
+
+				// Range of the keys: only the bytes of (key - min) that can differ are sorted.
+				const auto [sliceMin, sliceMax] = std::minmax_element(
+					m_keys[0] + begin, m_keys[0] + end, [](const Key& a, const Key& b) { return keyOf(a) < keyOf(b); });
+				slice.min = keyOf(*sliceMin);
+				slice.max = keyOf(*sliceMax);
+				sync();
+
+				int64_t min = slice.min;
+				int64_t max = slice.max;
+				for (const Slice& other : m_slices)
+				{
+					min = std::min(min, other.min);
+					max = std::max(max, other.max);
+				}
+				const auto base = static_cast<uint64_t>(min);
+				const auto passCount = static_cast<unsigned>(
+					(std::bit_width(static_cast<uint64_t>(max) - base) + DigitBits - 1) / DigitBits);
+
+				// Histograms of every pass in a single read. A pass whose digit is the same for every key is skipped.
+				count(slice, m_keys[0], begin, end, base, 0, passCount);
+				sync();
+
+				std::array<unsigned, MaxPasses> passes{};
+				unsigned activeCount = 0;
+				for (unsigned pass = 0; pass < passCount; ++pass)
+				{
+					bool constant = false;
+					for (std::size_t digit = 0; digit < DigitValues && !constant; ++digit)
+					{
+						std::size_t total = 0;
+						for (const Slice& other : m_slices)
+							total += other.counts[pass][digit];
+						constant = total == m_size;
+					}
+					if (!constant)
+						passes[activeCount++] = pass;
+				}
+
+				for (unsigned step = 0; step < activeCount; ++step)
+				{
+					const unsigned pass = passes[step];
+					const unsigned source = step % 2;
+					if (step != 0 && m_threads > 1)
+					{
+						// The previous pass moved keys between slices.
+						count(slice, m_keys[source], begin, end, base, pass, pass + 1);
+						sync();
+					}
+
+					// Each thread writes its keys of a digit after those of the same digit in earlier slices.
+					Histogram offsets;
+					std::size_t position = 0;
+					for (std::size_t digit = 0; digit < DigitValues; ++digit)
+					{
+						for (unsigned other = 0; other < m_threads; ++other)
+						{
+							if (other == thread)
+								offsets[digit] = position;
+							position += m_slices[other].counts[pass][digit];
+						}
+					}
+
+					scatter(offsets, begin, end, base, pass * DigitBits, source);
+					sync();
+				}
+
+				if (activeCount % 2 == 1)
+				{
+					std::copy(m_keys[1] + begin, m_keys[1] + end, m_keys[0] + begin);
+					if constexpr (WithIndexes)
+						std::copy(m_indexes[1] + begin, m_indexes[1] + end, m_indexes[0] + begin);
+				}
+			}
+
+			/// Counts the digits of passes [firstPass, lastPass) in the slice.
+			void count(Slice& slice,
+					   const Key* __restrict keys,
+					   std::size_t begin,
+					   std::size_t end,
+					   uint64_t base,
+					   unsigned firstPass,
+					   unsigned lastPass) noexcept
+			{
+				for (unsigned pass = firstPass; pass < lastPass; ++pass)
+					slice.counts[pass].fill(0);
+
+				for (std::size_t i = begin; i < end; ++i)
+				{
+					const uint64_t value = static_cast<uint64_t>(keyOf(keys[i])) - base;
+					for (unsigned pass = firstPass; pass < lastPass; ++pass)
+						++slice.counts[pass][value >> (pass * DigitBits) & DigitMask];
+				}
+			}
+
+			void scatter(Histogram& offsets,
+						 std::size_t begin,
+						 std::size_t end,
+						 uint64_t base,
+						 unsigned shift,
+						 unsigned source) noexcept
+			{
+				const Key* __restrict from = m_keys[source];
+				Key* __restrict to = m_keys[1 - source];
+				for (std::size_t i = begin; i < end; ++i)
+				{
+					const uint64_t value = static_cast<uint64_t>(keyOf(from[i])) - base;
+					const std::size_t position = offsets[value >> shift & DigitMask]++;
+					to[position] = from[i];
+					if constexpr (WithIndexes)
+						m_indexes[1 - source][position] = m_indexes[source][i];
+				}
+			}
+
+		  private:
+			std::size_t m_size;
+			unsigned m_threads;
+			std::barrier<> m_barrier;
+			std::vector<Slice> m_slices;
+
+			std::array<Key*, 2> m_keys{};
+			std::array<std::size_t*, 2> m_indexes{};
+			std::vector<Key> m_keyBuffer;
+			std::vector<std::size_t> m_indexBuffer;
+		};
+
+		template <typename Key> void sortKeys(std::span<Key> keys, std::span<std::size_t> indexes, unsigned threads)
+		{
+			const auto less = [](const Key& a, const Key& b) { return keyOf(a) < keyOf(b); };
+			if (indexes.empty())
+			{
+				if (keys.size() < SmallSize)
+					std::sort(keys.begin(), keys.end(), less);
+				else
+					RadixSorter<Key, false>(keys, indexes, threadCount(threads, keys.size())).sort();
+			}
+			else
+			{
+				if (indexes.size() != keys.size())
+					detail::raise(std::invalid_argument("sortByTime: indexes and keys differ in size"));
+
+				if (keys.size() < SmallSize)
+				{
+					std::vector<std::pair<Key, std::size_t>> pairs;
+					pairs.reserve(keys.size());
+					for (std::size_t i = 0; i < keys.size(); ++i)
+						pairs.emplace_back(keys[i], indexes[i]);
+					std::stable_sort(pairs.begin(),
+									 pairs.end(),
+									 [&less](const auto& a, const auto& b) { return less(a.first, b.first); });
+					for (std::size_t i = 0; i < keys.size(); ++i)
+						std::tie(keys[i], indexes[i]) = pairs[i];
+				}
+				else
+					RadixSorter<Key, true>(keys, indexes, threadCount(threads, keys.size())).sort();
+			}
+		}
+	} // namespace
+
+	ONION_INLINE void detail::radixSortByKey(std::span<int64_t> keys, std::span<std::size_t> indexes, unsigned threads)
+	{
+		sortKeys(keys, indexes, threads);
+	}
+
+	ONION_INLINE void sortByTime(std::span<DateTime> dateTimes, unsigned threads)
+	{
+		sortKeys(dateTimes, {}, threads);
+	}
+
+} // namespace onion
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <algorithm>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <span>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "Config.hpp"
+#include "DateTime.hpp"
+
+namespace onion
+{
+	namespace detail
+	{
+		/// Sorts `keys` (Unix milliseconds) in ascending order, stably, applying the same moves to `indexes` if it is
+		/// not empty. `indexes` must then be as long as `keys`.
+		void radixSortByKey(std::span<int64_t> keys, std::span<std::size_t> indexes, unsigned threads);
+	} // namespace detail
+
+	// ---- Radix sort ----
+	// DateTimes are sorted by their 64-bit tick count with a least-significant-digit radix sort: one pass per byte,
+	// each a counting scatter into a second buffer, so the cost is linear in the size and does not depend on the
+	// order of the input. Only the bytes that differ within [min, max] are sorted, and a pass is skipped when every
+	// value has the same digit: a batch of events within a day takes 4 passes, not 8.
+	//
+	// With several threads, each pass is partitioned: every thread counts, then scatters, its own slice of the
+	// input to the offsets reserved for it. Threads are only used for at least 65536 values each. `threads == 0`
+	// uses `std::thread::hardware_concurrency()`.
+
+	/// Sorts DateTimes in ascending order. Allocates a buffer of the same size.
+	void sortByTime(std::span<DateTime> dateTimes, unsigned threads = 1);
+
+	/// Sorts records in ascending order of the DateTime returned by `projection`, e.g. `&Event::time`. The sort is
+	/// stable. The keys and their positions are radix sorted, then the records are moved to their sorted position
+	/// through a buffer, so `T` must be move constructible and move assignable.
+	template <typename T, typename Projection>
+		requires std::convertible_to<std::invoke_result_t<Projection&, const T&>, DateTime>
+	void sortByTime(std::span<T> records, Projection projection, unsigned threads = 1)
+	{
+		std::vector<int64_t> keys(records.size());
+		std::vector<std::size_t> positions(records.size());
+		for (std::size_t i = 0; i < records.size(); ++i)
+		{
+			keys[i] = static_cast<DateTime>(std::invoke(projection, std::as_const(records[i]))).toUnixMillis();
+			positions[i] = i;
+		}
+
+		detail::radixSortByKey(keys, positions, threads);
+
+		std::vector<T> sorted;
+		sorted.reserve(records.size());
+		for (const std::size_t position : positions)
+			sorted.push_back(std::move(records[position]));
+		std::move(sorted.begin(), sorted.end(), records.begin());
+	}
+
+} // namespace onion
+
+#ifdef ONION_HEADER_ONLY
+#include "Sort.cpp"
+#endif
@@ -0,0 +1,65 @@
+#include "Stopwatch.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <limits>
+#include <thread>
+
+#include "Config.hpp"
+
+namespace onion
+{
+	namespace
+	{
+#ifdef ONION_STEADY_TSC
+		struct ClockReading
+		{
+			int64_t nanoseconds; // steady_clock
+			int64_t ticks;		 // TSC
+		};
+
+		/// Reads both clocks together: the counter between two clock reads, keeping the tightest of a few
+		/// brackets, so that an interruption between the reads does not skew the pair.
+		inline ClockReading readClocks() noexcept
+		{
+			using std::chrono::steady_clock;
+
+			ClockReading best{};
+			int64_t bestWidth = std::numeric_limits<int64_t>::max();
+			for (int attempt = 0; attempt < 8; ++attempt)
+			{
+				const int64_t before = steady_clock::now().time_since_epoch() / std::chrono::nanoseconds(1);
+				const int64_t ticks = SteadyStamp::Now().ticks();
+				const int64_t after = steady_clock::now().time_since_epoch() / std::chrono::nanoseconds(1);
+				if (after - before < bestWidth)
+				{
+					bestWidth = after - before;
+					best = {before + (after - before) / 2, ticks};
+				}
+			}
+			return best;
+		}
+
+		/// With brackets of some tens of nanoseconds, 10 ms of measurement gives the frequency to a few ppm.
+		inline double calibrateTsc() noexcept
+		{
+			const ClockReading first = readClocks();
+			std::this_thread::sleep_for(std::chrono::milliseconds(10));
+			const ClockReading second = readClocks();
+			return static_cast<double>(second.nanoseconds - first.nanoseconds) /
+				   static_cast<double>(second.ticks - first.ticks);
+		}
+#endif
+	} // namespace
+
+	ONION_INLINE double detail::steadyNanosPerTick() noexcept
+	{
+#ifdef ONION_STEADY_TSC
+		static const double nanosPerTick = calibrateTsc();
+		return nanosPerTick;
+#else
+		return 1.0;
+#endif
+	}
+
+} // namespace onion
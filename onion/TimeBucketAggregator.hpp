@@ -0,0 +1,276 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <stdexcept>
+#include <vector>
+
+#include "Config.hpp"
+#include "DateTime.hpp"
+#include "TimeSpan.hpp"
+#include "detail/Calendar.hpp"
+#include "detail/Hash.hpp"
+
+namespace onion
+{
+	/// Counts and sums values per fixed-interval time bucket, from several threads without locks.
+	///
+	/// Buckets are the intervals of `interval()` (whole milliseconds) from `origin`, as in
+	/// `DateTime::floor(interval(), origin)`. Each writer thread adds to its own `Shard`: a flat open-addressing table
+	/// keyed by bucket index, with linear probing, where consecutive adds to the same bucket skip the lookup. Shards
+	/// are cache-line aligned, so writers never share a cache line. Reads (`buckets`, `find`) merge the shards, and
+	/// must not run concurrently with writers.
+	///
+	/// Example:
+	///   onion::TimeBucketAggregator<double> latency(onion::TimeSpan::FromMinutes(1), threadCount);
+	///   // in thread i:
+	///   latency.shard(i).add(request.time, request.latencyMs);
+	///   // after joining the threads:
+	///   for (const auto& bucket : latency.buckets()) report(bucket.start, bucket.sum / bucket.count);
+	///
+	/// @tparam V Type of the summed values: default constructible to zero, copyable, with `+=`.
+	template <typename V = int64_t> class TimeBucketAggregator
+	{
+	  public:
+		/// Totals of one bucket.
+		struct Bucket
+		{
+			DateTime start;
+			uint64_t count;
+			V sum;
+		};
+
+		/// The part of the aggregator written by one thread. A shard is not thread-safe.
+		class alignas(64) Shard
+		{
+		  public:
+			/// Adds a value to the bucket containing `time`.
+			void add(const DateTime& time, const V& value)
+			{
+				const int64_t key = detail::floorDiv(time.toUnixMillis() - m_origin, m_interval);
+				if (key != m_lastKey)
+				{
+					Slot& entry = slot(key); // may grow the table, so take its index afterwards
+					m_last = static_cast<std::size_t>(&entry - m_slots.data());
+					m_lastKey = key;
+				}
+				Slot& entry = m_slots[m_last];
+				++entry.count;
+				entry.sum += value;
+			}
+
+			/// Counts an event in the bucket containing `time`.
+			void add(const DateTime& time) { add(time, V{}); }
+
+			/// Returns the number of buckets with at least one event in this shard.
+			std::size_t size() const noexcept { return m_size; }
+
+		  private:
+			friend class TimeBucketAggregator;
+
+			/// Key of empty slots; bucket indexes are far smaller in magnitude.
+			static constexpr int64_t EmptyKey = INT64_MIN;
+			static constexpr std::size_t InitialCapacity = 64;
+
+			struct Slot
+			{
+				int64_t key = EmptyKey;
+				uint64_t count = 0;
+				V sum{};
+			};
+
+			Shard(int64_t intervalMillis, int64_t originMillis) : m_interval(intervalMillis), m_origin(originMillis) {}
+
+			std::size_t home(int64_t key) const noexcept
+			{
+				return static_cast<std::size_t>(detail::mixBits(static_cast<uint64_t>(key))) & (m_slots.size() - 1);
+			}
+
+			/// Returns the slot of a bucket, inserting it if needed. The table is kept at most half full.
+			Slot& slot(int64_t key)
+			{
+				if ((m_size + 1) * 2 > m_slots.size())
+					grow();
+
+				for (std::size_t index = home(key);; index = (index + 1) & (m_slots.size() - 1))
+				{
+					Slot& candidate = m_slots[index];
+					if (candidate.key == key)
+						return candidate;
+					if (candidate.key == EmptyKey)
+					{
+						candidate.key = key;
+						++m_size;
+						return candidate;
+					}
+				}
+			}
+
+			const Slot* find(int64_t key) const noexcept
+			{
+				if (m_size == 0)
+					return nullptr;
+
+				for (std::size_t index = home(key);; index = (index + 1) & (m_slots.size() - 1))
+				{
+					const Slot& candidate = m_slots[index];
+					if (candidate.key == key)
+						return &candidate;
+					if (candidate.key == EmptyKey)
+						return nullptr;
+				}
+			}
+
+			void grow()
+			{
+				std::vector<Slot> previous(std::max(InitialCapacity, m_slots.size() * 2));
+				previous.swap(m_slots);
+				m_size = 0;
+				m_lastKey = EmptyKey;
+				for (const Slot& entry : previous)
+				{
+					if (entry.key != EmptyKey)
+						slot(entry.key) = entry;
+				}
+			}
+
+			void clear() noexcept
+			{
+				std::fill(m_slots.begin(), m_slots.end(), Slot{});
+				m_size = 0;
+				m_lastKey = EmptyKey;
+			}
+
+		  private:
+			int64_t m_interval; // milliseconds
+			int64_t m_origin;	// Unix milliseconds
+			std::vector<Slot> m_slots;
+			std::size_t m_size = 0;
+
+			int64_t m_lastKey = EmptyKey; // bucket of the last add, whose slot index is m_last
+			std::size_t m_last = 0;
+		};
+
+	  public:
+		/// Creates an aggregator with `shards` shards, one per writer thread. Buckets are whole milliseconds wide:
+		/// `interval` is truncated to milliseconds.
+		/// @throws std::invalid_argument If `interval` is shorter than 1 ms or `shards` is 0.
+		TimeBucketAggregator(const TimeSpan& interval,
+							 std::size_t shards,
+							 const DateTime& origin = DateTime::FromUnixSeconds(0))
+			: m_origin(origin)
+		{
+			const int64_t intervalMillis =
+				std::chrono::duration_cast<std::chrono::milliseconds>(interval.GetDuration()).count();
+			if (intervalMillis <= 0)
+				detail::raise(std::invalid_argument("TimeBucketAggregator: interval is shorter than 1 ms"));
+			m_interval = TimeSpan::FromMilliseconds(intervalMillis);
+			if (shards == 0)
+				detail::raise(std::invalid_argument("TimeBucketAggregator: at least one shard is required"));
+
+			m_shards.reserve(shards);
+			for (std::size_t i = 0; i < shards; ++i)
+				m_shards.push_back(Shard(intervalMillis, origin.toUnixMillis()));
+		}
+
+		/// Returns the shard with the given index, to be written by a single thread.
+		/// @throws std::out_of_range If `index >= shardCount()`.
+		Shard& shard(std::size_t index)
+		{
+			if (index >= m_shards.size())
+				detail::raise(std::out_of_range("TimeBucketAggregator: shard index out of range"));
+			return m_shards[index];
+		}
+
+		/// Returns the number of shards.
+		std::size_t shardCount() const noexcept { return m_shards.size(); }
+
+		/// Returns the bucket length: the constructor's interval truncated to whole milliseconds.
+		TimeSpan interval() const noexcept { return m_interval; }
+
+		/// Returns the start of bucket 0.
+		DateTime origin() const noexcept { return m_origin; }
+
+		/// Returns the merged totals of the non-empty buckets, in ascending order of start.
+		/// @throws std::out_of_range If a bucket starts before 0001-01-01, which an origin that is not a whole number
+		/// of intervals from it allows.
+		std::vector<Bucket> buckets() const
+		{
+			Shard merged(m_shards.front().m_interval, m_shards.front().m_origin);
+			for (const Shard& shard : m_shards)
+			{
+				for (const typename Shard::Slot& entry : shard.m_slots)
+				{
+					if (entry.key == Shard::EmptyKey)
+						continue;
+					typename Shard::Slot& total = merged.slot(entry.key);
+					total.count += entry.count;
+					total.sum += entry.sum;
+				}
+			}
+
+			std::vector<typename Shard::Slot> slots;
+			slots.reserve(merged.m_size);
+			for (const typename Shard::Slot& entry : merged.m_slots)
+			{
+				if (entry.key != Shard::EmptyKey)
+					slots.push_back(entry);
+			}
+			std::sort(slots.begin(), slots.end(), [](const auto& a, const auto& b) { return a.key < b.key; });
+
+			std::vector<Bucket> result;
+			result.reserve(slots.size());
+			for (const typename Shard::Slot& entry : slots)
+				result.push_back(Bucket{bucketStart(entry.key), entry.count, entry.sum});
+			return result;
+		}
+
+		/// Returns the merged totals of the bucket containing `time`, or `std::nullopt` if it is empty.
+		/// @throws std::out_of_range If the bucket starts before 0001-01-01.
+		std::optional<Bucket> find(const DateTime& time) const
+		{
+			const Shard& first = m_shards.front();
+			const int64_t key = detail::floorDiv(time.toUnixMillis() - first.m_origin, first.m_interval);
+
+			Bucket bucket{m_origin, 0, V{}};
+			for (const Shard& shard : m_shards)
+			{
+				if (const auto* entry = shard.find(key))
+				{
+					bucket.count += entry->count;
+					bucket.sum += entry->sum;
+				}
+			}
+			if (bucket.count == 0)
+				return std::nullopt;
+
+			bucket.start = bucketStart(key);
+			return bucket;
+		}
+
+		/// Empties every bucket, keeping the shards' memory. Must not run concurrently with writers.
+		void clear() noexcept
+		{
+			for (Shard& shard : m_shards)
+				shard.clear();
+		}
+
+	  private:
+		DateTime bucketStart(int64_t key) const
+		{
+			// In milliseconds rather than through TimeSpan, whose nanoseconds only cover about 292 years.
+			// key * interval is at most the width of the DateTime range, so it cannot overflow.
+			const Shard& first = m_shards.front();
+			return DateTime::FromUnixMillis(first.m_origin + key * first.m_interval);
+		}
+
+	  private:
+		TimeSpan m_interval;
+		DateTime m_origin;
+		std::vector<Shard> m_shards;
+	};
+
+} // namespace onion
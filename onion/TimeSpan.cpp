@@ -1,7 +1,10 @@
 #include "TimeSpan.hpp"
 
-#include <iomanip>
-#include <sstream>
+#include <algorithm>
+#include <string_view>
+
+#include "Config.hpp"
+#include "detail/Digits.hpp"
 
 namespace onion
 {
@@ -11,274 +14,270 @@ namespace onion
 	constexpr int64_t NanosPerHour = 60 * NanosPerMinute;
 	constexpr int64_t NanosPerDay = 24 * NanosPerHour;
 
-	TimeSpan::TimeSpan(const std::chrono::duration<int64_t, std::nano>& duration) : m_Duration(duration) {}
-
-	TimeSpan::TimeSpan(int64_t days,
-					   int64_t hours,
-					   int64_t minutes,
-					   int64_t seconds,
-					   int64_t milliseconds,
-					   int64_t microseconds,
-					   int64_t nanoseconds)
-	{
-		m_Duration = std::chrono::duration_cast<std::chrono::nanoseconds>(
-			std::chrono::days(days) + std::chrono::hours(hours) + std::chrono::minutes(minutes) +
-			std::chrono::seconds(seconds) + std::chrono::milliseconds(milliseconds) +
-			std::chrono::microseconds(microseconds) + std::chrono::nanoseconds(nanoseconds));
-	}
-
-	TimeSpan TimeSpan::Zero()
-	{
-		return TimeSpan();
-	}
-
-	TimeSpan TimeSpan::FromDays(int64_t days)
+	namespace
 	{
-		return TimeSpan(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::days(days)));
-	}
-
-	TimeSpan TimeSpan::FromHours(int64_t hours)
-	{
-		return TimeSpan(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::hours(hours)));
-	}
-
-	TimeSpan TimeSpan::FromMinutes(int64_t minutes)
-	{
-		return TimeSpan(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::minutes(minutes)));
-	}
-
-	TimeSpan TimeSpan::FromSeconds(int64_t seconds)
-	{
-		return TimeSpan(std::chrono::seconds(seconds));
-	}
-
-	TimeSpan TimeSpan::FromMilliseconds(int64_t milliseconds)
-	{
-		return TimeSpan(std::chrono::milliseconds(milliseconds));
-	}
-
-	TimeSpan TimeSpan::FromMicroseconds(int64_t microseconds)
-	{
-		return TimeSpan(std::chrono::microseconds(microseconds));
-	}
-
-	TimeSpan TimeSpan::FromNanoseconds(int64_t nanoseconds)
-	{
-		return TimeSpan(std::chrono::nanoseconds(nanoseconds));
-	}
+		/// Components of the absolute value of a duration.
+		struct Parts
+		{
+			bool negative;
+			uint64_t days;
+			unsigned hours;
+			unsigned minutes;
+			unsigned seconds;
+			unsigned nanoseconds;
+		};
+
+		/// Negates in unsigned arithmetic, so that `TimeSpan::MinValue()` does not overflow.
+		constexpr uint64_t magnitude(int64_t value) noexcept
+		{
+			return value < 0 ? 0 - static_cast<uint64_t>(value) : static_cast<uint64_t>(value);
+		}
 
-	TimeSpan TimeSpan::MaxValue()
-	{
-		return TimeSpan(std::chrono::nanoseconds::max());
-	}
+		constexpr Parts split(int64_t totalNs) noexcept
+		{
+			uint64_t remaining = magnitude(totalNs);
+
+			Parts parts{};
+			parts.negative = totalNs < 0;
+			parts.days = remaining / NanosPerDay;
+			remaining %= NanosPerDay;
+			parts.hours = static_cast<unsigned>(remaining / NanosPerHour);
+			remaining %= NanosPerHour;
+			parts.minutes = static_cast<unsigned>(remaining / NanosPerMinute);
+			remaining %= NanosPerMinute;
+			parts.seconds = static_cast<unsigned>(remaining / NanosPerSecond);
+			parts.nanoseconds = static_cast<unsigned>(remaining % NanosPerSecond);
+			return parts;
+		}
 
-	TimeSpan TimeSpan::MinValue()
-	{
-		return TimeSpan(std::chrono::nanoseconds::min());
-	}
+		/// Writes `value` as `digits` zero-padded decimal digits.
+		constexpr char* writeFixed(char* out, uint64_t value, unsigned digits) noexcept
+		{
+			char* const end = out + digits;
+			char* it = end;
+			for (; digits >= 2; digits -= 2)
+			{
+				it -= 2;
+				detail::writeDigits2(it, static_cast<unsigned>(value % 100));
+				value /= 100;
+			}
+			if (digits > 0)
+				it[-1] = static_cast<char>('0' + value % 10);
+			return end;
+		}
 
-	TimeSpan TimeSpan::operator+(const TimeSpan& other) const
-	{
-		return TimeSpan(m_Duration + other.m_Duration);
-	}
+		/// Writes a fraction of `digits` decimal digits without its trailing zeros. Writes nothing if it is zero.
+		constexpr char* writeTrimmed(char* out, uint64_t fraction, unsigned digits) noexcept
+		{
+			if (fraction == 0)
+				return out;
 
-	TimeSpan TimeSpan::operator-(const TimeSpan& other) const
-	{
-		return TimeSpan(m_Duration - other.m_Duration);
-	}
+			while (fraction % 10 == 0)
+			{
+				fraction /= 10;
+				--digits;
+			}
 
-	TimeSpan& TimeSpan::operator+=(const TimeSpan& other)
-	{
-		m_Duration += other.m_Duration;
-		return *this;
-	}
+			*out++ = '.';
+			return writeFixed(out, fraction, digits);
+		}
 
-	TimeSpan& TimeSpan::operator-=(const TimeSpan& other)
-	{
-		m_Duration -= other.m_Duration;
-		return *this;
-	}
+		/// Writes `value` in decimal. Cannot fail: callers size their buffers for 20 digits.
+		char* writeInteger(char* out, uint64_t value) noexcept
+		{
+			return std::to_chars(out, out + 20, value).ptr;
+		}
 
-	bool TimeSpan::operator<(const TimeSpan& other) const
-	{
-		return m_Duration < other.m_Duration;
-	}
+		/// Copies [buffer, end) to [first, last) if it fits, in the manner of `std::to_chars`.
+		std::to_chars_result copyTo(const char* buffer, const char* end, char* first, char* last) noexcept
+		{
+			if (last - first < end - buffer)
+				return {last, std::errc::value_too_large};
+			return {std::copy(buffer, end, first), std::errc{}};
+		}
 
-	bool TimeSpan::operator<=(const TimeSpan& other) const
-	{
-		return m_Duration <= other.m_Duration;
-	}
+		struct UnitInfo
+		{
+			/// Length of the unit in nanoseconds, as `scale * 10^exponent`.
+			uint64_t scale;
+			unsigned exponent;
+			std::string_view symbol;
+		};
 
-	bool TimeSpan::operator>(const TimeSpan& other) const
-	{
-		return m_Duration > other.m_Duration;
-	}
+		constexpr UnitInfo unitInfo(TimeSpan::Unit unit) noexcept
+		{
+			switch (unit)
+			{
+				case TimeSpan::Unit::Days:
+					return {86'400, 9, "d"};
+				case TimeSpan::Unit::Hours:
+					return {3'600, 9, "h"};
+				case TimeSpan::Unit::Minutes:
+					return {60, 9, "min"};
+				case TimeSpan::Unit::Seconds:
+					return {1, 9, "s"};
+				case TimeSpan::Unit::Milliseconds:
+					return {1, 6, "ms"};
+				case TimeSpan::Unit::Microseconds:
+					return {1, 3, "us"};
+				default:
+					return {1, 0, "ns"};
+			}
+		}
 
-	bool TimeSpan::operator>=(const TimeSpan& other) const
-	{
-		return m_Duration >= other.m_Duration;
-	}
+		constexpr uint64_t pow10(unsigned exponent) noexcept
+		{
+			uint64_t result = 1;
+			while (exponent-- > 0)
+				result *= 10;
+			return result;
+		}
+	} // namespace
 
-	double TimeSpan::TotalDays() const
+	ONION_INLINE std::string TimeSpan::ToString() const
 	{
-		return std::chrono::duration<double, std::ratio<86400>>(m_Duration).count();
+		char buffer[MaxStringLength];
+		return std::string(buffer, ToChars(buffer, buffer + MaxStringLength).ptr);
 	}
 
-	double TimeSpan::TotalHours() const
+	ONION_INLINE std::string TimeSpan::ToString_ISO8601() const
 	{
-		return std::chrono::duration<double, std::ratio<3600>>(m_Duration).count();
+		char buffer[MaxIsoStringLength];
+		return std::string(buffer, ToChars_ISO8601(buffer, buffer + MaxIsoStringLength).ptr);
 	}
 
-	double TimeSpan::TotalMinutes() const
+	ONION_INLINE std::to_chars_result TimeSpan::ToChars(char* first, char* last) const noexcept
 	{
-		return std::chrono::duration<double, std::ratio<60>>(m_Duration).count();
-	}
+		const Parts parts = split(m_Duration.count());
 
-	double TimeSpan::TotalSeconds() const
-	{
-		return std::chrono::duration<double>(m_Duration).count();
-	}
+		// ---- [-][d.]hh:mm:ss[.fffffffff] ----
+		char buffer[MaxStringLength];
+		char* out = buffer;
 
-	double TimeSpan::TotalMilliseconds() const
-	{
-		return std::chrono::duration<double, std::milli>(m_Duration).count();
-	}
+		if (parts.negative)
+			*out++ = '-';
 
-	double TimeSpan::TotalMicroseconds() const
-	{
-		return std::chrono::duration<double, std::micro>(m_Duration).count();
-	}
+		if (parts.days > 0)
+		{
+			out = writeInteger(out, parts.days);
+			*out++ = '.';
+		}
 
-	int64_t TimeSpan::TotalNanoseconds() const
-	{
-		return m_Duration.count();
-	}
+		out = writeFixed(out, parts.hours, 2);
+		*out++ = ':';
+		out = writeFixed(out, parts.minutes, 2);
+		*out++ = ':';
+		out = writeFixed(out, parts.seconds, 2);
 
-	TimeSpan TimeSpan::Abs() const
-	{
-		if (m_Duration.count() < 0)
+		if (parts.nanoseconds > 0)
 		{
-			return TimeSpan(-m_Duration);
+			*out++ = '.';
+			out = writeFixed(out, parts.nanoseconds, 9);
 		}
 
-		return *this;
+		return copyTo(buffer, out, first, last);
 	}
 
-	std::chrono::duration<int64_t, std::nano> TimeSpan::GetDuration() const
+	ONION_INLINE std::to_chars_result TimeSpan::ToChars_ISO8601(char* first, char* last) const noexcept
 	{
-		return m_Duration;
-	}
+		if (m_Duration.count() == 0)
+			return copyTo("PT0S", "PT0S" + 4, first, last);
 
-	std::string TimeSpan::ToString() const
-	{
-		using namespace std::chrono;
-
-		int64_t totalNs = m_Duration.count();
-
-		bool negative = totalNs < 0;
-		if (negative)
-			totalNs = -totalNs;
-
-		int64_t days = totalNs / NanosPerDay;
-		totalNs %= NanosPerDay;
+		const Parts parts = split(m_Duration.count());
 
-		int64_t hours = totalNs / NanosPerHour;
-		totalNs %= NanosPerHour;
+		// ---- [-]P[nD][T[nH][nM][n[.f]S]] ----
+		char buffer[MaxIsoStringLength];
+		char* out = buffer;
 
-		int64_t minutes = totalNs / NanosPerMinute;
-		totalNs %= NanosPerMinute;
+		if (parts.negative)
+			*out++ = '-';
+		*out++ = 'P';
 
-		int64_t seconds = totalNs / NanosPerSecond;
-		totalNs %= NanosPerSecond;
-
-		int64_t nanoseconds = totalNs;
-
-		std::ostringstream oss;
+		if (parts.days > 0)
+		{
+			out = writeInteger(out, parts.days);
+			*out++ = 'D';
+		}
 
-		if (negative)
-			oss << "-";
+		if (parts.hours > 0 || parts.minutes > 0 || parts.seconds > 0 || parts.nanoseconds > 0)
+			*out++ = 'T';
 
-		if (days > 0)
-			oss << days << ".";
+		if (parts.hours > 0)
+		{
+			out = writeInteger(out, parts.hours);
+			*out++ = 'H';
+		}
 
-		oss << std::setw(2) << std::setfill('0') << hours << ":" << std::setw(2) << std::setfill('0') << minutes << ":"
-			<< std::setw(2) << std::setfill('0') << seconds;
+		if (parts.minutes > 0)
+		{
+			out = writeInteger(out, parts.minutes);
+			*out++ = 'M';
+		}
 
-		if (nanoseconds > 0)
+		if (parts.seconds > 0 || parts.nanoseconds > 0)
 		{
-			oss << "." << std::setw(9) << std::setfill('0') << nanoseconds;
+			out = writeInteger(out, parts.seconds);
+			out = writeTrimmed(out, parts.nanoseconds, 9);
+			*out++ = 'S';
 		}
 
-		return oss.str();
+		return copyTo(buffer, out, first, last);
 	}
 
-	std::string TimeSpan::ToString_ISO8601() const
+	ONION_INLINE std::to_chars_result TimeSpan::ToChars(char* first,
+														 char* last,
+														 Unit unit,
+														 int precision) const noexcept
 	{
-		using namespace std::chrono;
-
-		int64_t totalNs = m_Duration.count();
-
-		if (totalNs == 0)
-			return "PT0S";
-
-		bool negative = totalNs < 0;
-		if (negative)
-			totalNs = -totalNs;
-
-		int64_t days = totalNs / NanosPerDay;
-		totalNs %= NanosPerDay;
-
-		int64_t hours = totalNs / NanosPerHour;
-		totalNs %= NanosPerHour;
-
-		int64_t minutes = totalNs / NanosPerMinute;
-		totalNs %= NanosPerMinute;
-
-		int64_t seconds = totalNs / NanosPerSecond;
-		totalNs %= NanosPerSecond;
-
-		int64_t nanoseconds = totalNs;
-
-		std::ostringstream oss;
-
-		if (negative)
-			oss << "-";
-
-		oss << "P";
-
-		if (days > 0)
-			oss << days << "D";
-
-		if (hours > 0 || minutes > 0 || seconds > 0 || nanoseconds > 0)
-			oss << "T";
-
-		if (hours > 0)
-			oss << hours << "H";
-
-		if (minutes > 0)
-			oss << minutes << "M";
-
-		if (seconds > 0 || nanoseconds > 0)
+		const UnitInfo info = unitInfo(unit);
+		const uint64_t totalNs = magnitude(m_Duration.count());
+		const uint64_t unitNs = info.scale * pow10(info.exponent);
+
+		// Without a precision, show every digit down to the nanosecond.
+		const bool trim = precision < 0;
+		const unsigned digits = trim ? (info.scale > 1 ? 9u : info.exponent)
+									 : std::min(static_cast<unsigned>(precision), 9u);
+
+		// The fraction is remainder / unitNs scaled to `digits` digits. Since unitNs = scale * 10^exponent, this
+		// divides by an exact integer when digits <= exponent, and is an exact multiplication otherwise.
+		uint64_t whole = totalNs / unitNs;
+		const uint64_t remainder = totalNs % unitNs;
+		uint64_t fraction;
+		if (digits <= info.exponent)
 		{
-			oss << seconds;
-
-			if (nanoseconds > 0)
+			const uint64_t divisor = info.scale * pow10(info.exponent - digits);
+			fraction = (remainder + divisor / 2) / divisor;
+			if (fraction == pow10(digits))
 			{
-				std::string frac = std::to_string(nanoseconds);
-				frac.insert(frac.begin(), 9 - frac.length(), '0');
+				++whole;
+				fraction = 0;
+			}
+		}
+		else
+		{
+			fraction = remainder * pow10(digits - info.exponent);
+		}
 
-				// trim trailing zeros
-				while (!frac.empty() && frac.back() == '0')
-					frac.pop_back();
+		// ---- [-]whole[.fraction]symbol ----
+		char buffer[MaxUnitStringLength];
+		char* out = buffer;
 
-				if (!frac.empty())
-					oss << "." << frac;
-			}
+		if (m_Duration.count() < 0 && (whole > 0 || fraction > 0))
+			*out++ = '-';
 
-			oss << "S";
+		out = writeInteger(out, whole);
+		if (trim)
+		{
+			out = writeTrimmed(out, fraction, digits);
+		}
+		else if (digits > 0)
+		{
+			*out++ = '.';
+			out = writeFixed(out, fraction, digits);
 		}
+		out = std::copy(info.symbol.begin(), info.symbol.end(), out);
 
-		return oss.str();
+		return copyTo(buffer, out, first, last);
 	}
 
 } // namespace onion
@@ -1,8 +1,21 @@
 #pragma once
 
+#include <algorithm>
+#include <charconv>
 #include <chrono>
+#include <compare>
+#include <cstdint>
+#include <format>
+#include <functional>
+#include <optional>
 #include <string>
+#include <string_view>
 #include <type_traits>
+#include <utility>
+
+#include "Config.hpp"
+#include "detail/Hash.hpp"
+#include "detail/Overflow.hpp"
 
 namespace onion
 {
@@ -10,95 +23,297 @@ namespace onion
 	{
 		// ----- Constructors / Destructor -----
 	  public:
-		TimeSpan() = default;
-		TimeSpan(const std::chrono::duration<int64_t, std::nano>& duration);
-		TimeSpan(int64_t days,
-				 int64_t hours,
-				 int64_t minutes,
-				 int64_t seconds,
-				 int64_t milliseconds = 0,
-				 int64_t microseconds = 0,
-				 int64_t nanoseconds = 0);
-
-		static TimeSpan Zero();
-		static TimeSpan FromDays(int64_t days);
-		static TimeSpan FromHours(int64_t hours);
-		static TimeSpan FromMinutes(int64_t minutes);
-		static TimeSpan FromSeconds(int64_t seconds);
-		static TimeSpan FromMilliseconds(int64_t milliseconds);
-		static TimeSpan FromMicroseconds(int64_t microseconds);
-		static TimeSpan FromNanoseconds(int64_t nanoseconds);
-		static TimeSpan MaxValue();
-		static TimeSpan MinValue();
+		constexpr TimeSpan() = default;
+		constexpr TimeSpan(const std::chrono::duration<int64_t, std::nano>& duration) : m_Duration(duration) {}
+		constexpr TimeSpan(int64_t days,
+						   int64_t hours,
+						   int64_t minutes,
+						   int64_t seconds,
+						   int64_t milliseconds = 0,
+						   int64_t microseconds = 0,
+						   int64_t nanoseconds = 0);
+
+		static constexpr TimeSpan Zero();
+		static constexpr TimeSpan FromDays(int64_t days);
+		static constexpr TimeSpan FromHours(int64_t hours);
+		static constexpr TimeSpan FromMinutes(int64_t minutes);
+		static constexpr TimeSpan FromSeconds(int64_t seconds);
+		static constexpr TimeSpan FromMilliseconds(int64_t milliseconds);
+		static constexpr TimeSpan FromMicroseconds(int64_t microseconds);
+		static constexpr TimeSpan FromNanoseconds(int64_t nanoseconds);
+		static constexpr TimeSpan MaxValue();
+		static constexpr TimeSpan MinValue();
 
 		// ----- OPERATORS -----
 	  public:
-		bool operator==(const TimeSpan& other) const = default;
-		bool operator!=(const TimeSpan& other) const = default;
-		bool operator<(const TimeSpan& other) const;
-		bool operator<=(const TimeSpan& other) const;
-		bool operator>(const TimeSpan& other) const;
-		bool operator>=(const TimeSpan& other) const;
+		constexpr bool operator==(const TimeSpan& other) const = default;
+		constexpr auto operator<=>(const TimeSpan& other) const = default;
 
-		TimeSpan operator+(const TimeSpan& other) const;
-		TimeSpan operator-(const TimeSpan& other) const;
+		constexpr TimeSpan operator+(const TimeSpan& other) const;
+		constexpr TimeSpan operator-(const TimeSpan& other) const;
 
-		TimeSpan& operator+=(const TimeSpan& other);
-		TimeSpan& operator-=(const TimeSpan& other);
+		constexpr TimeSpan& operator+=(const TimeSpan& other);
+		constexpr TimeSpan& operator-=(const TimeSpan& other);
 
+		/// Integral scalars use exact int64 arithmetic (division truncates toward zero). Floating-point scalars go
+		/// through `long double` and truncate the result toward zero.
 		template <typename T>
 			requires std::is_arithmetic_v<T>
-		TimeSpan operator*(T scalar) const;
+		constexpr TimeSpan operator*(T scalar) const;
 		template <typename T>
 			requires std::is_arithmetic_v<T>
-		TimeSpan& operator*=(T scalar);
+		constexpr TimeSpan& operator*=(T scalar);
 		template <typename T>
 			requires std::is_arithmetic_v<T>
-		friend TimeSpan operator*(T scalar, const TimeSpan& ts);
+		friend constexpr TimeSpan operator*(T scalar, const TimeSpan& ts);
 
 		template <typename T>
 			requires std::is_arithmetic_v<T>
-		TimeSpan operator/(T scalar) const;
+		constexpr TimeSpan operator/(T scalar) const;
 		template <typename T>
 			requires std::is_arithmetic_v<T>
-		TimeSpan& operator/=(T scalar);
+		constexpr TimeSpan& operator/=(T scalar);
+
+		// ----- Checked / Saturating Arithmetic -----
+		// Like the built-in integer operators, the operators above have undefined behavior when the result does not
+		// fit in int64 nanoseconds. These variants have defined results at the extremes and compile to the plain
+		// instruction plus an overflow-flag branch.
+	  public:
+		/// Returns the sum, or `std::nullopt` if it is outside [MinValue(), MaxValue()].
+		constexpr std::optional<TimeSpan> AddChecked(const TimeSpan& other) const noexcept;
+		/// Returns the difference, or `std::nullopt` if it is outside [MinValue(), MaxValue()].
+		constexpr std::optional<TimeSpan> SubtractChecked(const TimeSpan& other) const noexcept;
+		/// Returns the product, or `std::nullopt` if it is outside [MinValue(), MaxValue()].
+		constexpr std::optional<TimeSpan> MultiplyChecked(int64_t factor) const noexcept;
+
+		/// Returns the sum, clamped to [MinValue(), MaxValue()].
+		constexpr TimeSpan AddSaturating(const TimeSpan& other) const noexcept;
+		/// Returns the difference, clamped to [MinValue(), MaxValue()].
+		constexpr TimeSpan SubtractSaturating(const TimeSpan& other) const noexcept;
+		/// Returns the product, clamped to [MinValue(), MaxValue()].
+		constexpr TimeSpan MultiplySaturating(int64_t factor) const noexcept;
 
 		// ----- Public API -----
 	  public:
-		double TotalDays() const;
-		double TotalHours() const;
-		double TotalMinutes() const;
-		double TotalSeconds() const;
-		double TotalMilliseconds() const;
-		double TotalMicroseconds() const;
-		int64_t TotalNanoseconds() const;
+		constexpr double TotalDays() const;
+		constexpr double TotalHours() const;
+		constexpr double TotalMinutes() const;
+		constexpr double TotalSeconds() const;
+		constexpr double TotalMilliseconds() const;
+		constexpr double TotalMicroseconds() const;
+		constexpr int64_t TotalNanoseconds() const;
 
-		TimeSpan Abs() const;
+		constexpr TimeSpan Abs() const;
 
-		std::chrono::duration<int64_t, std::nano> GetDuration() const;
+		constexpr std::chrono::duration<int64_t, std::nano> GetDuration() const;
 
 		std::string ToString() const;
 		std::string ToString_ISO8601() const;
 
+		// ----- Formatting -----
+	  public:
+		/// Units a TimeSpan can be written in by `ToChars(first, last, unit, precision)`.
+		enum class Unit
+		{
+			Days,
+			Hours,
+			Minutes,
+			Seconds,
+			Milliseconds,
+			Microseconds,
+			Nanoseconds,
+		};
+
+		/// Longest output of `ToString()` and `ToChars(first, last)` ("-106751.23:47:16.854775808").
+		static constexpr std::size_t MaxStringLength = 26;
+		/// Longest output of `ToString_ISO8601()` and `ToChars_ISO8601()` ("-P106751DT23H47M16.854775808S").
+		static constexpr std::size_t MaxIsoStringLength = 29;
+		/// Longest output of `ToChars(first, last, unit, precision)` ("-9223372036854775808.000000000ns").
+		static constexpr std::size_t MaxUnitStringLength = 33;
+
+		/// Writes the same text as `ToString()` ("[-][d.]hh:mm:ss[.fffffffff]") into [first, last),
+		/// in the manner of `std::to_chars`. Does not allocate and does not use the locale.
+		/// @return The end of the written text, or `{last, std::errc::value_too_large}` if the buffer is too small
+		///         (nothing is written in that case). `MaxStringLength` characters are always enough.
+		std::to_chars_result ToChars(char* first, char* last) const noexcept;
+
+		/// Writes the same text as `ToString_ISO8601()` ("[-]PnDTnHnMn.nS") into [first, last),
+		/// in the manner of `std::to_chars`. Does not allocate and does not use the locale.
+		/// @return The end of the written text, or `{last, std::errc::value_too_large}` if the buffer is too small
+		///         (nothing is written in that case). `MaxIsoStringLength` characters are always enough.
+		std::to_chars_result ToChars_ISO8601(char* first, char* last) const noexcept;
+
+		/// Writes the total duration as a decimal number of `unit`, followed by the unit symbol
+		/// (d, h, min, s, ms, us or ns), e.g. "12.345ms".
+		/// @param precision Number of fractional digits, rounded half away from zero, in [0, 9]. When negative, the
+		///        value is written at nanosecond resolution (rounded for units above seconds) without trailing zeros.
+		/// @return The end of the written text, or `{last, std::errc::value_too_large}` if the buffer is too small
+		///         (nothing is written in that case). `MaxUnitStringLength` characters are always enough.
+		std::to_chars_result ToChars(char* first, char* last, Unit unit, int precision = -1) const noexcept;
+
 		// ----- Private Members -----
 	  private:
 		std::chrono::duration<int64_t, std::nano> m_Duration{0};
 	};
 
+	// ----- Inline Implementations -----
+	constexpr TimeSpan::TimeSpan(int64_t days,
+								 int64_t hours,
+								 int64_t minutes,
+								 int64_t seconds,
+								 int64_t milliseconds,
+								 int64_t microseconds,
+								 int64_t nanoseconds)
+		: m_Duration(std::chrono::duration_cast<std::chrono::nanoseconds>(
+			  std::chrono::days(days) + std::chrono::hours(hours) + std::chrono::minutes(minutes) +
+			  std::chrono::seconds(seconds) + std::chrono::milliseconds(milliseconds) +
+			  std::chrono::microseconds(microseconds) + std::chrono::nanoseconds(nanoseconds)))
+	{
+	}
+
+	constexpr TimeSpan TimeSpan::Zero()
+	{
+		return TimeSpan();
+	}
+
+	constexpr TimeSpan TimeSpan::FromDays(int64_t days)
+	{
+		return TimeSpan(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::days(days)));
+	}
+
+	constexpr TimeSpan TimeSpan::FromHours(int64_t hours)
+	{
+		return TimeSpan(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::hours(hours)));
+	}
+
+	constexpr TimeSpan TimeSpan::FromMinutes(int64_t minutes)
+	{
+		return TimeSpan(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::minutes(minutes)));
+	}
+
+	constexpr TimeSpan TimeSpan::FromSeconds(int64_t seconds)
+	{
+		return TimeSpan(std::chrono::seconds(seconds));
+	}
+
+	constexpr TimeSpan TimeSpan::FromMilliseconds(int64_t milliseconds)
+	{
+		return TimeSpan(std::chrono::milliseconds(milliseconds));
+	}
+
+	constexpr TimeSpan TimeSpan::FromMicroseconds(int64_t microseconds)
+	{
+		return TimeSpan(std::chrono::microseconds(microseconds));
+	}
+
+	constexpr TimeSpan TimeSpan::FromNanoseconds(int64_t nanoseconds)
+	{
+		return TimeSpan(std::chrono::nanoseconds(nanoseconds));
+	}
+
+	constexpr TimeSpan TimeSpan::MaxValue()
+	{
+		return TimeSpan(std::chrono::nanoseconds::max());
+	}
+
+	constexpr TimeSpan TimeSpan::MinValue()
+	{
+		return TimeSpan(std::chrono::nanoseconds::min());
+	}
+
+	constexpr TimeSpan TimeSpan::operator+(const TimeSpan& other) const
+	{
+		return TimeSpan(m_Duration + other.m_Duration);
+	}
+
+	constexpr TimeSpan TimeSpan::operator-(const TimeSpan& other) const
+	{
+		return TimeSpan(m_Duration - other.m_Duration);
+	}
+
+	constexpr TimeSpan& TimeSpan::operator+=(const TimeSpan& other)
+	{
+		m_Duration += other.m_Duration;
+		return *this;
+	}
+
+	constexpr TimeSpan& TimeSpan::operator-=(const TimeSpan& other)
+	{
+		m_Duration -= other.m_Duration;
+		return *this;
+	}
+
+	constexpr double TimeSpan::TotalDays() const
+	{
+		return std::chrono::duration<double, std::ratio<86400>>(m_Duration).count();
+	}
+
+	constexpr double TimeSpan::TotalHours() const
+	{
+		return std::chrono::duration<double, std::ratio<3600>>(m_Duration).count();
+	}
+
+	constexpr double TimeSpan::TotalMinutes() const
+	{
+		return std::chrono::duration<double, std::ratio<60>>(m_Duration).count();
+	}
+
+	constexpr double TimeSpan::TotalSeconds() const
+	{
+		return std::chrono::duration<double>(m_Duration).count();
+	}
+
+	constexpr double TimeSpan::TotalMilliseconds() const
+	{
+		return std::chrono::duration<double, std::milli>(m_Duration).count();
+	}
+
+	constexpr double TimeSpan::TotalMicroseconds() const
+	{
+		return std::chrono::duration<double, std::micro>(m_Duration).count();
+	}
+
+	constexpr int64_t TimeSpan::TotalNanoseconds() const
+	{
+		return m_Duration.count();
+	}
+
+	constexpr TimeSpan TimeSpan::Abs() const
+	{
+		if (m_Duration.count() < 0)
+		{
+			return TimeSpan(-m_Duration);
+		}
+
+		return *this;
+	}
+
+	constexpr std::chrono::duration<int64_t, std::nano> TimeSpan::GetDuration() const
+	{
+		return m_Duration;
+	}
+
 	// ----- Operator Implementations -----
 	template <typename T>
 		requires std::is_arithmetic_v<T>
-	TimeSpan TimeSpan::operator*(T scalar) const
+	constexpr TimeSpan TimeSpan::operator*(T scalar) const
 	{
-		auto result = std::chrono::duration_cast<std::chrono::nanoseconds>(
-			std::chrono::duration<long double, std::nano>(m_Duration.count()) * static_cast<long double>(scalar));
+		if constexpr (std::is_integral_v<T>)
+		{
+			return TimeSpan(std::chrono::nanoseconds(m_Duration.count() * static_cast<int64_t>(scalar)));
+		}
+		else
+		{
+			auto result = std::chrono::duration_cast<std::chrono::nanoseconds>(
+				std::chrono::duration<long double, std::nano>(m_Duration.count()) * static_cast<long double>(scalar));
 
-		return TimeSpan(static_cast<std::chrono::nanoseconds>(result));
+			return TimeSpan(static_cast<std::chrono::nanoseconds>(result));
+		}
 	}
 
 	template <typename T>
 		requires std::is_arithmetic_v<T>
-	TimeSpan& TimeSpan::operator*=(T scalar)
+	constexpr TimeSpan& TimeSpan::operator*=(T scalar)
 	{
 		*this = *this * scalar;
 		return *this;
@@ -106,26 +321,188 @@ namespace onion
 
 	template <typename T>
 		requires std::is_arithmetic_v<T>
-	TimeSpan operator*(T scalar, const TimeSpan& ts)
+	constexpr TimeSpan operator*(T scalar, const TimeSpan& ts)
 	{
 		return ts * scalar;
 	}
 
 	template <typename T>
 		requires std::is_arithmetic_v<T>
-	TimeSpan TimeSpan::operator/(T scalar) const
+	constexpr TimeSpan TimeSpan::operator/(T scalar) const
 	{
 		using namespace std::chrono;
 
-		auto result = duration<long double, std::nano>(m_Duration.count()) / static_cast<long double>(scalar);
-		return TimeSpan(duration_cast<nanoseconds>(result));
+		if constexpr (std::is_integral_v<T>)
+		{
+			return TimeSpan(nanoseconds(m_Duration.count() / static_cast<int64_t>(scalar)));
+		}
+		else
+		{
+			auto result = duration<long double, std::nano>(m_Duration.count()) / static_cast<long double>(scalar);
+			return TimeSpan(duration_cast<nanoseconds>(result));
+		}
 	}
 
 	template <typename T>
 		requires std::is_arithmetic_v<T>
-	TimeSpan& TimeSpan::operator/=(T scalar)
+	constexpr TimeSpan& TimeSpan::operator/=(T scalar)
 	{
 		*this = *this / scalar;
 		return *this;
 	}
+
+	// ----- Checked / Saturating Implementations -----
+	constexpr std::optional<TimeSpan> TimeSpan::AddChecked(const TimeSpan& other) const noexcept
+	{
+		int64_t result = 0;
+		if (detail::addOverflow(m_Duration.count(), other.m_Duration.count(), result))
+			return std::nullopt;
+		return TimeSpan(std::chrono::nanoseconds(result));
+	}
+
+	constexpr std::optional<TimeSpan> TimeSpan::SubtractChecked(const TimeSpan& other) const noexcept
+	{
+		int64_t result = 0;
+		if (detail::subOverflow(m_Duration.count(), other.m_Duration.count(), result))
+			return std::nullopt;
+		return TimeSpan(std::chrono::nanoseconds(result));
+	}
+
+	constexpr std::optional<TimeSpan> TimeSpan::MultiplyChecked(int64_t factor) const noexcept
+	{
+		int64_t result = 0;
+		if (detail::mulOverflow(m_Duration.count(), factor, result))
+			return std::nullopt;
+		return TimeSpan(std::chrono::nanoseconds(result));
+	}
+
+	constexpr TimeSpan TimeSpan::AddSaturating(const TimeSpan& other) const noexcept
+	{
+		// Only operands of the same sign can overflow, in the direction of that sign.
+		int64_t result = 0;
+		if (detail::addOverflow(m_Duration.count(), other.m_Duration.count(), result))
+			result = detail::saturate(m_Duration.count() < 0);
+		return TimeSpan(std::chrono::nanoseconds(result));
+	}
+
+	constexpr TimeSpan TimeSpan::SubtractSaturating(const TimeSpan& other) const noexcept
+	{
+		// Only operands of opposite signs can overflow, in the direction of the left operand's sign.
+		int64_t result = 0;
+		if (detail::subOverflow(m_Duration.count(), other.m_Duration.count(), result))
+			result = detail::saturate(m_Duration.count() < 0);
+		return TimeSpan(std::chrono::nanoseconds(result));
+	}
+
+	constexpr TimeSpan TimeSpan::MultiplySaturating(int64_t factor) const noexcept
+	{
+		int64_t result = 0;
+		if (detail::mulOverflow(m_Duration.count(), factor, result))
+			result = detail::saturate((m_Duration.count() < 0) != (factor < 0));
+		return TimeSpan(std::chrono::nanoseconds(result));
+	}
 } // namespace onion
+
+/// @brief Provides a custom formatter for `onion::TimeSpan` to enable formatting with `std::format` and `std::vformat`.
+///
+/// Format spec: empty for the `ToString()` form, `iso` for the `ToString_ISO8601()` form, or a unit
+/// (`d`, `h`, `min`, `s`, `ms`, `us`, `ns`) with an optional precision, e.g. `{:ms.3}` -> "12.345ms".
+/// Formatting does not allocate.
+template <> struct std::formatter<onion::TimeSpan>
+{
+	enum class Style
+	{
+		Constant,
+		Iso,
+		Unit,
+	};
+
+	Style style = Style::Constant;
+	onion::TimeSpan::Unit unit = onion::TimeSpan::Unit::Seconds;
+	int precision = -1;
+
+	constexpr auto parse(std::format_parse_context& ctx)
+	{
+		auto it = ctx.begin();
+		auto end = ctx.end();
+
+		auto start = it;
+		while (it != end && *it != '}')
+			++it;
+
+		std::string_view spec(start, it);
+		if (spec.empty())
+			return it;
+
+		if (spec == "iso")
+		{
+			style = Style::Iso;
+			return it;
+		}
+
+		const std::size_t dot = spec.find('.');
+		if (dot != std::string_view::npos)
+		{
+			const std::string_view digits = spec.substr(dot + 1);
+			if (digits.size() != 1 || digits[0] < '0' || digits[0] > '9')
+				onion::detail::raise(std::format_error("Invalid TimeSpan precision, expected a digit in [0, 9]"));
+			precision = digits[0] - '0';
+			spec = spec.substr(0, dot);
+		}
+
+		using Unit = onion::TimeSpan::Unit;
+		constexpr std::pair<std::string_view, Unit> Units[] = {
+			{"d", Unit::Days},
+			{"h", Unit::Hours},
+			{"min", Unit::Minutes},
+			{"s", Unit::Seconds},
+			{"ms", Unit::Milliseconds},
+			{"us", Unit::Microseconds},
+			{"ns", Unit::Nanoseconds},
+		};
+
+		const auto match =
+			std::find_if(std::begin(Units), std::end(Units), [&](const auto& entry) { return entry.first == spec; });
+		if (match == std::end(Units))
+			onion::detail::raise(std::format_error("Invalid TimeSpan format spec"));
+
+		style = Style::Unit;
+		unit = match->second;
+		return it;
+	}
+
+	template <typename FormatContext> auto format(const onion::TimeSpan& ts, FormatContext& ctx) const
+	{
+		char buffer[onion::TimeSpan::MaxUnitStringLength];
+		char* const last = buffer + sizeof(buffer);
+
+		std::to_chars_result result;
+		switch (style)
+		{
+			case Style::Iso:
+				result = ts.ToChars_ISO8601(buffer, last);
+				break;
+			case Style::Unit:
+				result = ts.ToChars(buffer, last, unit, precision);
+				break;
+			default:
+				result = ts.ToChars(buffer, last);
+				break;
+		}
+
+		return std::copy(buffer, result.ptr, ctx.out());
+	}
+};
+
+/// Hashes a TimeSpan by its nanosecond count, mixed like `std::hash<onion::DateTime>`.
+template <> struct std::hash<onion::TimeSpan>
+{
+	std::size_t operator()(const onion::TimeSpan& ts) const noexcept
+	{
+		return static_cast<std::size_t>(onion::detail::mixBits(static_cast<uint64_t>(ts.GetDuration().count())));
+	}
+};
+
+#ifdef ONION_HEADER_ONLY
+#include "TimeSpan.cpp"
+#endif
@@ -0,0 +1,704 @@
+#include "TimeZone.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+
+#include "Config.hpp"
+#include "detail/Calendar.hpp"
+
+namespace onion
+{
+	namespace
+	{
+		// ---- TZif (RFC 8536) ----
+
+		constexpr std::size_t TzifHeaderSize = 44;
+
+		inline uint32_t readUint32(const char* p) noexcept
+		{
+			return static_cast<uint32_t>(static_cast<unsigned char>(p[0])) << 24 |
+				static_cast<uint32_t>(static_cast<unsigned char>(p[1])) << 16 |
+				static_cast<uint32_t>(static_cast<unsigned char>(p[2])) << 8 |
+				static_cast<uint32_t>(static_cast<unsigned char>(p[3]));
+		}
+
+		inline int64_t readInt64(const char* p) noexcept
+		{
+			return static_cast<int64_t>(uint64_t{readUint32(p)} << 32 | readUint32(p + 4));
+		}
+
+		/// The counts of a TZif header.
+		struct TzifCounts
+		{
+			uint32_t isUtc;
+			uint32_t isStd;
+			uint32_t leap;
+			uint32_t time;
+			uint32_t type;
+			uint32_t chars;
+
+			/// Size of the data block that follows the header, with `timeSize`-byte transition times.
+			uint64_t dataSize(uint64_t timeSize) const noexcept
+			{
+				return time * (timeSize + 1) + type * 6ull + chars + leap * (timeSize + 4) + isStd + isUtc;
+			}
+		};
+
+		inline bool readHeader(std::string_view data, std::size_t offset, char& version, TzifCounts& counts) noexcept
+		{
+			if (data.size() < offset + TzifHeaderSize || data.substr(offset, 4) != "TZif")
+				return false;
+
+			const char* p = data.data() + offset;
+			version = p[4];
+			counts = {readUint32(p + 20),
+					  readUint32(p + 24),
+					  readUint32(p + 28),
+					  readUint32(p + 32),
+					  readUint32(p + 36),
+					  readUint32(p + 40)};
+			return true;
+		}
+
+		// ---- POSIX TZ rules ----
+
+		/// A parsed POSIX TZ rule. Offsets are in seconds east of UTC.
+		struct PosixZone
+		{
+			std::string_view stdName;
+			int32_t stdOffset = 0;
+			bool hasDst = false;
+			std::string_view dstName;
+			int32_t dstOffset = 0;
+		};
+
+		/// Cursor over a POSIX TZ rule.
+		struct PosixReader
+		{
+			const char* p;
+			const char* end;
+
+			bool atEnd() const noexcept { return p == end; }
+			bool peek(char c) const noexcept { return p != end && *p == c; }
+
+			bool consume(char c) noexcept
+			{
+				if (!peek(c))
+					return false;
+				++p;
+				return true;
+			}
+
+			bool readNumber(unsigned maxValue, unsigned& value) noexcept
+			{
+				if (p == end || static_cast<unsigned>(*p) - '0' > 9)
+					return false;
+
+				value = 0;
+				while (p != end && static_cast<unsigned>(*p) - '0' <= 9)
+				{
+					value = value * 10 + static_cast<unsigned>(*p++ - '0');
+					if (value > maxValue)
+						return false;
+				}
+				return true;
+			}
+
+			/// Reads a zone abbreviation: three or more letters, or "<...>" with letters, digits, '+' and '-'.
+			bool readName(std::string_view& name) noexcept
+			{
+				const char* begin = p;
+				if (consume('<'))
+				{
+					begin = p;
+					while (p != end && *p != '>')
+					{
+						const char c = *p;
+						const bool valid = (c >= 'A' && c <= 'Z') || (c >= 'a' && c <= 'z') ||
+							(c >= '0' && c <= '9') || c == '+' || c == '-';
+						if (!valid)
+							return false;
+						++p;
+					}
+					name = std::string_view(begin, static_cast<std::size_t>(p - begin));
+					return consume('>') && name.size() >= 3;
+				}
+
+				while (p != end && ((*p >= 'A' && *p <= 'Z') || (*p >= 'a' && *p <= 'z')))
+					++p;
+				name = std::string_view(begin, static_cast<std::size_t>(p - begin));
+				return name.size() >= 3;
+			}
+
+			/// Reads [+|-]hh[:mm[:ss]] as seconds.
+			bool readTime(unsigned maxHours, int32_t& seconds) noexcept
+			{
+				int sign = 1;
+				if (consume('-'))
+					sign = -1;
+				else
+					consume('+');
+
+				unsigned hours = 0, minutes = 0, secs = 0;
+				if (!readNumber(maxHours, hours))
+					return false;
+				if (consume(':'))
+				{
+					if (!readNumber(59, minutes))
+						return false;
+					if (consume(':') && !readNumber(59, secs))
+						return false;
+				}
+
+				seconds = sign * static_cast<int32_t>(hours * 3'600 + minutes * 60 + secs);
+				return true;
+			}
+		};
+
+		/// Days since the Unix epoch of January 1st of the given year.
+		inline int64_t yearStartDays(int year) noexcept
+		{
+			return detail::daysFromCivil(year, 1, 1);
+		}
+
+		/// First second of the given year, in UTC.
+		inline int64_t yearStartSeconds(int year) noexcept
+		{
+			return yearStartDays(year) * 86'400;
+		}
+	} // namespace
+
+	// ---- Loading ----
+
+	ONION_INLINE TimeZone TimeZone::Utc()
+	{
+		TimeZone zone;
+		zone.m_name = "UTC";
+		zone.m_initialType = zone.addType(0, false, "UTC");
+		zone.finalize();
+		return zone;
+	}
+
+	ONION_INLINE TimeZone TimeZone::Load(std::string_view name)
+	{
+		auto zone = TryLoad(name);
+		if (!zone)
+			detail::raise(std::invalid_argument("Unknown or invalid time zone: " + std::string(name)));
+
+		return std::move(*zone);
+	}
+
+	ONION_INLINE std::optional<TimeZone> TimeZone::TryLoad(std::string_view name)
+	{
+		// Names are relative to the database directory.
+		if (name.empty() || name.front() == '/' || name.find("..") != std::string_view::npos)
+			return std::nullopt;
+
+		const char* directory = std::getenv("TZDIR");
+		std::string path = directory != nullptr && *directory != '\0' ? directory : "/usr/share/zoneinfo";
+		path += '/';
+		path += name;
+
+		std::ifstream file(path, std::ios::binary);
+		if (!file)
+			return std::nullopt;
+
+		const std::string data{std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()};
+
+		TimeZone zone;
+		zone.m_name = name;
+		if (!parseTzif(data, zone))
+			return std::nullopt;
+
+		return zone;
+	}
+
+	ONION_INLINE TimeZone TimeZone::FromTzif(std::string_view name, std::string_view data)
+	{
+		TimeZone zone;
+		zone.m_name = name;
+		if (!parseTzif(data, zone))
+			detail::raise(std::invalid_argument("Invalid TZif data for time zone: " + std::string(name)));
+
+		return zone;
+	}
+
+	ONION_INLINE TimeZone TimeZone::FromPosix(std::string_view rule)
+	{
+		TimeZone zone;
+		zone.m_name = rule;
+		if (!parsePosix(rule, zone))
+			detail::raise(std::invalid_argument("Invalid POSIX TZ rule: " + std::string(rule)));
+
+		zone.finalize();
+		return zone;
+	}
+
+	ONION_INLINE bool TimeZone::parseTzif(std::string_view data, TimeZone& zone)
+	{
+		char version = 0;
+		TzifCounts counts{};
+		if (!readHeader(data, 0, version, counts))
+			return false;
+
+		// ---- Version 2+ files repeat the data with 64-bit times, followed by a POSIX TZ footer ----
+		std::size_t offset = TzifHeaderSize;
+		uint64_t timeSize = 4;
+		if (version != '\0')
+		{
+			offset += counts.dataSize(4);
+			if (!readHeader(data, offset, version, counts))
+				return false;
+			offset += TzifHeaderSize;
+			timeSize = 8;
+		}
+
+		if (counts.type == 0 || counts.type > 250 || counts.chars == 0 || counts.chars > 0xFFFF || counts.leap != 0 ||
+			(counts.isStd != 0 && counts.isStd != counts.type) || (counts.isUtc != 0 && counts.isUtc != counts.type) ||
+			data.size() - offset < counts.dataSize(timeSize))
+			return false;
+
+		const char* p = data.data() + offset;
+
+		// ---- Transition times and types ----
+		zone.m_transitions.resize(counts.time);
+		for (uint32_t i = 0; i < counts.time; ++i, p += timeSize)
+		{
+			zone.m_transitions[i] = timeSize == 8 ? readInt64(p) : static_cast<int32_t>(readUint32(p));
+			if (i > 0 && zone.m_transitions[i] <= zone.m_transitions[i - 1])
+				return false;
+		}
+
+		zone.m_transitionTypes.assign(p, p + counts.time);
+		p += counts.time;
+		for (const uint8_t type : zone.m_transitionTypes)
+			if (type >= counts.type)
+				return false;
+
+		// ---- Local time types and abbreviations ----
+		zone.m_types.resize(counts.type);
+		for (uint32_t i = 0; i < counts.type; ++i, p += 6)
+		{
+			const auto utcOffset = static_cast<int32_t>(readUint32(p));
+			const auto isDst = static_cast<unsigned char>(p[4]);
+			const auto abbreviation = static_cast<unsigned char>(p[5]);
+			if (utcOffset == std::numeric_limits<int32_t>::min() || isDst > 1 || abbreviation >= counts.chars)
+				return false;
+
+			zone.m_types[i] = LocalType{utcOffset, isDst == 1, abbreviation};
+		}
+
+		zone.m_abbreviations.assign(p, counts.chars);
+		if (zone.m_abbreviations.back() != '\0')
+			return false;
+		p += counts.chars + counts.isStd + counts.isUtc;
+
+		// Times before the first transition use type 0.
+		zone.m_initialType = 0;
+
+		// ---- Footer: "\n<POSIX TZ rule>\n" ----
+		if (timeSize == 8)
+		{
+			const std::string_view rest(p, static_cast<std::size_t>(data.data() + data.size() - p));
+			if (rest.size() < 2 || rest.front() != '\n')
+				return false;
+
+			const std::size_t close = rest.find('\n', 1);
+			if (close == std::string_view::npos)
+				return false;
+
+			const std::string_view footer = rest.substr(1, close - 1);
+			if (!footer.empty() && !parsePosix(footer, zone))
+				return false;
+		}
+
+		zone.finalize();
+		return true;
+	}
+
+	ONION_INLINE bool TimeZone::parsePosix(std::string_view rule, TimeZone& zone)
+	{
+		PosixReader reader{rule.data(), rule.data() + rule.size()};
+		PosixZone posix;
+
+		// ---- std offset [dst [offset] [,start[/time],end[/time]]] ----
+		int32_t offset = 0;
+		if (!reader.readName(posix.stdName) || !reader.readTime(24, offset))
+			return false;
+		posix.stdOffset = -offset; // POSIX offsets are positive west of Greenwich
+
+		if (reader.atEnd())
+		{
+			const uint8_t type = zone.addType(posix.stdOffset, false, posix.stdName);
+			if (zone.m_transitions.empty())
+				zone.m_initialType = type;
+			return true;
+		}
+
+		if (!reader.readName(posix.dstName))
+			return false;
+
+		posix.hasDst = true;
+		posix.dstOffset = posix.stdOffset + 3'600;
+		if (!reader.atEnd() && !reader.peek(','))
+		{
+			if (!reader.readTime(24, offset))
+				return false;
+			posix.dstOffset = -offset;
+		}
+
+		auto readDate = [](PosixReader& reader, RuleDate& date)
+		{
+			unsigned value = 0;
+			if (reader.consume('J'))
+			{
+				if (!reader.readNumber(365, value) || value == 0)
+					return false;
+				date.kind = RuleDate::Kind::Julian;
+				date.day = static_cast<uint16_t>(value);
+			}
+			else if (reader.consume('M'))
+			{
+				unsigned month = 0, week = 0, weekday = 0;
+				if (!reader.readNumber(12, month) || month == 0 || !reader.consume('.') ||
+					!reader.readNumber(5, week) || week == 0 || !reader.consume('.') || !reader.readNumber(6, weekday))
+					return false;
+				date.kind = RuleDate::Kind::MonthWeekDay;
+				date.month = static_cast<uint8_t>(month);
+				date.week = static_cast<uint8_t>(week);
+				date.day = static_cast<uint16_t>(weekday);
+			}
+			else
+			{
+				if (!reader.readNumber(365, value))
+					return false;
+				date.kind = RuleDate::Kind::ZeroBasedDay;
+				date.day = static_cast<uint16_t>(value);
+			}
+
+			// RFC 8536 extends the hours of the transition time to [-167, 167].
+			return !reader.consume('/') || reader.readTime(167, date.time);
+		};
+
+		DstRule dstRule{};
+		if (reader.atEnd())
+		{
+			// No rule: use the United States rule, as glibc does.
+			dstRule.start = RuleDate{RuleDate::Kind::MonthWeekDay, 0, 3, 2};
+			dstRule.end = RuleDate{RuleDate::Kind::MonthWeekDay, 0, 11, 1};
+		}
+		else if (!reader.consume(',') || !readDate(reader, dstRule.start) || !reader.consume(',') ||
+				 !readDate(reader, dstRule.end) || !reader.atEnd())
+		{
+			return false;
+		}
+
+		dstRule.stdType = zone.addType(posix.stdOffset, false, posix.stdName);
+		dstRule.dstType = zone.addType(posix.dstOffset, true, posix.dstName);
+		zone.m_rule = dstRule;
+		return true;
+	}
+
+	ONION_INLINE uint8_t TimeZone::addType(int32_t offset, bool isDst, std::string_view abbreviation)
+	{
+		for (std::size_t i = 0; i < m_types.size(); ++i)
+		{
+			const LocalType& type = m_types[i];
+			if (type.offset == offset && type.isDst == isDst &&
+				std::string_view(m_abbreviations.c_str() + type.abbreviation) == abbreviation)
+				return static_cast<uint8_t>(i);
+		}
+
+		m_types.push_back(LocalType{offset, isDst, static_cast<uint16_t>(m_abbreviations.size())});
+		m_abbreviations.append(abbreviation);
+		m_abbreviations.push_back('\0');
+		return static_cast<uint8_t>(m_types.size() - 1);
+	}
+
+	ONION_INLINE void TimeZone::finalize()
+	{
+		m_tableBegin = MinSeconds;
+		m_tableEnd = MaxSeconds;
+
+		// ---- Expand the rule into transitions ----
+		if (m_rule)
+		{
+			int firstYear = 0;
+			if (m_transitions.empty())
+			{
+				// A zone made of the rule alone: the table starts in 1970 and the rule also applies before it.
+				firstYear = 1970;
+				m_tableBegin = yearStartSeconds(firstYear);
+
+				int64_t instants[2];
+				uint8_t types[2];
+				ruleTransitions(firstYear - 1, instants, types);
+				m_initialType = types[1];
+			}
+			else
+			{
+				firstYear = detail::civilFromDays(detail::floorDiv(m_transitions.back(), 86'400)).year;
+			}
+
+			m_tableEnd = yearStartSeconds(ExpandedUntilYear);
+			for (int year = firstYear; year < ExpandedUntilYear; ++year)
+			{
+				int64_t instants[2];
+				uint8_t types[2];
+				ruleTransitions(year, instants, types);
+				for (int i = 0; i < 2; ++i)
+				{
+					const bool after = m_transitions.empty() ? instants[i] >= m_tableBegin
+															 : instants[i] > m_transitions.back();
+					if (after && instants[i] < m_tableEnd)
+					{
+						m_transitions.push_back(instants[i]);
+						m_transitionTypes.push_back(types[i]);
+					}
+				}
+			}
+		}
+
+		// ---- Per-year index ----
+		m_index.clear();
+		if (m_transitions.empty())
+			return;
+
+		m_indexBase = m_transitions.front();
+		const auto slots =
+			((static_cast<uint64_t>(m_transitions.back()) - static_cast<uint64_t>(m_indexBase)) >> IndexShift) + 1;
+		m_index.resize(slots);
+
+		std::size_t count = 0;
+		for (uint64_t slot = 0; slot < slots; ++slot)
+		{
+			const auto slotBegin = static_cast<int64_t>(static_cast<uint64_t>(m_indexBase) + (slot << IndexShift));
+			while (count < m_transitions.size() && m_transitions[count] <= slotBegin)
+				++count;
+			m_index[slot] = static_cast<uint32_t>(count);
+		}
+	}
+
+	// ---- Lookup ----
+
+	ONION_INLINE void TimeZone::ruleTransitions(int year, int64_t* instants, uint8_t* types) const noexcept
+	{
+		auto days = [year](const RuleDate& date) -> int64_t
+		{
+			switch (date.kind)
+			{
+				case RuleDate::Kind::Julian:
+					return yearStartDays(year) + date.day - 1 + (detail::isLeapYear(year) && date.day >= 60 ? 1 : 0);
+				case RuleDate::Kind::ZeroBasedDay:
+					return yearStartDays(year) + date.day;
+				default:
+					{
+						const int64_t first = detail::daysFromCivil(year, date.month, 1);
+						unsigned day = (date.day + 7 - detail::weekdayFromDays(first)) % 7 + (date.week - 1) * 7u;
+						if (day >= detail::daysInMonth(year, date.month))
+							day -= 7;
+						return first + day;
+					}
+			}
+		};
+
+		const DstRule& rule = *m_rule;
+		const int64_t start = days(rule.start) * 86'400 + rule.start.time - m_types[rule.stdType].offset;
+		const int64_t end = days(rule.end) * 86'400 + rule.end.time - m_types[rule.dstType].offset;
+
+		if (start <= end)
+		{
+			instants[0] = start;
+			types[0] = rule.dstType;
+			instants[1] = end;
+			types[1] = rule.stdType;
+		}
+		else
+		{
+			instants[0] = end;
+			types[0] = rule.stdType;
+			instants[1] = start;
+			types[1] = rule.dstType;
+		}
+	}
+
+	ONION_INLINE TimeZone::Period TimeZone::tablePeriod(std::size_t index) const noexcept
+	{
+		const uint8_t type = index == 0 ? m_initialType : m_transitionTypes[index - 1];
+		return Period{index == 0 ? m_tableBegin : m_transitions[index - 1],
+					  index == m_transitions.size() ? m_tableEnd : m_transitions[index],
+					  m_types[type].offset,
+					  type};
+	}
+
+	ONION_INLINE TimeZone::Period TimeZone::rulePeriod(int64_t unixSeconds) const noexcept
+	{
+		// The transitions of the year and of both neighbors bracket the instant.
+		const int year = detail::civilFromDays(detail::floorDiv(unixSeconds, 86'400)).year;
+
+		int64_t instants[6];
+		uint8_t types[6];
+		for (int i = 0; i < 3; ++i)
+			ruleTransitions(year - 1 + i, instants + 2 * i, types + 2 * i);
+
+		std::size_t index = 0;
+		while (index < 6 && instants[index] <= unixSeconds)
+			++index;
+
+		// The instant cannot precede the transitions of the previous year.
+		const uint8_t type = index == 0 ? types[5] : types[index - 1];
+		Period result{index == 0 ? MinSeconds : instants[index - 1],
+					  index == 6 ? MaxSeconds : instants[index],
+					  m_types[type].offset,
+					  type};
+
+		if (unixSeconds < m_tableBegin)
+			result.end = std::min(result.end, m_tableBegin);
+		else
+			result.begin = std::max(result.begin, m_tableEnd);
+		return result;
+	}
+
+	ONION_INLINE TimeZone::Period TimeZone::period(int64_t unixSeconds) const noexcept
+	{
+		if (unixSeconds < m_tableBegin || unixSeconds >= m_tableEnd)
+			return rulePeriod(unixSeconds);
+
+		if (m_transitions.empty() || unixSeconds < m_indexBase)
+			return tablePeriod(0);
+
+		// The slot gives the number of transitions up to its start; a slot holds at most a few more.
+		auto slot = (static_cast<uint64_t>(unixSeconds) - static_cast<uint64_t>(m_indexBase)) >> IndexShift;
+		slot = std::min<uint64_t>(slot, m_index.size() - 1);
+
+		std::size_t index = m_index[slot];
+		while (index < m_transitions.size() && m_transitions[index] <= unixSeconds)
+			++index;
+
+		return tablePeriod(index);
+	}
+
+	ONION_INLINE int64_t TimeZone::fromLocalSeconds(int64_t localSeconds, LocalTimeChoice choice) const noexcept
+	{
+		// The UTC instant is within a day of the local time, so it is in the period found by using the local
+		// time as UTC, or in one of its neighbors.
+		const Period guess = period(localSeconds - period(localSeconds).offset);
+
+		Period candidates[3];
+		std::size_t count = 0;
+		if (guess.begin != MinSeconds)
+			candidates[count++] = period(guess.begin - 1);
+		candidates[count++] = guess;
+		if (guess.end != MaxSeconds)
+			candidates[count++] = period(guess.end);
+
+		auto contains = [localSeconds](const Period& p)
+		{
+			const int64_t utc = localSeconds - p.offset;
+			return utc >= p.begin && utc < p.end;
+		};
+
+		// ---- Unique or repeated local time ----
+		const Period* earliest = nullptr;
+		const Period* latest = nullptr;
+		for (std::size_t i = 0; i < count; ++i)
+		{
+			if (contains(candidates[i]))
+			{
+				if (earliest == nullptr)
+					earliest = &candidates[i];
+				latest = &candidates[i];
+			}
+		}
+
+		if (earliest != nullptr)
+			return localSeconds - (choice == LocalTimeChoice::Earliest ? earliest : latest)->offset;
+
+		// ---- Skipped local time: keep the offset from before the gap ----
+		for (std::size_t i = 0; i + 1 < count; ++i)
+		{
+			const Period& before = candidates[i];
+			const Period& after = candidates[i + 1];
+			if (localSeconds - before.offset >= before.end && localSeconds - after.offset < after.begin)
+				return localSeconds - before.offset;
+		}
+
+		return localSeconds - guess.offset;
+	}
+
+	// ---- Conversions ----
+
+	ONION_INLINE TimeSpan TimeZone::utcOffset(const DateTime& utc) const noexcept
+	{
+		return TimeSpan::FromSeconds(utcOffsetSeconds(utc.toUnixSeconds()));
+	}
+
+	ONION_INLINE bool TimeZone::isDaylightSavingTime(const DateTime& utc) const noexcept
+	{
+		return m_types[period(utc.toUnixSeconds()).type].isDst;
+	}
+
+	ONION_INLINE std::string_view TimeZone::abbreviation(const DateTime& utc) const noexcept
+	{
+		return m_abbreviations.c_str() + m_types[period(utc.toUnixSeconds()).type].abbreviation;
+	}
+
+	ONION_INLINE DateTime TimeZone::toLocal(const DateTime& utc) const
+	{
+		const int64_t unixMillis = utc.toUnixMillis();
+		return DateTime::FromUnixMillis(unixMillis + int64_t{utcOffsetSeconds(utc.toUnixSeconds())} * 1'000);
+	}
+
+	ONION_INLINE DateTime TimeZone::fromLocal(const DateTime& local, LocalTimeChoice choice) const
+	{
+		const int64_t localMillis = local.toUnixMillis();
+		const int64_t localSeconds = local.toUnixSeconds();
+		const int64_t unixSeconds = fromLocalSeconds(localSeconds, choice);
+		return DateTime::FromUnixMillis(localMillis + (unixSeconds - localSeconds) * 1'000);
+	}
+
+	ONION_INLINE void TimeZone::toLocal(std::span<const DateTime> utc, std::span<DateTime> out) const
+	{
+		if (out.size() < utc.size())
+			detail::raise(std::invalid_argument("TimeZone::toLocal: output column is shorter than the input"));
+
+		Period current{0, 0, 0, 0};
+		for (std::size_t i = 0; i < utc.size(); ++i)
+		{
+			const int64_t unixSeconds = utc[i].toUnixSeconds();
+			if (unixSeconds < current.begin || unixSeconds >= current.end)
+				current = period(unixSeconds);
+
+			out[i] = DateTime::FromUnixMillis(utc[i].toUnixMillis() + int64_t{current.offset} * 1'000);
+		}
+	}
+
+	ONION_INLINE void TimeZone::fromLocal(std::span<const DateTime> local,
+										  std::span<DateTime> out,
+										  LocalTimeChoice choice) const
+	{
+		if (out.size() < local.size())
+			detail::raise(std::invalid_argument("TimeZone::fromLocal: output column is shorter than the input"));
+
+		// A local time whose UTC instant is more than a day away from the ends of its period cannot be in
+		// another period, so consecutive local times in the middle of the same period skip the full resolution.
+		Period current{0, 0, 0, 0};
+		for (std::size_t i = 0; i < local.size(); ++i)
+		{
+			const int64_t localSeconds = local[i].toUnixSeconds();
+			int64_t unixSeconds = localSeconds - current.offset;
+			if (unixSeconds < current.begin + 86'400 || unixSeconds >= current.end - 86'400)
+			{
+				unixSeconds = fromLocalSeconds(localSeconds, choice);
+				current = period(unixSeconds);
+			}
+
+			out[i] = DateTime::FromUnixMillis(local[i].toUnixMillis() + (unixSeconds - localSeconds) * 1'000);
+		}
+	}
+
+} // namespace onion
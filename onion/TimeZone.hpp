@@ -0,0 +1,202 @@
+#pragma once
+
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "Config.hpp"
+#include "DateTime.hpp"
+
+namespace onion
+{
+	/// How `TimeZone::fromLocal` resolves a local time that occurs twice, when the clocks are set back.
+	enum class LocalTimeChoice
+	{
+		Earliest, ///< The first occurrence, e.g. the daylight saving time one in autumn.
+		Latest,	  ///< The second occurrence.
+	};
+
+	/// A time zone, loaded once into a compact table of UTC offset transitions.
+	///
+	/// Zones are read from TZif files (RFC 8536), as installed in `/usr/share/zoneinfo`, or built from a POSIX TZ
+	/// rule such as "CET-1CEST,M3.5.0,M10.5.0/3". The recurring rule of a TZif file is expanded into explicit
+	/// transitions up to `ExpandedUntilYear` when loading, and evaluated on the fly beyond it.
+	///
+	/// Lookups do not allocate, lock or parse: a per-year index over the transitions points to the first
+	/// candidate, so finding the offset of an instant is a table read followed by at most a few comparisons.
+	/// A TimeZone is immutable, so a single instance can be shared between threads.
+	///
+	/// Local times are represented as DateTimes holding the wall clock time, e.g.:
+	///   const TimeZone paris = TimeZone::Load("Europe/Paris");
+	///   DateTime local = paris.toLocal(DateTime::UtcNow());
+	///   DateTime utc = paris.fromLocal(local);
+	class TimeZone
+	{
+	  public:
+		/// Year until which the recurring rule of a zone is precomputed into transitions.
+		static constexpr int ExpandedUntilYear = 2200;
+
+	  public:
+		/// Returns the UTC time zone.
+		static TimeZone Utc();
+
+		/// Loads a zone from the time zone database, e.g. "Europe/Paris" or "America/New_York".
+		///
+		/// The file is read from the directory named by the `TZDIR` environment variable, or from
+		/// `/usr/share/zoneinfo`.
+		/// @param name IANA name of the zone.
+		/// @throws std::invalid_argument If the zone does not exist or its file is not a valid TZif file.
+		static TimeZone Load(std::string_view name);
+
+		/// Loads a zone from the time zone database without throwing.
+		/// @return The zone, or `std::nullopt` if it does not exist or its file is not valid.
+		static std::optional<TimeZone> TryLoad(std::string_view name);
+
+		/// Creates a zone from the contents of a TZif file (RFC 8536, versions 1 to 4).
+		/// Files with leap second records (the "right/" zones) are rejected.
+		/// @param name Name reported by `name()`.
+		/// @param data The bytes of the file.
+		/// @throws std::invalid_argument If the data is not a valid TZif file.
+		static TimeZone FromTzif(std::string_view name, std::string_view data);
+
+		/// Creates a zone from a POSIX TZ rule, e.g. "EST5EDT,M3.2.0,M11.1.0" or "<+0530>-5:30".
+		/// @throws std::invalid_argument If the rule is not valid.
+		static TimeZone FromPosix(std::string_view rule);
+
+	  public:
+		/// Returns the name the zone was loaded with.
+		const std::string& name() const noexcept { return m_name; }
+
+		/// Returns the offset from UTC, in seconds, at the given instant.
+		/// @param unixSeconds Seconds since 1970-01-01T00:00:00Z.
+		int32_t utcOffsetSeconds(int64_t unixSeconds) const noexcept { return period(unixSeconds).offset; }
+
+		/// Returns the offset from UTC at the given instant.
+		TimeSpan utcOffset(const DateTime& utc) const noexcept;
+
+		/// Returns true if daylight saving time is in effect at the given instant.
+		bool isDaylightSavingTime(const DateTime& utc) const noexcept;
+
+		/// Returns the abbreviation in effect at the given instant, e.g. "CEST".
+		std::string_view abbreviation(const DateTime& utc) const noexcept;
+
+		/// Converts a UTC DateTime to the local wall clock time of the zone.
+		/// @throws std::out_of_range If the local time is outside the DateTime range.
+		DateTime toLocal(const DateTime& utc) const;
+
+		/// Converts a local wall clock time of the zone to UTC.
+		///
+		/// A local time that occurs twice is resolved by `choice`. A local time skipped when the clocks are set
+		/// forward is moved forward by the length of the gap, e.g. 02:30 becomes 03:30 on a one hour gap.
+		/// @throws std::out_of_range If the UTC time is outside the DateTime range.
+		DateTime fromLocal(const DateTime& local, LocalTimeChoice choice = LocalTimeChoice::Earliest) const;
+
+		/// Converts a column of UTC DateTimes to local times, like `toLocal`.
+		/// Consecutive instants in the same offset period reuse the previous lookup.
+		/// @throws std::invalid_argument If `out` is shorter than `utc`.
+		/// @throws std::out_of_range If a local time is outside the DateTime range.
+		void toLocal(std::span<const DateTime> utc, std::span<DateTime> out) const;
+
+		/// Converts a column of local times to UTC DateTimes, like `fromLocal`.
+		/// @throws std::invalid_argument If `out` is shorter than `local`.
+		/// @throws std::out_of_range If a UTC time is outside the DateTime range.
+		void fromLocal(std::span<const DateTime> local,
+					   std::span<DateTime> out,
+					   LocalTimeChoice choice = LocalTimeChoice::Earliest) const;
+
+	  private:
+		/// A local time type of the zone.
+		struct LocalType
+		{
+			int32_t offset;		   // seconds east of UTC
+			bool isDst;
+			uint16_t abbreviation; // index in m_abbreviations
+		};
+
+		/// A half-open range of instants [begin, end) with a single local time type.
+		struct Period
+		{
+			int64_t begin;
+			int64_t end;
+			int32_t offset;
+			uint8_t type;
+		};
+
+		/// A POSIX TZ rule date: Jn, n or Mm.w.d, followed by a time of day.
+		struct RuleDate
+		{
+			enum class Kind : uint8_t
+			{
+				Julian,		   // Jn, 1-based, February 29th is never counted
+				ZeroBasedDay,  // n, 0-based, February 29th is counted
+				MonthWeekDay,  // Mm.w.d
+			};
+
+			Kind kind = Kind::MonthWeekDay;
+			uint16_t day = 0;
+			uint8_t month = 0;
+			uint8_t week = 0;
+			int32_t time = 2 * 3'600; // seconds after local midnight, may be negative or exceed a day
+		};
+
+		/// The recurring daylight saving time rule of a zone.
+		struct DstRule
+		{
+			uint8_t stdType;
+			uint8_t dstType;
+			RuleDate start;
+			RuleDate end;
+		};
+
+		static constexpr int64_t MinSeconds = std::numeric_limits<int64_t>::min();
+		static constexpr int64_t MaxSeconds = std::numeric_limits<int64_t>::max();
+
+		/// Width of a slot of the per-year index: 2^25 seconds, a little over a year.
+		static constexpr int IndexShift = 25;
+
+		TimeZone() = default;
+
+		static bool parseTzif(std::string_view data, TimeZone& zone);
+		static bool parsePosix(std::string_view rule, TimeZone& zone);
+		uint8_t addType(int32_t offset, bool isDst, std::string_view abbreviation);
+
+		/// Appends the transitions of the rule until `ExpandedUntilYear`, and builds the per-year index.
+		void finalize();
+
+		/// Writes the two transitions of the rule in the given year, in UTC seconds and chronological order.
+		void ruleTransitions(int year, int64_t* instants, uint8_t* types) const noexcept;
+
+		Period period(int64_t unixSeconds) const noexcept;
+		Period rulePeriod(int64_t unixSeconds) const noexcept;
+		Period tablePeriod(std::size_t index) const noexcept;
+
+		/// Converts local seconds to UTC seconds.
+		int64_t fromLocalSeconds(int64_t localSeconds, LocalTimeChoice choice) const noexcept;
+
+	  private:
+		std::string m_name;
+		std::vector<LocalType> m_types;
+		std::string m_abbreviations; // NUL-terminated abbreviations
+
+		std::vector<int64_t> m_transitions;		  // UTC seconds, sorted
+		std::vector<uint8_t> m_transitionTypes;	  // type in effect from each transition on
+		uint8_t m_initialType = 0;				  // type in effect before the first transition
+
+		std::vector<uint32_t> m_index; // number of transitions <= m_indexBase + (slot << IndexShift)
+		int64_t m_indexBase = 0;
+
+		// The table is exact in [m_tableBegin, m_tableEnd); the rule is evaluated outside of it.
+		int64_t m_tableBegin = MinSeconds;
+		int64_t m_tableEnd = MaxSeconds;
+		std::optional<DstRule> m_rule;
+	};
+
+} // namespace onion
+
+#ifdef ONION_HEADER_ONLY
+#include "TimeZone.cpp"
+#endif
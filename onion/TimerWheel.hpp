@@ -0,0 +1,335 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <chrono>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "Config.hpp"
+#include "DateTime.hpp"
+#include "TimeSpan.hpp"
+
+namespace onion
+{
+	// ---- Hierarchical timing wheel ----
+	// Time is counted in ticks of `resolution` since the start of the wheel. Level L has 256 slots of 256^L ticks,
+	// and a timer goes into the level of the highest byte where its deadline differs from the current tick, at the
+	// slot given by that byte of the deadline. Scheduling is therefore O(1), and advancing visits only occupied
+	// slots, found through a bitmap per level: a level-0 slot holds timers due at exactly its tick, and reaching the
+	// start of a higher slot moves its timers to lower levels (each timer moves at most once per level). Seven
+	// levels cover the whole DateTime range at 1 ms.
+	//
+	// A slot is an array of (deadline, timer) entries rather than a linked list, so moving and expiring timers
+	// reads memory sequentially and prefetches the timers ahead. Timers live in a pool and know their slot and
+	// position in it, so cancelling is an O(1) swap with the slot's last entry. A handle is a pool index and a
+	// generation that is bumped when the timer is released, which makes stale handles harmless.
+
+	/// A timer scheduler keyed on DateTime: O(1) `schedule` and `cancel`, and `advance`, which hands back every
+	/// timer due up to a given instant, in order of due tick.
+	///
+	/// Timers fire at the first tick at or after their due time, so never early and at most one resolution late.
+	/// The wheel is not thread-safe.
+	///
+	/// Example:
+	///   onion::TimerWheel<SessionId> expiry(onion::DateTime::UtcNow());
+	///   auto handle = expiry.schedule(onion::DateTime::UtcNow() + onion::TimeSpan::FromSeconds(30), session);
+	///   expiry.cancel(handle); // the session was renewed
+	///   expiry.advance(onion::DateTime::UtcNow(), [](SessionId expired) { close(expired); });
+	///
+	/// @tparam T Type of the timer payload, handed back on expiry: default constructible and movable.
+	template <typename T> class TimerWheel
+	{
+		static constexpr uint32_t Nil = UINT32_MAX;
+
+	  public:
+		/// Identifies a scheduled timer. A handle stays valid, but no longer matches, once its timer fired or was
+		/// cancelled.
+		struct Handle
+		{
+			uint32_t index = Nil;
+			uint32_t generation = 0;
+
+			friend bool operator==(const Handle&, const Handle&) = default;
+		};
+
+		/// Creates an empty wheel whose current time is `start`.
+		/// @throws std::invalid_argument If `resolution` is shorter than 1 ms.
+		explicit TimerWheel(const DateTime& start, const TimeSpan& resolution = TimeSpan::FromMilliseconds(1))
+			: m_origin(start.toUnixMillis()),
+			  m_resolution(std::chrono::duration_cast<std::chrono::milliseconds>(resolution.GetDuration()).count())
+		{
+			if (m_resolution <= 0)
+				detail::raise(std::invalid_argument("TimerWheel: resolution is shorter than 1 ms"));
+		}
+
+		/// Schedules `value` to be handed back by the first `advance` to reach `due`. A timer due at or before
+		/// `now()` is handed back by the next `advance`, or by the current one when scheduled from its callback.
+		/// @throws std::length_error If 2^32 - 1 timers are pending.
+		Handle schedule(const DateTime& due, T value)
+		{
+			const uint32_t index = allocate();
+			m_nodes[index].value = std::move(value);
+			place(Entry{deadlineOf(due), index});
+			++m_size;
+			return Handle{index, m_nodes[index].generation};
+		}
+
+		/// Cancels a pending timer, destroying its payload.
+		/// @return false if the timer already fired or was cancelled.
+		bool cancel(const Handle& handle)
+		{
+			if (!contains(handle))
+				return false;
+
+			remove(handle.index);
+			m_nodes[handle.index].value = T();
+			release(handle.index);
+			--m_size;
+			return true;
+		}
+
+		/// Returns whether the timer of `handle` is still pending.
+		bool contains(const Handle& handle) const noexcept
+		{
+			return handle.index < m_nodes.size() && m_nodes[handle.index].generation == handle.generation &&
+				   m_nodes[handle.index].slot != Nil;
+		}
+
+		/// Moves the current time to `until` (it never moves back) and calls `onExpired(T&&)` for every timer due
+		/// up to then, in order of due tick. `onExpired` may schedule and cancel timers, and timers it schedules
+		/// for at most `until` are handed back by the same call.
+		/// @return The number of expired timers.
+		template <typename F>
+			requires std::invocable<F&, T&&>
+		std::size_t advance(const DateTime& until, F&& onExpired)
+		{
+			const int64_t elapsed = until.toUnixMillis() - m_origin;
+			const auto target = static_cast<uint64_t>(elapsed > 0 ? elapsed / m_resolution : 0);
+
+			std::size_t expired = fire(DueSlot, onExpired);
+			while (m_size > 0)
+			{
+				const auto [level, slot] = nextOccupied();
+				if (level == Levels)
+					break;
+
+				const unsigned shift = SlotBits * level;
+				const uint64_t tick = (m_now >> (shift + SlotBits) << (shift + SlotBits)) | (uint64_t{slot} << shift);
+				if (tick > target)
+					break;
+
+				m_now = tick;
+				if (level == 0)
+					expired += fire(slot, onExpired);
+				else
+					cascade(level * SlotCount + slot);
+				expired += fire(DueSlot, onExpired);
+			}
+
+			m_now = std::max(m_now, target);
+			return expired;
+		}
+
+		/// Appends the payloads of the timers due up to `until` to `expired`, as the callback overload.
+		std::size_t advance(const DateTime& until, std::vector<T>& expired)
+		{
+			return advance(until, [&expired](T&& value) { expired.push_back(std::move(value)); });
+		}
+
+		/// Returns the current time: the start of the wheel plus the ticks advanced.
+		DateTime now() const { return DateTime::FromUnixMillis(m_origin + static_cast<int64_t>(m_now) * m_resolution); }
+
+		/// Returns the tick length.
+		TimeSpan resolution() const noexcept { return TimeSpan::FromMilliseconds(m_resolution); }
+
+		/// Returns the number of pending timers.
+		std::size_t size() const noexcept { return m_size; }
+		bool empty() const noexcept { return m_size == 0; }
+
+		/// Reserves room for `timers` pending timers, so that scheduling them does not reallocate the pool.
+		void reserve(std::size_t timers) { m_nodes.reserve(timers); }
+
+	  private:
+		static constexpr unsigned SlotBits = 8;
+		static constexpr uint32_t SlotCount = 1u << SlotBits;
+		static constexpr unsigned Levels = 7;
+
+		// Slots [0, Levels * SlotCount) belong to the levels; the last one holds the timers due now.
+		static constexpr uint32_t DueSlot = Levels * SlotCount;
+
+		// Timers are prefetched this many entries ahead when a slot is moved or expired.
+		static constexpr std::size_t PrefetchDistance = 8;
+
+		struct Entry
+		{
+			uint64_t deadline; // tick
+			uint32_t index;
+		};
+
+		struct Node
+		{
+			uint32_t slot = Nil;	 // Nil when the node is free
+			uint32_t position = 0; // in the slot, or the next free node
+			uint32_t generation = 0;
+			T value{};
+		};
+
+		struct Position
+		{
+			unsigned level;
+			uint32_t slot;
+		};
+
+		static void prefetch(const void* address) noexcept
+		{
+#if defined(__GNUC__) || defined(__clang__)
+			__builtin_prefetch(address);
+#else
+			(void)address;
+#endif
+		}
+
+		uint64_t deadlineOf(const DateTime& due) const noexcept
+		{
+			const int64_t elapsed = due.toUnixMillis() - m_origin;
+			return elapsed > 0 ? static_cast<uint64_t>(elapsed + m_resolution - 1) / static_cast<uint64_t>(m_resolution)
+							   : 0;
+		}
+
+		uint32_t allocate()
+		{
+			if (m_free != Nil)
+			{
+				const uint32_t index = m_free;
+				m_free = m_nodes[index].position;
+				return index;
+			}
+			if (m_nodes.size() >= Nil)
+				detail::raise(std::length_error("TimerWheel: too many pending timers"));
+			m_nodes.emplace_back();
+			return static_cast<uint32_t>(m_nodes.size() - 1);
+		}
+
+		void release(uint32_t index) noexcept
+		{
+			Node& node = m_nodes[index];
+			++node.generation;
+			node.slot = Nil;
+			node.position = m_free;
+			m_free = index;
+		}
+
+		void setOccupied(uint32_t slot) noexcept { m_occupied[slot / 64] |= uint64_t{1} << (slot % 64); }
+		void clearOccupied(uint32_t slot) noexcept { m_occupied[slot / 64] &= ~(uint64_t{1} << (slot % 64)); }
+
+		/// Appends an entry to the slot of its deadline, relative to the current tick.
+		void place(const Entry& entry)
+		{
+			uint32_t slot = DueSlot;
+			if (entry.deadline > m_now)
+			{
+				const auto level = static_cast<unsigned>(std::bit_width(entry.deadline ^ m_now) - 1) / SlotBits;
+				const auto byte = static_cast<uint32_t>(entry.deadline >> (SlotBits * level)) & (SlotCount - 1);
+				slot = level * SlotCount + byte;
+				setOccupied(slot);
+			}
+
+			std::vector<Entry>& entries = m_slots[slot];
+			m_nodes[entry.index].slot = slot;
+			m_nodes[entry.index].position = static_cast<uint32_t>(entries.size());
+			entries.push_back(entry);
+		}
+
+		/// Removes a timer's entry from its slot, moving the slot's last entry into its place.
+		void remove(uint32_t index) noexcept
+		{
+			const Node& node = m_nodes[index];
+			std::vector<Entry>& entries = m_slots[node.slot];
+			entries[node.position] = entries.back();
+			m_nodes[entries[node.position].index].position = node.position;
+			entries.pop_back();
+			if (entries.empty() && node.slot != DueSlot)
+				clearOccupied(node.slot);
+		}
+
+		/// Returns the first occupied slot after the current tick: slots of lower levels always come first, and a
+		/// level only holds slots after its current one. Returns level `Levels` if the wheel is empty.
+		Position nextOccupied() const noexcept
+		{
+			for (unsigned level = 0; level < Levels; ++level)
+			{
+				const auto current = static_cast<uint32_t>(m_now >> (SlotBits * level)) & (SlotCount - 1);
+				const uint64_t* words = m_occupied + level * SlotCount / 64;
+				for (uint32_t word = (current + 1) / 64; current < SlotCount - 1 && word < SlotCount / 64; ++word)
+				{
+					uint64_t bits = words[word];
+					if (word == (current + 1) / 64)
+						bits &= ~uint64_t{0} << ((current + 1) % 64);
+					if (bits != 0)
+						return {level, word * 64 + static_cast<uint32_t>(std::countr_zero(bits))};
+				}
+			}
+			return {Levels, 0};
+		}
+
+		/// Moves the timers of a higher-level slot that the current tick just reached to lower levels, or to the
+		/// due slot. Frees the slot's memory, as a higher slot is only refilled after the wheel went around.
+		void cascade(uint32_t slot)
+		{
+			std::vector<Entry> entries;
+			entries.swap(m_slots[slot]);
+			clearOccupied(slot);
+
+			for (std::size_t i = 0; i < entries.size(); ++i)
+			{
+				if (i + PrefetchDistance < entries.size())
+					prefetch(&m_nodes[entries[i + PrefetchDistance].index]);
+				place(entries[i]);
+			}
+		}
+
+		/// Hands back the timers of a slot due now, from its end, so that the callback can cancel timers of the
+		/// slot, and timers it schedules for now (appended to the due slot) are handed back too.
+		template <typename F> std::size_t fire(uint32_t slot, F& onExpired)
+		{
+			std::vector<Entry>& entries = m_slots[slot];
+			std::size_t fired = 0;
+			while (!entries.empty())
+			{
+				if (entries.size() > PrefetchDistance)
+					prefetch(&m_nodes[entries[entries.size() - 1 - PrefetchDistance].index]);
+
+				const uint32_t index = entries.back().index;
+				entries.pop_back();
+				if (entries.empty() && slot != DueSlot)
+					clearOccupied(slot);
+
+				T value = std::move(m_nodes[index].value);
+				release(index);
+				--m_size;
+				++fired;
+				// After the timer is released, as the callback may schedule timers and reallocate the pool.
+				onExpired(std::move(value));
+			}
+			return fired;
+		}
+
+	  private:
+		int64_t m_origin;	  // Unix milliseconds of tick 0
+		int64_t m_resolution; // milliseconds per tick
+		uint64_t m_now = 0;	  // current tick
+
+		std::vector<Node> m_nodes;
+		uint32_t m_free = Nil;
+		std::size_t m_size = 0;
+
+		std::vector<Entry> m_slots[DueSlot + 1];
+		uint64_t m_occupied[DueSlot / 64] = {};
+	};
+
+} // namespace onion
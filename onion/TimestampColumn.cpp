@@ -0,0 +1,305 @@
+#include "TimestampColumn.hpp"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <stdexcept>
+
+#include "Config.hpp"
+#include "detail/Varint.hpp"
+
+namespace onion
+{
+	namespace
+	{
+		// ---- Codes ----
+		// Class k of a delta-of-delta is written as k one bits, a zero bit unless k is 4, then a zigzag payload.
+
+		constexpr std::array<uint64_t, 5> PrefixBits = {0b0, 0b01, 0b011, 0b0111, 0b1111};
+		constexpr std::array<unsigned, 5> PrefixLength = {1, 2, 3, 4, 4};
+		constexpr std::array<unsigned, 5> PayloadLength = {0, 7, 9, 12, 64};
+		constexpr std::array<uint64_t, 5> PayloadMask = {0, 0x7F, 0x1FF, 0xFFF, ~uint64_t{0}};
+		constexpr unsigned EscapeClass = 4;
+
+		/// Code length, payload shift and payload mask, indexed by the first 4 bits of a code.
+		struct CodeLayout
+		{
+			uint8_t length;
+			uint8_t shift;
+			uint16_t mask;
+		};
+
+		constexpr std::array<CodeLayout, 16> CodeLayouts = []()
+		{
+			std::array<CodeLayout, 16> layouts{};
+			for (unsigned bits = 0; bits < 16; ++bits)
+			{
+				const auto kind = static_cast<unsigned>(std::countr_one(bits));
+				layouts[bits].length = static_cast<uint8_t>(PrefixLength[kind] + PayloadLength[kind]);
+				layouts[bits].shift = static_cast<uint8_t>(PrefixLength[kind]);
+				layouts[bits].mask = kind == EscapeClass ? 0 : static_cast<uint16_t>(PayloadMask[kind]);
+			}
+			return layouts;
+		}();
+
+		/// Runs of unchanged deltas shorter than this many values are decoded one code at a time.
+		constexpr uint64_t RunMask = 0xFF;
+
+		/// Class of a zigzag payload, indexed by its bit width.
+		constexpr std::array<uint8_t, 65> ClassOfWidth = []()
+		{
+			std::array<uint8_t, 65> classes{};
+			for (unsigned width = 1; width <= 64; ++width)
+				classes[width] = width <= 7 ? 1 : width <= 9 ? 2 : width <= 12 ? 3 : 4;
+			return classes;
+		}();
+
+		/// Sequential decoder of the values of a block, after the first one.
+		struct BlockReader
+		{
+			const uint64_t* words;
+			uint64_t position;
+			int64_t value; // Unix milliseconds of the last decoded value
+			int64_t delta = 0;
+
+			/// Returns the 64 bits starting at `bitPosition`. The word after the last code is always readable.
+			uint64_t peek(uint64_t bitPosition) const noexcept
+			{
+				const uint64_t* word = words + (bitPosition >> 6);
+				const unsigned offset = bitPosition & 63;
+				return word[0] >> offset | (word[1] << 1) << (63 - offset);
+			}
+
+			/// Decodes the next value from the bits at the current position.
+			void readCode(uint64_t bits) noexcept
+			{
+				const CodeLayout layout = CodeLayouts[bits & 0xF];
+				uint64_t zigzag = bits >> layout.shift & layout.mask;
+				if ((bits & 0xF) == PrefixBits[EscapeClass]) [[unlikely]]
+					zigzag = peek(position + PrefixLength[EscapeClass]);
+				position += layout.length;
+				delta += detail::unzigzag(zigzag);
+				value += delta;
+			}
+
+			/// Decodes the next `count` values, writing them to `out` if `Emit` is true.
+			template <bool Emit> void read(DateTime* __restrict out, std::size_t count) noexcept
+			{
+				while (count != 0)
+				{
+					const uint64_t bits = peek(position);
+					if ((bits & RunMask) == 0)
+					{
+						// A run of unchanged deltas, one bit each.
+						const auto run = std::min<std::size_t>(count, static_cast<std::size_t>(std::countr_zero(bits)));
+						if constexpr (Emit)
+						{
+							for (std::size_t i = 0; i < run; ++i)
+								out[i] = std::bit_cast<DateTime>(value + delta * static_cast<int64_t>(i + 1));
+							out += run;
+						}
+						value += delta * static_cast<int64_t>(run);
+						position += run;
+						count -= run;
+					}
+					else
+					{
+						// Irregular values: one code at a time, without branching on its class.
+						readCode(bits);
+						if constexpr (Emit)
+							*out++ = std::bit_cast<DateTime>(value);
+						--count;
+					}
+				}
+			}
+
+			/// Decodes values of a non-decreasing block until one is not less than `target`, which the last decoded
+			/// value is less than. Returns the number of values decoded, or `count + 1` if none of the next `count` is.
+			std::size_t seek(int64_t target, std::size_t count) noexcept
+			{
+				std::size_t index = 0;
+				while (index != count)
+				{
+					const uint64_t bits = peek(position);
+					if ((bits & RunMask) == 0)
+					{
+						const auto run =
+							std::min<std::size_t>(count - index, static_cast<std::size_t>(std::countr_zero(bits)));
+						const int64_t runEnd = value + delta * static_cast<int64_t>(run);
+						if (runEnd >= target)
+						{
+							// delta > 0 here, since value < target.
+							return index + static_cast<std::size_t>((target - value + delta - 1) / delta);
+						}
+						value = runEnd;
+						position += run;
+						index += run;
+					}
+					else
+					{
+						readCode(bits);
+						++index;
+						if (value >= target)
+							return index;
+					}
+				}
+				return count + 1;
+			}
+		};
+	} // namespace
+
+	// ---- Appending ----
+
+	ONION_INLINE void TimestampColumn::writeBits(uint64_t bits, unsigned length)
+	{
+		const std::size_t index = m_bitSize >> 6;
+		const unsigned offset = m_bitSize & 63;
+
+		// Keeps a zero word after the last code, so that readers can always load two words.
+		if (m_words.size() < index + 3)
+			m_words.resize(index + 3);
+
+		m_words[index] |= bits << offset;
+		if (offset + length > 64)
+			m_words[index + 1] |= bits >> (64 - offset);
+		m_bitSize += length;
+	}
+
+	ONION_INLINE void TimestampColumn::append(const DateTime& dateTime)
+	{
+		const int64_t unixMillis = dateTime.toUnixMillis();
+		if (m_size % BlockSize == 0)
+		{
+			m_blocks.push_back(Block{unixMillis, m_bitSize, 1});
+			m_lastDelta = 0;
+		}
+		else
+		{
+			// Both values are within the DateTime range, so neither difference can overflow.
+			const int64_t delta = unixMillis - m_last;
+			const uint64_t zigzag = detail::zigzag(delta - m_lastDelta);
+			const unsigned kind = zigzag == 0 ? 0 : ClassOfWidth[static_cast<std::size_t>(std::bit_width(zigzag))];
+			if (kind != EscapeClass) [[likely]]
+				writeBits(PrefixBits[kind] | zigzag << PrefixLength[kind], PrefixLength[kind] + PayloadLength[kind]);
+			else
+			{
+				writeBits(PrefixBits[kind], PrefixLength[kind]);
+				writeBits(zigzag, PayloadLength[kind]);
+			}
+
+			m_lastDelta = delta;
+			++m_blocks.back().count;
+		}
+
+		m_sorted = m_sorted && (m_size == 0 || unixMillis >= m_last);
+		m_last = unixMillis;
+		++m_size;
+	}
+
+	ONION_INLINE void TimestampColumn::append(std::span<const DateTime> dateTimes)
+	{
+		for (const DateTime& dateTime : dateTimes)
+			append(dateTime);
+	}
+
+	ONION_INLINE void TimestampColumn::clear() noexcept
+	{
+		m_blocks.clear();
+		m_words.clear();
+		m_bitSize = 0;
+		m_size = 0;
+		m_last = 0;
+		m_lastDelta = 0;
+		m_sorted = true;
+	}
+
+	ONION_INLINE void TimestampColumn::shrinkToFit()
+	{
+		if (!m_words.empty())
+			m_words.resize((m_bitSize >> 6) + 2);
+		m_words.shrink_to_fit();
+		m_blocks.shrink_to_fit();
+	}
+
+	// ---- Reading ----
+
+	ONION_INLINE std::size_t TimestampColumn::compressedBytes() const noexcept
+	{
+		return static_cast<std::size_t>((m_bitSize + 7) / 8) + m_blocks.size() * sizeof(Block);
+	}
+
+	ONION_INLINE DateTime TimestampColumn::at(std::size_t index) const
+	{
+		if (index >= m_size)
+			detail::raise(std::out_of_range("TimestampColumn: index out of range"));
+
+		const Block& block = m_blocks[index / BlockSize];
+		BlockReader reader{m_words.data(), block.bitOffset, block.first};
+		reader.read<false>(nullptr, index % BlockSize);
+		return std::bit_cast<DateTime>(reader.value);
+	}
+
+	ONION_INLINE DateTime TimestampColumn::back() const
+	{
+		if (m_size == 0)
+			detail::raise(std::out_of_range("TimestampColumn: column is empty"));
+
+		return std::bit_cast<DateTime>(m_last);
+	}
+
+	ONION_INLINE std::size_t TimestampColumn::lowerBound(const DateTime& dateTime) const noexcept
+	{
+		const int64_t target = dateTime.toUnixMillis();
+		const auto next = std::partition_point(
+			m_blocks.begin(), m_blocks.end(), [target](const Block& block) { return block.first < target; });
+		if (next == m_blocks.begin())
+			return 0;
+
+		// The first value of the previous block is less than the target; the bound is in the rest of it or at `next`.
+		const auto blockIndex = static_cast<std::size_t>(next - m_blocks.begin()) - 1;
+		const Block& block = m_blocks[blockIndex];
+		BlockReader reader{m_words.data(), block.bitOffset, block.first};
+		return blockIndex * BlockSize + reader.seek(target, block.count - 1);
+	}
+
+	ONION_INLINE void TimestampColumn::decode(std::size_t first, std::span<DateTime> out) const
+	{
+		if (first > m_size || out.size() > m_size - first)
+			detail::raise(std::out_of_range("TimestampColumn: range out of bounds"));
+
+		DateTime* it = out.data();
+		std::size_t remaining = out.size();
+		std::size_t blockIndex = first / BlockSize;
+		std::size_t offset = first % BlockSize;
+		while (remaining != 0)
+		{
+			const Block& block = m_blocks[blockIndex++];
+			const std::size_t count = std::min<std::size_t>(block.count - offset, remaining);
+			BlockReader reader{m_words.data(), block.bitOffset, block.first};
+			if (offset == 0)
+			{
+				*it = std::bit_cast<DateTime>(block.first);
+				reader.read<true>(it + 1, count - 1);
+			}
+			else
+			{
+				reader.read<false>(nullptr, offset - 1);
+				reader.read<true>(it, count);
+			}
+
+			it += count;
+			remaining -= count;
+			offset = 0;
+		}
+	}
+
+	ONION_INLINE void TimestampColumn::decode(std::span<DateTime> out) const
+	{
+		if (out.size() < m_size)
+			detail::raise(std::invalid_argument("TimestampColumn: output column is shorter than the column"));
+
+		decode(0, out.first(m_size));
+	}
+
+} // namespace onion
@@ -0,0 +1,118 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "Config.hpp"
+#include "DateTime.hpp"
+
+namespace onion
+{
+	/// An append-only column of DateTimes, compressed with delta-of-delta bit packing (as in Facebook's Gorilla).
+	///
+	/// Values are grouped in blocks of `BlockSize`. Each block header holds the block's first value and its count;
+	/// the following values are stored as the change of the delta to the previous value, with a variable-length code:
+	///
+	///   '0'                        delta unchanged        1 bit
+	///   '10'   + 7-bit zigzag      change in [-64, 63]     9 bits
+	///   '110'  + 9-bit zigzag      change in [-256, 255]   12 bits
+	///   '1110' + 12-bit zigzag     change in [-2048, 2047] 16 bits
+	///   '1111' + 64-bit zigzag     any other change        68 bits
+	///
+	/// A regular series (e.g. one sample per second) therefore takes about 1.4 bits per value, headers included,
+	/// and one with a few milliseconds of jitter between 1 and 12 bits, against 64 in a `std::vector<DateTime>`.
+	/// Runs of unchanged deltas are decoded up to 64 at a time.
+	///
+	/// Access is by block: `at` and `lowerBound` decode at most one block, and `decode` streams ranges of values
+	/// sequentially. `lowerBound` requires the values to have been appended in non-decreasing order.
+	///
+	/// Example:
+	///   onion::TimestampColumn column;
+	///   for (const auto& event : events) column.append(event.time);
+	///   std::vector<onion::DateTime> window(100, onion::DateTime::FromUnixMillis(0));
+	///   column.decode(column.lowerBound(from), window);
+	class TimestampColumn
+	{
+	  public:
+		/// Number of values per block.
+		static constexpr std::size_t BlockSize = 512;
+
+	  public:
+		TimestampColumn() = default;
+
+		/// Appends a value.
+		void append(const DateTime& dateTime);
+
+		/// Appends a column of values.
+		void append(std::span<const DateTime> dateTimes);
+
+		/// Removes every value.
+		void clear() noexcept;
+
+		/// Releases the unused capacity of the storage.
+		void shrinkToFit();
+
+	  public:
+		/// Returns the number of values.
+		std::size_t size() const noexcept { return m_size; }
+
+		/// Returns true if the column has no value.
+		bool empty() const noexcept { return m_size == 0; }
+
+		/// Returns the number of blocks.
+		std::size_t blockCount() const noexcept { return m_blocks.size(); }
+
+		/// Returns true if the values were appended in non-decreasing order.
+		bool isSorted() const noexcept { return m_sorted; }
+
+		/// Returns the number of bytes used by the encoded values and the block headers, excluding spare capacity.
+		std::size_t compressedBytes() const noexcept;
+
+		/// Returns the value at the given index, decoding its block up to it.
+		/// @throws std::out_of_range If `index >= size()`.
+		DateTime at(std::size_t index) const;
+
+		/// Returns the last value.
+		/// @throws std::out_of_range If the column is empty.
+		DateTime back() const;
+
+		/// Returns the index of the first value not less than `dateTime`, or `size()` if there is none.
+		/// The values must have been appended in non-decreasing order (see `isSorted`).
+		std::size_t lowerBound(const DateTime& dateTime) const noexcept;
+
+		/// Decodes `out.size()` values starting at index `first`.
+		/// @throws std::out_of_range If `first + out.size() > size()`.
+		void decode(std::size_t first, std::span<DateTime> out) const;
+
+		/// Decodes every value.
+		/// @throws std::invalid_argument If `out` is shorter than `size()`.
+		void decode(std::span<DateTime> out) const;
+
+	  private:
+		struct Block
+		{
+			int64_t first;		// Unix milliseconds of the first value
+			uint64_t bitOffset; // position of the second value's code in m_words
+			uint32_t count;
+		};
+
+		void writeBits(uint64_t bits, unsigned length);
+
+	  private:
+		std::vector<Block> m_blocks;
+		std::vector<uint64_t> m_words; // codes, least significant bit first, followed by at least one zero word
+		uint64_t m_bitSize = 0;
+		std::size_t m_size = 0;
+
+		int64_t m_last = 0;		  // Unix milliseconds of the last value
+		int64_t m_lastDelta = 0; // delta between the last two values of the last block
+		bool m_sorted = true;
+	};
+
+} // namespace onion
+
+#ifdef ONION_HEADER_ONLY
+#include "TimestampColumn.cpp"
+#endif
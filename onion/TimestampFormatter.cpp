@@ -0,0 +1,130 @@
+#include "TimestampFormatter.hpp"
+
+#include <array>
+#include <atomic>
+#include <cstring>
+#include <limits>
+
+#include "Config.hpp"
+#include "detail/Calendar.hpp"
+#include "detail/Digits.hpp"
+
+namespace onion
+{
+	/// Direct-mapped cache of the last text rendered by each formatter on this thread.
+	struct TimestampFormatter::ThreadCache
+	{
+		static constexpr std::size_t Entries = 4;
+
+		struct Entry
+		{
+			uint64_t owner = 0; // formatter id, 0 when unused
+			int64_t second = std::numeric_limits<int64_t>::min();
+			uint16_t length = 0;
+			DateTime::Pattern::MillisecondDigits digits{};
+			char text[MaxCachedLength]{};
+		};
+
+		std::array<Entry, Entries> entries{};
+		Statistics statistics{};
+	};
+
+	ONION_INLINE TimestampFormatter::TimestampFormatter() noexcept
+		: TimestampFormatter(DateTime::Pattern::Compile("%FT%TZ"))
+	{
+	}
+
+	ONION_INLINE TimestampFormatter::TimestampFormatter(const DateTime::Pattern& pattern) noexcept
+		: m_pattern(pattern), m_id(nextId()), m_cacheable(pattern.maxFormattedSize() <= MaxCachedLength)
+	{
+	}
+
+	ONION_INLINE TimestampFormatter::TimestampFormatter(std::string_view format)
+		: TimestampFormatter(DateTime::Pattern(format))
+	{
+	}
+
+	ONION_INLINE std::to_chars_result TimestampFormatter::formatTo(const DateTime& dateTime,
+																   char* first,
+																   char* last) const noexcept
+	{
+		if (!m_cacheable)
+			return m_pattern.formatTo(dateTime, first, last);
+
+		const int64_t unixMillis = dateTime.toUnixMillis();
+		const int64_t second = detail::floorDiv(unixMillis, detail::MillisPerSecond);
+		const auto milliseconds = static_cast<unsigned>(unixMillis - second * detail::MillisPerSecond);
+
+		ThreadCache& cache = threadCache();
+		ThreadCache::Entry& entry = cache.entries[m_id % ThreadCache::Entries];
+
+		if (entry.owner == m_id && entry.second == second)
+		{
+			++cache.statistics.hits;
+		}
+		else
+		{
+			++cache.statistics.misses;
+
+			entry.digits = {};
+			const char* end = m_pattern.formatInPlace(DateTime::Pattern::instant(dateTime), entry.text, &entry.digits);
+			if (entry.digits.overflow)
+			{
+				entry.owner = 0;
+				return m_pattern.formatTo(dateTime, first, last);
+			}
+
+			entry.owner = m_id;
+			entry.second = second;
+			entry.length = static_cast<uint16_t>(end - entry.text);
+		}
+
+		if (static_cast<std::size_t>(last - first) < entry.length)
+			return {last, std::errc::value_too_large};
+
+		std::memcpy(first, entry.text, entry.length);
+		for (std::size_t i = 0; i < entry.digits.count; ++i)
+			detail::writeDigits3(first + entry.digits.offsets[i], milliseconds);
+
+		return {first + entry.length, std::errc{}};
+	}
+
+	ONION_INLINE std::string TimestampFormatter::format(const DateTime& dateTime) const
+	{
+		std::string result;
+		appendTo(dateTime, result);
+		return result;
+	}
+
+	ONION_INLINE void TimestampFormatter::appendTo(const DateTime& dateTime, std::string& out) const
+	{
+		const std::size_t size = out.size();
+		out.resize(size + maxFormattedSize());
+		const std::to_chars_result result = formatTo(dateTime, out.data() + size, out.data() + out.size());
+		out.resize(static_cast<std::size_t>(result.ptr - out.data()));
+	}
+
+	ONION_INLINE TimestampFormatter::Statistics TimestampFormatter::threadStatistics() noexcept
+	{
+		return threadCache().statistics;
+	}
+
+	ONION_INLINE void TimestampFormatter::resetThreadStatistics() noexcept
+	{
+		threadCache().statistics = {};
+	}
+
+	ONION_INLINE TimestampFormatter::ThreadCache& TimestampFormatter::threadCache() noexcept
+	{
+		// Constant-initialized, so accessing it needs no initialization guard.
+		thread_local ThreadCache cache;
+		return cache;
+	}
+
+	ONION_INLINE uint64_t TimestampFormatter::nextId() noexcept
+	{
+		static std::atomic<uint64_t> next{1};
+		return next.fetch_add(1, std::memory_order_relaxed);
+	}
+
+} // namespace onion
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+#include "DateTime.hpp"
+
+namespace onion
+{
+	/// Formats DateTimes that mostly fall in the same second, such as log line timestamps, from a per-thread cache.
+	///
+	/// Each thread keeps the last text rendered by a formatter along with the Unix second it belongs to. When the
+	/// next DateTime falls in the same second, the cached text is copied and only its millisecond digits are
+	/// rewritten, so a call costs little more than a memcpy. The cache is thread-local, so a formatter can be shared
+	/// between threads without synchronization. A thread caches a few formatters at a time.
+	///
+	/// Example:
+	///   static const onion::TimestampFormatter formatter("%F %T");
+	///   formatter.appendTo(onion::DateTime::UtcNowCoarse(), line);
+	class TimestampFormatter
+	{
+	  public:
+		/// Longest formatted text that is cached. Longer patterns are formatted directly on every call.
+		static constexpr std::size_t MaxCachedLength = 128;
+
+		/// Cache hits and misses of the calling thread, across all formatters.
+		struct Statistics
+		{
+			uint64_t hits = 0;
+			uint64_t misses = 0;
+		};
+
+	  public:
+		/// Creates a formatter for the ISO 8601 representation of `DateTime::toString()`
+		/// (e.g., "2024-06-15T12:30:45.500Z").
+		TimestampFormatter() noexcept;
+
+		/// Creates a formatter for a precompiled pattern, producing the same text as `DateTime::toString(pattern)`.
+		explicit TimestampFormatter(const DateTime::Pattern& pattern) noexcept;
+
+		/// Creates a formatter for a C++20 chrono format string.
+		/// @throws std::invalid_argument If the format string is invalid.
+		explicit TimestampFormatter(std::string_view format);
+
+	  public:
+		/// Returns an upper bound of the number of characters written by `formatTo`.
+		std::size_t maxFormattedSize() const noexcept { return m_pattern.maxFormattedSize(); }
+
+		/// Writes the formatted DateTime into [first, last), in the manner of `std::to_chars`.
+		/// @return `{end of output, std::errc{}}` on success, or `{last, std::errc::value_too_large}` if the
+		///         buffer is too small.
+		std::to_chars_result formatTo(const DateTime& dateTime, char* first, char* last) const noexcept;
+
+		/// Returns the formatted DateTime as a string.
+		std::string format(const DateTime& dateTime) const;
+
+		/// Appends the formatted DateTime to the given string.
+		void appendTo(const DateTime& dateTime, std::string& out) const;
+
+		/// Returns the cache statistics of the calling thread.
+		static Statistics threadStatistics() noexcept;
+
+		/// Resets the cache statistics of the calling thread.
+		static void resetThreadStatistics() noexcept;
+
+	  private:
+		struct ThreadCache;
+		static ThreadCache& threadCache() noexcept;
+		static uint64_t nextId() noexcept;
+
+	  private:
+		DateTime::Pattern m_pattern;
+		uint64_t m_id;
+		bool m_cacheable;
+	};
+
+} // namespace onion
+
+#ifdef ONION_HEADER_ONLY
+#include "TimestampFormatter.cpp"
+#endif
@@ -0,0 +1,223 @@
+#pragma once
+
+#include <cstdint>
+#include <limits>
+
+#include "Overflow.hpp"
+
+namespace onion::detail
+{
+	// ---- CONSTEXPR ----
+	constexpr int64_t MillisPerSecond = 1'000;
+	constexpr int64_t MillisPerMinute = 60 * MillisPerSecond;
+	constexpr int64_t MillisPerHour = 60 * MillisPerMinute;
+	constexpr int64_t MillisPerDay = 24 * MillisPerHour;
+
+	/// A proleptic Gregorian calendar date.
+	struct CivilDate
+	{
+		int year;
+		unsigned month;
+		unsigned day;
+		unsigned dayOfYear; // 1-based
+	};
+
+	/// Returns `numerator / denominator` rounded towards negative infinity.
+	constexpr int64_t floorDiv(int64_t numerator, int64_t denominator) noexcept
+	{
+		const int64_t quotient = numerator / denominator;
+		return quotient - ((numerator % denominator) < 0 ? 1 : 0);
+	}
+
+	/// Returns `numerator` modulo `denominator`, in [0, denominator) for a positive denominator.
+	constexpr int64_t floorMod(int64_t numerator, int64_t denominator) noexcept
+	{
+		const int64_t remainder = numerator % denominator;
+		return remainder < 0 ? remainder + denominator : remainder;
+	}
+
+	/// Returns true if the given proleptic Gregorian year is a leap year.
+	constexpr bool isLeapYear(int year) noexcept
+	{
+		return (year % 4 == 0) && (year % 100 != 0 || year % 400 == 0);
+	}
+
+	/// Returns the number of days in the given month (1-12) of the given year.
+	constexpr unsigned daysInMonth(int year, unsigned month) noexcept
+	{
+		constexpr unsigned char table[12] = {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+		return month == 2 && isLeapYear(year) ? 29u : table[month - 1];
+	}
+
+	// Neri-Schneider Euclidean affine calendar algorithms ("Euclidean affine functions and their application to
+	// calendar algorithms", 2022). The computation is shifted by 82 eras of 400 years so every supported day maps to
+	// a non-negative 32-bit value and only unsigned 32-bit arithmetic (plus one 32x32->64 multiply) is needed.
+	constexpr uint32_t CalendarEraShift = 82;
+	constexpr uint32_t CalendarDayShift = 719468 + 146097 * CalendarEraShift;
+	constexpr uint32_t CalendarYearShift = 400 * CalendarEraShift;
+
+	/// Returns the number of days between 1970-01-01 and the given proleptic Gregorian date.
+	/// The date components are expected to be valid.
+	constexpr int64_t daysFromCivil(int year, unsigned month, unsigned day) noexcept
+	{
+		const uint32_t janFeb = month <= 2;
+		const uint32_t y = (static_cast<uint32_t>(year) + CalendarYearShift) - janFeb;
+		const uint32_t m = janFeb ? month + 12 : month;
+		const uint32_t century = y / 100;
+		const uint32_t yearDays = 1461 * y / 4 - century + century / 4;
+		const uint32_t monthDays = (979 * m - 2919) / 32;
+		return static_cast<int64_t>(yearDays + monthDays + day - 1) - CalendarDayShift;
+	}
+
+	/// Returns the proleptic Gregorian date of a day expressed as `days since 1970-01-01 + CalendarDayShift`.
+	/// Only uses unsigned 32-bit operations, so loops over it vectorize well.
+	constexpr CivilDate civilFromShiftedDays(uint32_t shiftedDays) noexcept
+	{
+		// ---- Century ----
+		const uint32_t n1 = 4 * shiftedDays + 3;
+		const uint32_t century = n1 / 146097;
+		const uint32_t dayOfCentury = n1 % 146097 / 4;
+
+		// ---- Year ----
+		const uint64_t p2 = uint64_t{2939745} * (4 * dayOfCentury + 3);
+		const uint32_t yearOfCentury = static_cast<uint32_t>(p2 >> 32);
+		const uint32_t dayOfYear = static_cast<uint32_t>(p2) / 2939745 / 4; // 0 is March 1st
+		const uint32_t year = 100 * century + yearOfCentury;
+
+		// ---- Month and day ----
+		const uint32_t n3 = 2141 * dayOfYear + 197913;
+		const uint32_t month = n3 / 65536;
+		const uint32_t day = n3 % 65536 / 2141;
+
+		// ---- Map back from the March-based computational calendar ----
+		const uint32_t janFeb = dayOfYear >= 306;
+		const int civilYear = static_cast<int>(year - CalendarYearShift + janFeb);
+		const unsigned civilDayOfYear = janFeb ? dayOfYear - 305 : dayOfYear + 60 + isLeapYear(civilYear);
+		return CivilDate{civilYear, janFeb ? month - 12 : month, day + 1, civilDayOfYear};
+	}
+
+	/// Returns the proleptic Gregorian date that is the given number of days after 1970-01-01.
+	constexpr CivilDate civilFromDays(int64_t days) noexcept
+	{
+		return civilFromShiftedDays(static_cast<uint32_t>(days + CalendarDayShift));
+	}
+
+	/// Returns the day of week (0 = Sunday) of the given number of days after 1970-01-01.
+	constexpr unsigned weekdayFromDays(int64_t days) noexcept
+	{
+		// 1970-01-01 is a Thursday (4) and CalendarDayShift % 7 == 1.
+		return static_cast<unsigned>((static_cast<uint32_t>(days + CalendarDayShift) + 3) % 7);
+	}
+
+	/// Returns the first day (a Monday) of the ISO week that contains the given day.
+	constexpr int64_t weekStartFromDays(int64_t days) noexcept
+	{
+		return days - (weekdayFromDays(days) + 6) % 7;
+	}
+
+	/// Returns the first day of the period of `months` months (1, 3 or 12, periods starting in January) that
+	/// contains the given day.
+	constexpr int64_t periodStartFromDays(int64_t days, unsigned months) noexcept
+	{
+		const CivilDate date = civilFromDays(days);
+		return daysFromCivil(date.year, (date.month - 1) / months * months + 1, 1);
+	}
+
+	/// Milliseconds since the Unix epoch of 0001-01-01T00:00:00.000Z, the smallest supported DateTime.
+	constexpr int64_t MinUnixMillis = daysFromCivil(1, 1, 1) * MillisPerDay;
+
+	/// Milliseconds since the Unix epoch of 9999-12-31T23:59:59.999Z, the largest supported DateTime.
+	constexpr int64_t MaxUnixMillis = daysFromCivil(9999, 12, 31) * MillisPerDay + MillisPerDay - 1;
+
+	// ---- Unix time in units of 1 / UnitsPerSecond seconds (1, 1'000, 1'000'000 or 1'000'000'000) ----
+	// A DateTime with a precision of 1 / TicksPerSecond seconds counts ticks since the Unix epoch; DateTime itself
+	// counts milliseconds, which is the default.
+
+	/// Converts a Unix time between units, rounding towards negative infinity.
+	/// The result is expected to be representable as int64_t.
+	template <int64_t FromUnitsPerSecond, int64_t ToUnitsPerSecond>
+	constexpr int64_t convertUnixTime(int64_t value) noexcept
+	{
+		if constexpr (FromUnitsPerSecond <= ToUnitsPerSecond)
+			return value * (ToUnitsPerSecond / FromUnitsPerSecond);
+		else
+			return floorDiv(value, FromUnitsPerSecond / ToUnitsPerSecond);
+	}
+
+	/// Converts a Unix time to milliseconds, rounding towards negative infinity.
+	/// The value is expected to be in [MinUnixTime<UnitsPerSecond>, MaxUnixTime<UnitsPerSecond>].
+	template <int64_t UnitsPerSecond> constexpr int64_t unixTimeToMillis(int64_t value) noexcept
+	{
+		return convertUnixTime<UnitsPerSecond, MillisPerSecond>(value);
+	}
+
+	/// Converts Unix milliseconds to a Unix time, rounding towards negative infinity.
+	/// The result is expected to be representable as int64_t.
+	template <int64_t UnitsPerSecond> constexpr int64_t millisToUnixTime(int64_t unixMillis) noexcept
+	{
+		return convertUnixTime<MillisPerSecond, UnitsPerSecond>(unixMillis);
+	}
+
+	/// Combines whole Unix seconds and a fraction in [0, TicksPerSecond) into ticks.
+	/// Returns false if the result does not fit in int64_t, which only happens for nanoseconds.
+	template <int64_t TicksPerSecond>
+	constexpr bool composeTicks(int64_t unixSeconds, int64_t fraction, int64_t& ticks) noexcept
+	{
+		// Before the epoch, the whole seconds alone can overflow although the sum with the fraction fits.
+		if (unixSeconds < 0 && fraction > 0)
+			return !mulOverflow(unixSeconds + 1, TicksPerSecond, ticks) &&
+				!addOverflow(ticks, fraction - TicksPerSecond, ticks);
+
+		return !mulOverflow(unixSeconds, TicksPerSecond, ticks) && !addOverflow(ticks, fraction, ticks);
+	}
+
+	/// Smallest supported tick count (0001-01-01T00:00:00Z), clamped to the int64_t range.
+	template <int64_t TicksPerSecond>
+	constexpr int64_t MinTicks = MinUnixMillis / MillisPerSecond < std::numeric_limits<int64_t>::min() / TicksPerSecond
+		? std::numeric_limits<int64_t>::min()
+		: MinUnixMillis / MillisPerSecond * TicksPerSecond;
+
+	/// Largest supported tick count (the last tick of 9999-12-31), clamped to the int64_t range.
+	template <int64_t TicksPerSecond>
+	constexpr int64_t MaxTicks =
+		MaxUnixMillis / MillisPerSecond > (std::numeric_limits<int64_t>::max() - TicksPerSecond + 1) / TicksPerSecond
+		? std::numeric_limits<int64_t>::max()
+		: MaxUnixMillis / MillisPerSecond * TicksPerSecond + TicksPerSecond - 1;
+
+	/// Smallest Unix time that maps to a supported DateTime, clamped to the int64_t range.
+	template <int64_t UnitsPerSecond, int64_t TicksPerSecond = MillisPerSecond>
+	constexpr int64_t MinUnixTime = UnitsPerSecond <= TicksPerSecond
+		? convertUnixTime<TicksPerSecond, UnitsPerSecond>(
+			  MinTicks<TicksPerSecond> + TicksPerSecond / UnitsPerSecond - 1) // rounded up
+		: (MinTicks<TicksPerSecond> < std::numeric_limits<int64_t>::min() / (UnitsPerSecond / TicksPerSecond)
+			   ? std::numeric_limits<int64_t>::min()
+			   : MinTicks<TicksPerSecond> * (UnitsPerSecond / TicksPerSecond));
+
+	/// Largest Unix time that maps to a supported DateTime, clamped to the int64_t range.
+	template <int64_t UnitsPerSecond, int64_t TicksPerSecond = MillisPerSecond>
+	constexpr int64_t MaxUnixTime = UnitsPerSecond <= TicksPerSecond
+		? convertUnixTime<TicksPerSecond, UnitsPerSecond>(MaxTicks<TicksPerSecond>)
+		: (MaxTicks<TicksPerSecond> > std::numeric_limits<int64_t>::max() / (UnitsPerSecond / TicksPerSecond)
+			   ? std::numeric_limits<int64_t>::max()
+			   : MaxTicks<TicksPerSecond> * (UnitsPerSecond / TicksPerSecond) +
+				   (UnitsPerSecond / TicksPerSecond - 1));
+
+	/// Smallest tick count whose Unix time in the given unit fits in int64_t.
+	template <int64_t UnitsPerSecond, int64_t TicksPerSecond = MillisPerSecond>
+	constexpr int64_t MinConvertibleTicks = UnitsPerSecond <= TicksPerSecond
+		? std::numeric_limits<int64_t>::min()
+		: convertUnixTime<UnitsPerSecond, TicksPerSecond>(std::numeric_limits<int64_t>::min()) + 1;
+
+	/// Largest tick count whose Unix time in the given unit fits in int64_t.
+	template <int64_t UnitsPerSecond, int64_t TicksPerSecond = MillisPerSecond>
+	constexpr int64_t MaxConvertibleTicks = UnitsPerSecond <= TicksPerSecond
+		? std::numeric_limits<int64_t>::max()
+		: convertUnixTime<UnitsPerSecond, TicksPerSecond>(std::numeric_limits<int64_t>::max());
+
+	/// Smallest Unix millisecond value whose Unix time in the given unit fits in int64_t.
+	template <int64_t UnitsPerSecond> constexpr int64_t MinConvertibleMillis = MinConvertibleTicks<UnitsPerSecond>;
+
+	/// Largest Unix millisecond value whose Unix time in the given unit fits in int64_t.
+	template <int64_t UnitsPerSecond> constexpr int64_t MaxConvertibleMillis = MaxConvertibleTicks<UnitsPerSecond>;
+
+} // namespace onion::detail
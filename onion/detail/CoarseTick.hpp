@@ -0,0 +1,19 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <limits>
+
+namespace onion::detail
+{
+	/// Value of `CoarseTickMillis` while no `CoarseClockTicker` is running.
+	constexpr int64_t NoCoarseTick = std::numeric_limits<int64_t>::min();
+
+	/// Unix milliseconds published by the running `CoarseClockTicker`s and read by `DateTime::UtcNowCoarse()`.
+	/// Kept on its own cache line so that readers only share it with the ticker thread.
+	alignas(64) inline std::atomic<int64_t> CoarseTickMillis{NoCoarseTick};
+
+	/// Number of `CoarseClockTicker`s currently alive.
+	inline std::atomic<int> CoarseTickers{0};
+
+} // namespace onion::detail
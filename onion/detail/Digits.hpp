@@ -0,0 +1,44 @@
+#pragma once
+
+namespace onion::detail
+{
+	/// "00" to "99" laid out back to back, so two decimal digits can be copied with a single lookup.
+	inline constexpr char DigitPairs[201] =
+		"0001020304050607080910111213141516171819"
+		"2021222324252627282930313233343536373839"
+		"4041424344454647484950515253545556575859"
+		"6061626364656667686970717273747576777879"
+		"8081828384858687888990919293949596979899";
+
+	/// Writes `value` (0-99) as two zero-padded decimal digits.
+	constexpr void writeDigits2(char* out, unsigned value) noexcept
+	{
+		out[0] = DigitPairs[2 * value];
+		out[1] = DigitPairs[2 * value + 1];
+	}
+
+	/// Writes `value` (0-999) as three zero-padded decimal digits.
+	constexpr void writeDigits3(char* out, unsigned value) noexcept
+	{
+		out[0] = static_cast<char>('0' + value / 100);
+		writeDigits2(out + 1, value % 100);
+	}
+
+	/// Writes `value` (0-9999) as four zero-padded decimal digits.
+	constexpr void writeDigits4(char* out, unsigned value) noexcept
+	{
+		writeDigits2(out, value / 100);
+		writeDigits2(out + 2, value % 100);
+	}
+
+	/// Writes `value` as `digits` zero-padded decimal digits, `digits` being a multiple of 3 (fractional seconds).
+	constexpr void writeDigitGroups(char* out, unsigned value, unsigned digits) noexcept
+	{
+		for (char* it = out + digits; it != out; it -= 3)
+		{
+			writeDigits3(it - 3, value % 1'000);
+			value /= 1'000;
+		}
+	}
+
+} // namespace onion::detail
@@ -0,0 +1,19 @@
+#pragma once
+
+#include <cstdint>
+
+namespace onion::detail
+{
+	/// Mixes the bits of a 64-bit value (the MurmurHash3 finalizer), so that consecutive values such as the ticks of
+	/// nearby instants spread over the whole range, as hash tables indexed by the low bits need.
+	constexpr uint64_t mixBits(uint64_t value) noexcept
+	{
+		value ^= value >> 33;
+		value *= 0xFF51AFD7ED558CCDull;
+		value ^= value >> 33;
+		value *= 0xC4CEB9FE1A85EC53ull;
+		value ^= value >> 33;
+		return value;
+	}
+
+} // namespace onion::detail
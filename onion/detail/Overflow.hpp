@@ -0,0 +1,55 @@
+#pragma once
+
+#include <cstdint>
+#include <limits>
+
+namespace onion::detail
+{
+	// ---- Overflow-checked int64 arithmetic ----
+	// Each function stores the wrapped result in `out` and returns true if the exact result does not fit in int64_t.
+	// GCC and Clang compile the builtins to the instruction followed by a jump on the overflow flag.
+
+	constexpr bool addOverflow(int64_t a, int64_t b, int64_t& out) noexcept
+	{
+#if defined(__GNUC__) || defined(__clang__)
+		return __builtin_add_overflow(a, b, &out);
+#else
+		out = static_cast<int64_t>(static_cast<uint64_t>(a) + static_cast<uint64_t>(b));
+		return (b > 0 && a > std::numeric_limits<int64_t>::max() - b) ||
+			   (b < 0 && a < std::numeric_limits<int64_t>::min() - b);
+#endif
+	}
+
+	constexpr bool subOverflow(int64_t a, int64_t b, int64_t& out) noexcept
+	{
+#if defined(__GNUC__) || defined(__clang__)
+		return __builtin_sub_overflow(a, b, &out);
+#else
+		out = static_cast<int64_t>(static_cast<uint64_t>(a) - static_cast<uint64_t>(b));
+		return (b < 0 && a > std::numeric_limits<int64_t>::max() + b) ||
+			   (b > 0 && a < std::numeric_limits<int64_t>::min() + b);
+#endif
+	}
+
+	constexpr bool mulOverflow(int64_t a, int64_t b, int64_t& out) noexcept
+	{
+#if defined(__GNUC__) || defined(__clang__)
+		return __builtin_mul_overflow(a, b, &out);
+#else
+		out = static_cast<int64_t>(static_cast<uint64_t>(a) * static_cast<uint64_t>(b));
+		if (a == 0 || b == 0)
+			return false;
+		if ((a == -1 && b == std::numeric_limits<int64_t>::min()) ||
+			(b == -1 && a == std::numeric_limits<int64_t>::min()))
+			return true;
+		return out / b != a;
+#endif
+	}
+
+	/// Value an overflowing addition or subtraction saturates to, given the sign of the exact result.
+	constexpr int64_t saturate(bool negative) noexcept
+	{
+		return negative ? std::numeric_limits<int64_t>::min() : std::numeric_limits<int64_t>::max();
+	}
+
+} // namespace onion::detail
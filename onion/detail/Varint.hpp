@@ -0,0 +1,98 @@
+#pragma once
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+namespace onion::detail
+{
+	// ---- Byte order ----
+
+	/// Stores `value` as 8 big-endian bytes.
+	inline void storeBigEndian64(std::byte* out, uint64_t value) noexcept
+	{
+		if constexpr (std::endian::native == std::endian::little)
+		{
+#if defined(__GNUC__) || defined(__clang__)
+			value = __builtin_bswap64(value);
+#else
+			value = (value & 0x00000000FFFFFFFFull) << 32 | (value & 0xFFFFFFFF00000000ull) >> 32;
+			value = (value & 0x0000FFFF0000FFFFull) << 16 | (value & 0xFFFF0000FFFF0000ull) >> 16;
+			value = (value & 0x00FF00FF00FF00FFull) << 8 | (value & 0xFF00FF00FF00FF00ull) >> 8;
+#endif
+		}
+		std::memcpy(out, &value, sizeof(value));
+	}
+
+	/// Loads 8 big-endian bytes.
+	inline uint64_t loadBigEndian64(const std::byte* in) noexcept
+	{
+		uint64_t value;
+		std::memcpy(&value, in, sizeof(value));
+		if constexpr (std::endian::native == std::endian::little)
+		{
+#if defined(__GNUC__) || defined(__clang__)
+			value = __builtin_bswap64(value);
+#else
+			value = (value & 0x00000000FFFFFFFFull) << 32 | (value & 0xFFFFFFFF00000000ull) >> 32;
+			value = (value & 0x0000FFFF0000FFFFull) << 16 | (value & 0xFFFF0000FFFF0000ull) >> 16;
+			value = (value & 0x00FF00FF00FF00FFull) << 8 | (value & 0xFF00FF00FF00FF00ull) >> 8;
+#endif
+		}
+		return value;
+	}
+
+	// ---- Zigzag LEB128 varints ----
+
+	/// Maps 0, -1, 1, -2, ... to 0, 1, 2, 3, ..., so that small magnitudes of either sign have small codes.
+	constexpr uint64_t zigzag(int64_t value) noexcept
+	{
+		return static_cast<uint64_t>(value) << 1 ^ static_cast<uint64_t>(value >> 63);
+	}
+
+	constexpr int64_t unzigzag(uint64_t value) noexcept
+	{
+		return static_cast<int64_t>(value >> 1 ^ (0 - (value & 1)));
+	}
+
+	/// Writes `value` as LEB128, at most 10 bytes. Returns the end of the written bytes.
+	inline std::byte* writeVarint(std::byte* out, uint64_t value) noexcept
+	{
+		while (value >= 0x80)
+		{
+			*out++ = static_cast<std::byte>(value | 0x80);
+			value >>= 7;
+		}
+		*out++ = static_cast<std::byte>(value);
+		return out;
+	}
+
+	/// Reads a LEB128 value from [first, last). Returns the end of the read bytes, or nullptr if the value is
+	/// truncated or does not fit in 64 bits.
+	inline const std::byte* readVarint(const std::byte* first, const std::byte* last, uint64_t& value) noexcept
+	{
+		// One byte values are the common case for deltas of sorted timestamps.
+		if (first != last && static_cast<uint8_t>(*first) < 0x80)
+		{
+			value = static_cast<uint8_t>(*first);
+			return first + 1;
+		}
+
+		uint64_t result = 0;
+		for (unsigned shift = 0; shift < 64 && first != last; shift += 7)
+		{
+			const auto byte = static_cast<uint8_t>(*first++);
+			result |= uint64_t{byte & 0x7Fu} << shift;
+			if (byte < 0x80)
+			{
+				// The tenth byte only carries the top bit.
+				if (shift == 63 && byte > 1)
+					return nullptr;
+				value = result;
+				return first;
+			}
+		}
+		return nullptr;
+	}
+} // namespace onion::detail
@@ -1,10 +1,42 @@
+#include <algorithm>
 #include <cassert>
+#include <chrono>
+#include <compare>
+#include <cstddef>
+#include <cstring>
+#include <cstdint>
 #include <exception>
+#include <filesystem>
 #include <format>
+#include <fstream>
 #include <iostream>
+#include <iterator>
+#include <map>
+#include <random>
+#include <span>
 #include <stdexcept>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <type_traits>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
 
+#include <onion/Batch.hpp>
+#include <onion/CoarseClock.hpp>
 #include <onion/DateTime.hpp>
+#include <onion/DateTimeIndex.hpp>
+#include <onion/Encoding.hpp>
+#include <onion/LatencyHistogram.hpp>
+#include <onion/LogScanner.hpp>
+#include <onion/Sort.hpp>
+#include <onion/Stopwatch.hpp>
+#include <onion/TimeBucketAggregator.hpp>
+#include <onion/TimeZone.hpp>
+#include <onion/TimerWheel.hpp>
+#include <onion/TimestampColumn.hpp>
+#include <onion/TimestampFormatter.hpp>
 
 using namespace onion;
 
@@ -230,12 +262,105 @@ static bool TestDateTimeConstructors()
 	return true;
 }
 
+static bool TestDateTimeTryCreate()
+{
+	// Valid components give the same DateTime as the constructor
+	const auto created = DateTime::TryCreate(2024, 2, 29, 12, 30, 45, 500);
+	assert(created.hasValue() && created && "Expected TryCreate to succeed for valid components");
+	assert(*created == DateTime(2024, 2, 29, 12, 30, 45, 500) && "Expected TryCreate to match the constructor");
+	assert(created.value().getDay() == 29 && created->getMonth() == 2 && "Expected the value accessors to work");
+
+	// Each invalid component is reported without throwing
+	struct Case
+	{
+		int year, month, day, hours, minutes, seconds;
+		double milliseconds;
+		DateTimeError error;
+	};
+	const Case cases[] = {
+		{0, 1, 1, 0, 0, 0, 0, DateTimeError::YearOutOfRange},
+		{10000, 1, 1, 0, 0, 0, 0, DateTimeError::YearOutOfRange},
+		{2024, 13, 1, 0, 0, 0, 0, DateTimeError::MonthOutOfRange},
+		{2024, 1, 0, 0, 0, 0, 0, DateTimeError::DayOutOfRange},
+		{2024, 1, 1, 24, 0, 0, 0, DateTimeError::HourOutOfRange},
+		{2024, 1, 1, 0, 60, 0, 0, DateTimeError::MinuteOutOfRange},
+		{2024, 1, 1, 0, 0, -1, 0, DateTimeError::SecondOutOfRange},
+		{2024, 1, 1, 0, 0, 0, 1000, DateTimeError::MillisecondOutOfRange},
+		{2023, 2, 29, 0, 0, 0, 0, DateTimeError::InvalidDate},
+		{2024, 4, 31, 0, 0, 0, 0, DateTimeError::InvalidDate},
+	};
+	for (const Case& c : cases)
+	{
+		const auto result = DateTime::TryCreate(c.year, c.month, c.day, c.hours, c.minutes, c.seconds, c.milliseconds);
+		assert(!result.hasValue() && "Expected TryCreate to fail for invalid components");
+		assert(result.error() == c.error && "Expected TryCreate to report the invalid component");
+	}
+
+	const DateTime fallback(2000, 1, 1, 0, 0, 0);
+	assert(DateTime::TryCreate(2023, 2, 29, 0, 0, 0).valueOr(fallback) == fallback && "Expected valueOr fallback");
+	assert(toString(DateTimeError::InvalidDate) == "invalid calendar date" && "Expected the error description");
+	static_assert(DateTime::TryCreate(2024, 1, 1, 0, 0, 0).hasValue());
+	static_assert(DateTime::TryCreate(2024, 2, 30, 0, 0, 0).error() == DateTimeError::InvalidDate);
+
+	// value() on an error throws
+	try
+	{
+		DateTime::TryCreate(2024, 0, 1, 0, 0, 0).value();
+		assert(false && "Expected std::logic_error from Expected::value()");
+	}
+	catch (const std::logic_error&)
+	{
+	}
+
+	return true;
+}
+
 static bool TestDateTimeUtcNow()
 {
 	// ToDo : Implement
 	return true;
 }
 
+static bool TestUtcNowCoarse()
+{
+	// The coarse clock trails the precise clock by at most a few ticks
+	const TimeSpan tolerance = TimeSpan::FromMilliseconds(50);
+	auto isCloseToNow = [&](const DateTime& coarse)
+	{
+		const TimeSpan behind = DateTime::UtcNow() - coarse;
+		return behind.Abs() <= tolerance;
+	};
+
+	assert(isCloseToNow(DateTime::UtcNowCoarse()) && "Expected UtcNowCoarse to be close to UtcNow");
+
+	{
+		CoarseClockTicker ticker(std::chrono::milliseconds{2});
+		assert(ticker.interval() == std::chrono::milliseconds{2} && "Expected the ticker interval to be kept");
+		assert(isCloseToNow(DateTime::UtcNowCoarse()) && "Expected the ticker to publish the time on start");
+
+		const DateTime first = DateTime::UtcNowCoarse();
+		std::this_thread::sleep_for(std::chrono::milliseconds{20});
+		const DateTime second = DateTime::UtcNowCoarse();
+		assert(second > first && "Expected the ticker to advance the published time");
+		assert(isCloseToNow(second) && "Expected the published time to stay close to UtcNow");
+	}
+
+	// Without a ticker, the system coarse clock is used again
+	std::this_thread::sleep_for(std::chrono::milliseconds{10});
+	assert(isCloseToNow(DateTime::UtcNowCoarse()) && "Expected UtcNowCoarse to keep working after the ticker stops");
+
+	try
+	{
+		CoarseClockTicker ticker(std::chrono::milliseconds{0});
+		assert(false && "Expected std::invalid_argument for a zero interval");
+	}
+	catch (const std::invalid_argument&)
+	{
+	}
+
+	return true;
+}
+
 static bool TestDateTimeGetters()
 {
 	DateTime dateTime(2020, 9, 11, 14, 5, 55, 123);
@@ -249,6 +374,105 @@ static bool TestDateTimeGetters()
 	return true;
 }
 
+static bool TestDateTimeDecompose()
+{
+	DateTime dateTime(2020, 9, 11, 14, 5, 55, 123);
+	DateTime::Components components = dateTime.decompose();
+	assert(components.year == 2020 && components.month == 9 && components.day == 11 && "Expected date 2020-09-11");
+	assert(components.hours == 14 && components.minutes == 5 && components.seconds == 55 &&
+		   components.milliseconds == 123 && "Expected time 14:05:55.123");
+	assert(components.dayOfWeek == 5 && "Expected 2020-09-11 to be a Friday");
+	assert(components.dayOfYear == 255 && "Expected 2020-09-11 to be day 255");
+
+	components = DateTime(2024, 12, 31, 0, 0, 0).decompose();
+	assert(components.dayOfYear == 366 && components.dayOfWeek == 2 && "Expected 2024-12-31 to be Tuesday, day 366");
+
+	components = DateTime(1, 1, 1, 0, 0, 0).decompose();
+	assert(components.year == 1 && components.dayOfYear == 1 && components.dayOfWeek == 1 &&
+		   "Expected 0001-01-01 to be Monday, day 1");
+
+	// Agrees with the individual getters, before and after the epoch
+	DateTime value(1969, 12, 31, 23, 59, 59, 999);
+	for (int i = 0; i < 1000; ++i)
+	{
+		components = value.decompose();
+		assert(components.year == value.getYear() && components.month == value.getMonth() &&
+			   components.day == value.getDay() && components.hours == value.getHours() &&
+			   components.minutes == value.getMinutes() && components.seconds == value.getSeconds() &&
+			   components.milliseconds == value.getMilliseconds() && "Expected decompose() to match the getters");
+		value = value + TimeSpan::FromMilliseconds(86'399'999LL * 37 + 1);
+	}
+
+	return true;
+}
+
+static bool TestBatchDecompose()
+{
+	// From 0001-01-01 to 9999-12-31, about a hundred years and a few hours apart
+	std::vector<DateTime> values;
+	std::vector<int64_t> epochMs;
+	for (int64_t ms = -62'135'596'800'000; ms < 253'402'300'800'000; ms += 3'155'695'200'123)
+	{
+		values.push_back(DateTime::FromUnixMillis(ms));
+		epochMs.push_back(ms);
+	}
+
+	const std::size_t count = epochMs.size();
+	for (batch::Isa isa : {batch::Isa::Scalar, batch::Isa::Avx2, batch::Isa::Avx512})
+	{
+		std::vector<int32_t> years(count), months(count), days(count), hours(count), minutes(count), seconds(count),
+			milliseconds(count);
+		batch::decompose(epochMs, {years, months, days, hours, minutes, seconds, milliseconds}, isa);
+
+		for (std::size_t i = 0; i < count; ++i)
+		{
+			assert(years[i] == values[i].getYear() && months[i] == values[i].getMonth() &&
+				   days[i] == values[i].getDay() && hours[i] == values[i].getHours() &&
+				   minutes[i] == values[i].getMinutes() && seconds[i] == values[i].getSeconds() &&
+				   milliseconds[i] == values[i].getMilliseconds() && "Expected batch columns to match the getters");
+		}
+	}
+
+	// Several chunks and a partial one, with a vector tail, against the scalar path
+	constexpr std::size_t LongCount = 1003;
+	std::vector<int64_t> longMs(LongCount);
+	uint64_t state = 0x9E3779B97F4A7C15;
+	for (std::size_t i = 0; i < LongCount; ++i)
+	{
+		state = state * 6'364'136'223'846'793'005 + 1'442'695'040'888'963'407;
+		longMs[i] = -62'135'596'800'000 + static_cast<int64_t>((state >> 11) % 315'537'897'600'000);
+	}
+	std::vector<std::vector<int32_t>> expected(7, std::vector<int32_t>(LongCount));
+	batch::decompose(longMs,
+					 {expected[0], expected[1], expected[2], expected[3], expected[4], expected[5], expected[6]},
+					 batch::Isa::Scalar);
+	for (batch::Isa isa : {batch::Isa::Avx2, batch::Isa::Avx512})
+	{
+		std::vector<std::vector<int32_t>> actual(7, std::vector<int32_t>(LongCount));
+		batch::decompose(longMs, {actual[0], actual[1], actual[2], actual[3], actual[4], actual[5], actual[6]}, isa);
+		assert(actual == expected && "Expected vectorized columns to match the scalar path across chunks");
+	}
+	assert(expected[0][LongCount - 1] == DateTime::FromUnixMillis(longMs[LongCount - 1]).getYear() &&
+		   "Expected the last value of the partial chunk to be decomposed");
+
+	// Skipped columns and size validation
+	std::vector<int32_t> years(count);
+	batch::decompose(epochMs, {.years = years});
+	assert(years.front() == 1 && "Expected only the year column to be written");
+
+	try
+	{
+		std::vector<int32_t> tooShort(count - 1);
+		batch::decompose(epochMs, {.months = tooShort});
+		assert(false && "Expected invalid_argument exception for a short column");
+	}
+	catch (const std::invalid_argument& e)
+	{
+	}
+
+	return true;
+}
+
 static bool TestAssignationOperator()
 {
 	DateTime dt1(2020, 9, 11, 14, 5, 55);
@@ -271,6 +495,51 @@ static bool TestDateTimeComparisonOperators()
 	return true;
 }
 
+static bool TestConstexprArithmetic()
+{
+	// Construction, comparison and arithmetic are usable in constant expressions
+	constexpr DateTime epoch(1970, 1, 1, 0, 0, 0);
+	constexpr DateTime leapDay(2024, 2, 29, 12, 30, 45, 500);
+	constexpr TimeSpan oneDay = TimeSpan::FromDays(1);
+
+	static_assert(epoch < leapDay);
+	static_assert(leapDay + oneDay == DateTime(2024, 3, 1, 12, 30, 45, 500));
+	static_assert(leapDay - oneDay == DateTime(2024, 2, 28, 12, 30, 45, 500));
+	static_assert(leapDay - epoch == TimeSpan(19782, 12, 30, 45, 500));
+	static_assert((epoch <=> leapDay) == std::strong_ordering::less);
+	static_assert(TimeSpan::FromHours(1) == TimeSpan::FromMinutes(60));
+	static_assert((TimeSpan::FromSeconds(-1) <=> TimeSpan::Zero()) == std::strong_ordering::less);
+	static_assert(TimeSpan::FromSeconds(-90).Abs().TotalSeconds() == 90.0);
+
+	// Same results at runtime
+	std::vector<DateTime> dates{leapDay, epoch, DateTime(2000, 1, 1, 0, 0, 0), leapDay - oneDay};
+	std::sort(dates.begin(), dates.end());
+	assert(std::is_sorted(dates.begin(), dates.end()) && "Expected DateTimes to be sorted");
+	assert(dates.front() == epoch && dates.back() == leapDay && "Expected epoch first and leapDay last");
+	assert((dates[1] <=> dates[1]) == std::strong_ordering::equal && "Expected a DateTime to compare equal to itself");
+
+	// Invalid components still throw
+	try
+	{
+		DateTime invalid(2023, 2, 29, 0, 0, 0);
+		assert(false && "Expected std::invalid_argument for 2023-02-29");
+	}
+	catch (const std::invalid_argument&)
+	{
+	}
+
+	try
+	{
+		DateTime invalid(2023, 1, 1, 0, 0, 0, -0.5);
+		assert(false && "Expected std::out_of_range for negative milliseconds");
+	}
+	catch (const std::out_of_range&)
+	{
+	}
+
+	return true;
+}
+
 static bool TestDateTimeToString()
 {
 	DateTime dateTime(2020, 9, 11, 14, 5, 55, 123);
@@ -282,6 +551,164 @@ static bool TestDateTimeToString()
 	return true;
 }
 
+static bool TestDateTimeToChars()
+{
+	DateTime dateTime(2020, 9, 11, 14, 5, 55, 123);
+
+	char buffer[32] = {};
+	auto result = dateTime.toChars(buffer, buffer + sizeof(buffer));
+	assert(result.ec == std::errc{} && "Expected toChars to succeed");
+	assert(std::string(buffer, result.ptr) == "2020-09-11T14:05:55.123Z" &&
+		   "Expected toChars to write '2020-09-11T14:05:55.123Z'");
+
+	char small[DateTime::IsoStringLength - 1] = {};
+	result = dateTime.toChars(small, small + sizeof(small));
+	assert(result.ec == std::errc::value_too_large && result.ptr == small + sizeof(small) &&
+		   "Expected toChars to report value_too_large");
+
+	std::string line = "ts=";
+	dateTime.appendTo(line);
+	assert(line == "ts=2020-09-11T14:05:55.123Z" && "Expected appendTo to append the ISO string");
+
+	DateTime beforeEpoch(1969, 12, 31, 23, 59, 59, 7);
+	assert(beforeEpoch.toString() == "1969-12-31T23:59:59.007Z" && "Expected '1969-12-31T23:59:59.007Z'");
+	assert(DateTime(1, 1, 1, 0, 0, 0).toString() == "0001-01-01T00:00:00.000Z" &&
+		   "Expected '0001-01-01T00:00:00.000Z'");
+	assert(DateTime(9999, 12, 31, 23, 59, 59, 999).toString() == "9999-12-31T23:59:59.999Z" &&
+		   "Expected '9999-12-31T23:59:59.999Z'");
+
+	// Arithmetic cannot leave the four-digit year range that the writers assume
+	int thrown = 0;
+	try
+	{
+		const DateTime past = DateTime(9999, 12, 31, 23, 59, 59, 999) + TimeSpan::FromDays(400);
+		(void)past.toChars(buffer, buffer + sizeof(buffer));
+	}
+	catch (const std::out_of_range&)
+	{
+		++thrown;
+	}
+	try
+	{
+		(void)(DateTime(1, 1, 1, 0, 0, 0) - TimeSpan::FromMilliseconds(1)).toString();
+	}
+	catch (const std::out_of_range&)
+	{
+		++thrown;
+	}
+	assert(thrown == 2 && "Expected std::out_of_range for arithmetic outside [0001, 9999]");
+	assert(DateTime(9999, 12, 30, 23, 59, 59, 999) + TimeSpan::FromDays(1) ==
+			   DateTime(9999, 12, 31, 23, 59, 59, 999) &&
+		   "Expected arithmetic up to the last millisecond");
+	return true;
+}
+
+static bool TestDateTimePattern()
+{
+	DateTime dateTime(2020, 9, 11, 14, 5, 55, 123);
+
+	// Compiled once, reused
+	constexpr DateTime::Pattern pattern = DateTime::Pattern::Compile("%Y/%m/%d %H:%M:%S");
+	assert(dateTime.toString(pattern) == "2020/09/11 14:05:55.123" && "Expected '2020/09/11 14:05:55.123'");
+	assert(DateTime(2021, 1, 2, 3, 4, 5).toString(pattern) == "2021/01/02 03:04:05.000" &&
+		   "Expected '2021/01/02 03:04:05.000'");
+
+	// Specifiers
+	assert(dateTime.toString("%F %T") == "2020-09-11 14:05:55.123" && "Expected '2020-09-11 14:05:55.123'");
+	assert(dateTime.toString("%a %A %b %B %e %j") == "Fri Friday Sep September 11 255" &&
+		   "Expected 'Fri Friday Sep September 11 255'");
+	assert(dateTime.toString("%I:%M %p %z %Ez %Z %%") == "02:05 PM +0000 +00:00 UTC %" &&
+		   "Expected '02:05 PM +0000 +00:00 UTC %'");
+	assert(dateTime.toString("%G-W%V-%u %U %W") == "2020-W37-5 36 36" && "Expected '2020-W37-5 36 36'");
+	assert(DateTime(2021, 1, 1, 0, 0, 0).toString("%G-W%V") == "2020-W53" && "Expected '2020-W53'");
+	assert(dateTime.toString("%c") == "Fri Sep 11 14:05:55 2020" && "Expected 'Fri Sep 11 14:05:55 2020'");
+
+	// Fill, align and width
+	assert(dateTime.toString("*>12%R") == "*******14:05" && "Expected '*******14:05'");
+	assert(dateTime.toString("^9%R") == "  14:05  " && "Expected '  14:05  '");
+
+	// Invalid patterns
+	const char* invalid[] = {"Date %F", "%Q", "%Ea", "%", "%F}", "010%F", "%Oq", ".3%F"};
+	for (const char* text : invalid)
+	{
+		DateTime::Pattern candidate;
+		assert(!candidate.assign(text) && "Expected assign to reject an invalid pattern");
+	}
+
+	try
+	{
+		dateTime.toString("%Q");
+		assert(false && "Expected invalid_argument exception for invalid format");
+	}
+	catch (const std::invalid_argument& e)
+	{
+	}
+
+	// std::format integration
+	assert(std::format("{}", dateTime) == "11-09-2020 14:05:55.123" && "Expected default format");
+	assert(std::format("[{:%F}]", dateTime) == "[2020-09-11]" && "Expected '[2020-09-11]'");
+	return true;
+}
+
+static bool TestTimestampFormatter()
+{
+	// A run of DateTimes, most of them in the same second as the previous one, some before the epoch
+	std::vector<DateTime> values;
+	for (int64_t ms = -2'500; ms < 2'500; ms += 7)
+		values.push_back(DateTime::FromUnixMillis(1'718'454'645'000 + ms));
+	for (int64_t ms = -1'500; ms < 1'500; ms += 11)
+		values.push_back(DateTime::FromUnixMillis(ms));
+
+	// Same text as the uncached formatting, for the ISO form and for patterns with padding and several %S
+	const TimestampFormatter iso;
+	for (const DateTime& value : values)
+		assert(iso.format(value) == value.toString() && "Expected the ISO formatter to match toString()");
+
+	for (const char* format : {"%F %T", "%H:%M:%S", "*^40%d/%m/%Y %T", ">30%S|%S|%c", "%Y-%m-%d"})
+	{
+		const DateTime::Pattern pattern(format);
+		const TimestampFormatter formatter(format);
+		for (const DateTime& value : values)
+			assert(formatter.format(value) == value.toString(pattern) && "Expected the formatter to match the pattern");
+	}
+
+	// Hits while the second does not change, a miss when it does
+	const TimestampFormatter formatter("%F %T");
+	TimestampFormatter::resetThreadStatistics();
+	const DateTime base(2024, 6, 15, 12, 30, 45);
+	for (int ms = 0; ms < 1000; ms += 100)
+		formatter.format(base + TimeSpan::FromMilliseconds(ms));
+	formatter.format(base + TimeSpan::FromSeconds(1));
+
+	const TimestampFormatter::Statistics statistics = TimestampFormatter::threadStatistics();
+	assert(statistics.misses == 2 && statistics.hits == 9 && "Expected 2 misses and 9 hits");
+
+	// Buffer too small
+	char buffer[8];
+	const std::to_chars_result result = formatter.formatTo(base, buffer, buffer + sizeof(buffer));
+	assert(result.ec == std::errc::value_too_large && result.ptr == buffer + sizeof(buffer) &&
+		   "Expected value_too_large for a short buffer");
+
+	// Patterns longer than the cache are formatted directly
+	const std::string longFormat = "%A%B" + std::string(120, '.') + "%S";
+	const TimestampFormatter longFormatter(longFormat);
+	assert(longFormatter.format(base) == base.toString(longFormat) && "Expected uncached formatting to match");
+
+	// Each thread has its own cache
+	std::vector<std::string> fromThread(values.size());
+	std::thread thread(
+		[&]()
+		{
+			for (std::size_t i = 0; i < values.size(); ++i)
+				fromThread[i] = iso.format(values[i]);
+		});
+	thread.join();
+	for (std::size_t i = 0; i < values.size(); ++i)
+		assert(fromThread[i] == values[i].toString() && "Expected the formatter to work from another thread");
+
+	return true;
+}
+
 static bool TestDateTimeUnixTimestamp()
 {
 	DateTime dateTime(2020, 9, 11, 14, 5, 55);
@@ -290,76 +717,1706 @@ static bool TestDateTimeUnixTimestamp()
 	return true;
 }
 
-int main()
+static bool TestDateTimeUnixEpoch()
 {
-	bool constructorsTestPassed = TestDateTimeConstructors();
-	if (constructorsTestPassed)
+	const DateTime dateTime(2024, 6, 15, 12, 30, 45, 123);
+	const DateTime beforeEpoch(1969, 12, 31, 23, 59, 59, 500);
+
+	// Exact integer factories
+	assert(DateTime::FromUnixSeconds(1'718'454'645) == DateTime(2024, 6, 15, 12, 30, 45) && "Expected FromUnixSeconds");
+	assert(DateTime::FromUnixMillis(1'718'454'645'123) == dateTime && "Expected FromUnixMillis");
+	assert(DateTime::FromUnixMicros(1'718'454'645'123'999) == dateTime && "Expected FromUnixMicros to round down");
+	assert(DateTime::FromUnixNanos(1'718'454'645'123'999'999) == dateTime && "Expected FromUnixNanos to round down");
+	assert(DateTime::FromUnixMicros(-500'001) == DateTime(1969, 12, 31, 23, 59, 59, 499) &&
+		   "Expected FromUnixMicros to round towards negative infinity");
+	assert(DateTime::FromUnixMillis(-62'135'596'800'000) == DateTime(1, 1, 1, 0, 0, 0) && "Expected the minimum");
+	assert(DateTime::FromUnixMillis(253'402'300'799'999) == DateTime(9999, 12, 31, 23, 59, 59, 999) &&
+		   "Expected the maximum");
+	static_assert(DateTime::FromUnixSeconds(0) == DateTime(1970, 1, 1, 0, 0, 0));
+
+	// Accessors round towards negative infinity
+	assert(dateTime.toUnixSeconds() == 1'718'454'645 && "Expected toUnixSeconds");
+	assert(dateTime.toUnixMillis() == 1'718'454'645'123 && "Expected toUnixMillis");
+	assert(dateTime.toUnixMicros() == 1'718'454'645'123'000 && "Expected toUnixMicros");
+	assert(dateTime.toUnixNanos() == 1'718'454'645'123'000'000 && "Expected toUnixNanos");
+	assert(beforeEpoch.toUnixSeconds() == -1 && beforeEpoch.toUnixMillis() == -500 && "Expected floored seconds");
+
+	// Out of range
+	for (int64_t seconds : {int64_t{-62'135'596'801}, int64_t{253'402'300'800}, INT64_MAX, INT64_MIN})
 	{
-		std::cout << "TestDateTimeConstructors passed." << std::endl;
+		try
+		{
+			DateTime::FromUnixSeconds(seconds);
+			assert(false && "Expected std::out_of_range from FromUnixSeconds");
+		}
+		catch (const std::out_of_range&)
+		{
+		}
 	}
-	else
+
+	try
+	{
+		DateTime(1600, 1, 1, 0, 0, 0).toUnixNanos();
+		assert(false && "Expected std::out_of_range from toUnixNanos");
+	}
+	catch (const std::out_of_range&)
 	{
-		assert(false && "TestDateTimeConstructors failed.");
 	}
 
-	bool utcNowTestPassed = TestDateTimeUtcNow();
-	if (utcNowTestPassed)
+	// FromUnixTimestamp rounds to the nearest millisecond and no longer loses one
+	assert(DateTime::FromUnixTimestamp(1718454645.123) == dateTime && "Expected FromUnixTimestamp to be exact");
+	assert(DateTime::FromUnixTimestamp(-0.5) == beforeEpoch && "Expected FromUnixTimestamp before the epoch");
+	try
 	{
-		std::cout << "TestDateTimeUtcNow passed." << std::endl;
+		DateTime::FromUnixTimestamp(1e300);
+		assert(false && "Expected std::out_of_range from FromUnixTimestamp");
 	}
-	else
+	catch (const std::out_of_range&)
 	{
-		assert(false && "TestDateTimeUtcNow failed.");
 	}
 
-	bool gettersTestPassed = TestDateTimeGetters();
-	if (gettersTestPassed)
+	return true;
+}
+
+static bool TestBatchUnixEpoch()
+{
+	const std::vector<int64_t> millis{-62'135'596'800'000, -1, 0, 1'718'454'645'123, 253'402'300'799'999};
+	std::vector<DateTime> dateTimes(millis.size(), DateTime::FromUnixMillis(0));
+
+	batch::fromUnixMillis(millis, dateTimes);
+	for (std::size_t i = 0; i < millis.size(); ++i)
+		assert(dateTimes[i] == DateTime::FromUnixMillis(millis[i]) && "Expected batch::fromUnixMillis");
+
+	std::vector<int64_t> seconds(millis.size()), roundTrip(millis.size());
+	batch::toUnixSeconds(dateTimes, seconds);
+	batch::toUnixMillis(dateTimes, roundTrip);
+	for (std::size_t i = 0; i < millis.size(); ++i)
 	{
-		std::cout << "TestDateTimeGetters passed." << std::endl;
+		assert(seconds[i] == dateTimes[i].toUnixSeconds() && "Expected batch::toUnixSeconds");
+		assert(roundTrip[i] == millis[i] && "Expected batch::toUnixMillis to round-trip");
 	}
-	else
+
+	std::vector<int64_t> micros(millis.size()), nanos{-1'000'001, 0, 999'999, 1'718'454'645'123'456'789};
+	batch::toUnixMicros(dateTimes, micros);
+	batch::fromUnixMicros(micros, dateTimes);
+	for (std::size_t i = 0; i < millis.size(); ++i)
+		assert(dateTimes[i].toUnixMillis() == millis[i] && "Expected batch micros to round-trip");
+
+	batch::fromUnixNanos(nanos, dateTimes);
+	for (std::size_t i = 0; i < nanos.size(); ++i)
+		assert(dateTimes[i] == DateTime::FromUnixNanos(nanos[i]) && "Expected batch::fromUnixNanos");
+
+	// A single invalid value rejects the column
+	const std::vector<int64_t> invalid{0, 253'402'300'800, 1};
+	try
+	{
+		batch::fromUnixSeconds(invalid, dateTimes);
+		assert(false && "Expected std::out_of_range from batch::fromUnixSeconds");
+	}
+	catch (const std::out_of_range&)
 	{
-		assert(false && "TestDateTimeGetters failed.");
 	}
 
-	bool assignationOperatorTestPassed = TestAssignationOperator();
-	if (assignationOperatorTestPassed)
+	try
 	{
-		std::cout << "TestAssignationOperator passed." << std::endl;
+		batch::toUnixNanos(std::vector<DateTime>{DateTime(2500, 1, 1, 0, 0, 0)}, micros);
+		assert(false && "Expected std::out_of_range from batch::toUnixNanos");
 	}
-	else
+	catch (const std::out_of_range&)
 	{
-		assert(false && "TestAssignationOperator failed.");
 	}
 
-	bool comparisonOperatorsTestPassed = TestDateTimeComparisonOperators();
-	if (comparisonOperatorsTestPassed)
+	try
 	{
-		std::cout << "TestDateTimeComparisonOperators passed." << std::endl;
+		batch::toUnixMillis(dateTimes, std::span<int64_t>(roundTrip).first(1));
+		assert(false && "Expected std::invalid_argument for a short output column");
 	}
-	else
+	catch (const std::invalid_argument&)
 	{
-		assert(false && "TestDateTimeComparisonOperators failed.");
 	}
 
-	bool toStringTestPassed = TestDateTimeToString();
-	if (toStringTestPassed)
+	return true;
+}
+
+static bool TestDateTimeParse()
+{
+	// Round trip with toString()
+	DateTime values[] = {DateTime(2020, 9, 11, 14, 5, 55, 123),
+						 DateTime(2024, 2, 29, 23, 59, 59, 999),
+						 DateTime(1969, 12, 31, 23, 59, 59, 1),
+						 DateTime(1, 1, 1, 0, 0, 0),
+						 DateTime(9999, 12, 31, 23, 59, 59, 999)};
+	for (const DateTime& value : values)
 	{
-		std::cout << "TestDateTimeToString passed." << std::endl;
+		assert(DateTime::Parse(value.toString()) == value && "Expected Parse(toString()) to round trip");
 	}
-	else
+
+	// ISO 8601 variants
+	DateTime expected(2024, 6, 15, 12, 30, 45, 500);
+	assert(DateTime::Parse("2024-06-15T12:30:45.500Z") == expected && "Expected fixed layout to parse");
+	assert(DateTime::Parse("2024-06-15 12:30:45.5") == expected && "Expected space separator to parse");
+	assert(DateTime::Parse("2024-06-15t12:30:45,500z") == expected && "Expected lowercase designators to parse");
+	assert(DateTime::Parse("2024-06-15T12:30:45.500999999Z") == expected && "Expected 9 fractional digits to parse");
+	assert(DateTime::Parse("2024-06-15T14:30:45.500+02:00") == expected && "Expected +HH:MM offset to parse");
+	assert(DateTime::Parse("2024-06-15T10:00:45.500-0230") == expected && "Expected -HHMM offset to parse");
+	assert(DateTime::Parse("2024-06-15T12:30Z") == DateTime(2024, 6, 15, 12, 30, 0) && "Expected HH:MM to parse");
+	assert(DateTime::Parse("2024-06-15") == DateTime(2024, 6, 15, 0, 0, 0) && "Expected date only to parse");
+	assert(DateTime::Parse("2024-06-16T00:30:00+01") == DateTime(2024, 6, 15, 23, 30, 0) &&
+		   "Expected offset to cross the day boundary");
+
+	// Invalid inputs
+	const char* invalid[] = {"",
+							 "2024-06-15T",
+							 "2024-13-15T12:30:45.500Z",
+							 "2023-02-29T12:30:45.500Z",
+							 "2024-06-15T24:00:00.000Z",
+							 "2024-06-15T12:60:00Z",
+							 "2024-06-15T12:30:45.Z",
+							 "2024-06-15T12:30:45.1234567891Z",
+							 "2024-06-15T12:30:45+2",
+							 "2024-06-15T12:30:45Z ",
+							 "2024-6-15",
+							 "0000-12-31T23:59:59Z",
+							 "0001-01-01T00:30:00+01:00",
+							 "9999-12-31T23:30:00-01:00"};
+	for (const char* text : invalid)
 	{
-		assert(false && "TestDateTimeToString failed.");
+		assert(!DateTime::TryParse(text).has_value() && "Expected TryParse to reject invalid input");
 	}
 
-	bool unixTimestampTestPassed = TestDateTimeUnixTimestamp();
-	if (unixTimestampTestPassed)
+	try
 	{
-		std::cout << "TestDateTimeUnixTimestamp passed." << std::endl;
+		DateTime::Parse("not a date");
+		assert(false && "Expected invalid_argument exception for invalid input");
 	}
-	else
+	catch (const std::invalid_argument& e)
 	{
-		assert(false && "TestDateTimeUnixTimestamp failed.");
+	}
+
+	return true;
+}
+
+static bool TestTimeSpanFormatting()
+{
+	// ToString / ToString_ISO8601
+	const TimeSpan span(1, 2, 3, 4, 500);
+	assert(span.ToString() == "1.02:03:04.500000000" && "Expected d.hh:mm:ss.fffffffff layout");
+	assert(span.ToString_ISO8601() == "P1DT2H3M4.5S" && "Expected PnDTnHnMnS layout");
+	assert((TimeSpan::Zero() - span).ToString() == "-1.02:03:04.500000000" && "Expected leading minus sign");
+	assert(TimeSpan::FromMinutes(90).ToString() == "01:30:00" && "Expected no fraction for whole seconds");
+	assert(TimeSpan::FromMinutes(90).ToString_ISO8601() == "PT1H30M" && "Expected zero fields to be omitted");
+	assert(TimeSpan::Zero().ToString_ISO8601() == "PT0S" && "Expected PT0S for zero");
+	assert(TimeSpan::MinValue().ToString() == "-106751.23:47:16.854775808" && "Expected MinValue to format");
+	assert(TimeSpan::MinValue().ToString_ISO8601() == "-P106751DT23H47M16.854775808S" && "Expected MinValue to format");
+
+	// ToChars matches ToString and reports a short buffer
+	char buffer[TimeSpan::MaxUnitStringLength];
+	char* const last = buffer + sizeof(buffer);
+	std::to_chars_result result = span.ToChars(buffer, last);
+	assert(result.ec == std::errc{} && std::string(buffer, result.ptr) == span.ToString() &&
+		   "Expected ToChars to match ToString");
+	result = span.ToChars_ISO8601(buffer, buffer + 4);
+	assert(result.ec == std::errc::value_too_large && result.ptr == buffer + 4 &&
+		   "Expected value_too_large for a short buffer");
+
+	// Units and precision
+	const TimeSpan latency = TimeSpan::FromMicroseconds(12'345);
+	result = latency.ToChars(buffer, last, TimeSpan::Unit::Milliseconds);
+	assert(std::string(buffer, result.ptr) == "12.345ms" && "Expected trailing zeros to be trimmed");
+	result = latency.ToChars(buffer, last, TimeSpan::Unit::Milliseconds, 1);
+	assert(std::string(buffer, result.ptr) == "12.3ms" && "Expected precision to round");
+	result = TimeSpan::FromNanoseconds(-999'500).ToChars(buffer, last, TimeSpan::Unit::Milliseconds, 0);
+	assert(std::string(buffer, result.ptr) == "-1ms" && "Expected rounding to carry into the integer part");
+
+	// std::formatter<TimeSpan>
+	assert(std::format("{}", span) == span.ToString() && "Expected default spec to match ToString");
+	assert(std::format("{:iso}", span) == span.ToString_ISO8601() && "Expected iso spec to match ToString_ISO8601");
+	assert(std::format("{:us}", latency) == "12345us" && "Expected us spec");
+	assert(std::format("{:s.3}", latency) == "0.012s" && "Expected s.3 spec");
+	assert(std::format("{:min}", TimeSpan::FromSeconds(90)) == "1.5min" && "Expected min spec");
+	assert(std::format("{:h.2}", TimeSpan::FromMinutes(-90)) == "-1.50h" && "Expected h.2 spec");
+	assert(std::format("{:ns.2}", TimeSpan::FromNanoseconds(7)) == "7.00ns" && "Expected zero padded precision");
+	assert(std::format("{:d}", TimeSpan::FromHours(36)) == "1.5d" && "Expected d spec");
+
+	try
+	{
+		(void)std::vformat("{:weeks}", std::make_format_args(span));
+		assert(false && "Expected format_error for an unknown unit");
+	}
+	catch (const std::format_error&)
+	{
+	}
+
+	return true;
+}
+
+static bool TestTimeSpanOverflow()
+{
+	// Integral scalars use exact int64 arithmetic, even past the 64-bit mantissa of long double
+	constexpr TimeSpan large = TimeSpan::FromNanoseconds(4'611'686'018'427'387'903);
+	static_assert((large * 2).TotalNanoseconds() == 9'223'372'036'854'775'806);
+	static_assert((TimeSpan::MaxValue() / 3).TotalNanoseconds() == 3'074'457'345'618'258'602);
+	static_assert((TimeSpan::FromNanoseconds(-7) / 2).TotalNanoseconds() == -3);
+	static_assert(3 * TimeSpan::FromSeconds(2) == TimeSpan::FromSeconds(6));
+
+	// Floating-point scalars keep their behavior
+	assert(TimeSpan::FromSeconds(3) * 1.5 == TimeSpan::FromMilliseconds(4'500) && "Expected fractional scaling");
+	assert(TimeSpan::FromSeconds(1) / 3.0 == TimeSpan::FromNanoseconds(333'333'333) && "Expected truncation");
+
+	// Checked
+	static_assert(TimeSpan::FromSeconds(1).AddChecked(TimeSpan::FromSeconds(2)) == TimeSpan::FromSeconds(3));
+	static_assert(!TimeSpan::MaxValue().AddChecked(TimeSpan::FromNanoseconds(1)).has_value());
+	static_assert(!TimeSpan::MinValue().SubtractChecked(TimeSpan::FromNanoseconds(1)).has_value());
+	static_assert(TimeSpan::MinValue().SubtractChecked(TimeSpan::MinValue()) == TimeSpan::Zero());
+	static_assert(!TimeSpan::MinValue().MultiplyChecked(-1).has_value());
+	static_assert(!large.MultiplyChecked(3).has_value());
+	static_assert(large.MultiplyChecked(-2) == TimeSpan::FromNanoseconds(-9'223'372'036'854'775'806));
+
+	// Saturating
+	static_assert(TimeSpan::MaxValue().AddSaturating(TimeSpan::FromDays(1)) == TimeSpan::MaxValue());
+	static_assert(TimeSpan::MinValue().AddSaturating(TimeSpan::FromDays(-1)) == TimeSpan::MinValue());
+	static_assert(TimeSpan::MaxValue().AddSaturating(TimeSpan::FromDays(-1)) ==
+				  TimeSpan::MaxValue() - TimeSpan::FromDays(1));
+	static_assert(TimeSpan::MinValue().SubtractSaturating(TimeSpan::FromDays(1)) == TimeSpan::MinValue());
+	static_assert(TimeSpan::MaxValue().SubtractSaturating(TimeSpan::MinValue()) == TimeSpan::MaxValue());
+	static_assert(large.MultiplySaturating(3) == TimeSpan::MaxValue());
+	static_assert(large.MultiplySaturating(-3) == TimeSpan::MinValue());
+	static_assert(TimeSpan::MinValue().MultiplySaturating(-1) == TimeSpan::MaxValue());
+
+	// Same results at runtime, where the compiler builtins are used
+	std::vector<TimeSpan> latencies(1000, TimeSpan::FromDays(100'000));
+	TimeSpan total;
+	for (const TimeSpan& latency : latencies)
+		total = total.AddSaturating(latency);
+	assert(total == TimeSpan::MaxValue() && "Expected the running sum to saturate");
+	assert(!TimeSpan::MaxValue().AddChecked(latencies.front()).has_value() && "Expected AddChecked to detect overflow");
+
+	return true;
+}
+
+static bool TestBasicDateTimePrecision()
+{
+	static_assert(std::is_same_v<DateTime, BasicDateTime<std::chrono::milliseconds>>);
+	static_assert(sizeof(DateTimeNanos) == sizeof(int64_t));
+	static_assert(DateTimeMicros::IsoStringLength == 27 && DateTimeNanos::IsoStringLength == 30);
+
+	// Components are exact at each precision
+	constexpr DateTimeNanos nanos = DateTimeNanos::FromUnixNanos(1'718'454'645'123'456'789);
+	static_assert(nanos.toUnixNanos() == 1'718'454'645'123'456'789);
+	static_assert(nanos.toUnixMicros() == 1'718'454'645'123'456);
+	assert(nanos.toString() == "2024-06-15T12:30:45.123456789Z" && "Expected 9 fractional digits");
+	assert(nanos.getMilliseconds() == 123 && nanos.getMicroseconds() == 456 && nanos.getNanoseconds() == 789 &&
+		   "Expected sub-millisecond components");
+
+	const DateTimeNanos::Components components = nanos.decompose();
+	assert(components.milliseconds == 123 && components.microseconds == 456 && components.nanoseconds == 789 &&
+		   "Expected sub-millisecond components from decompose()");
+
+	// Conversions round down to the coarser precision
+	constexpr DateTimeMicros micros(nanos);
+	static_assert(micros.toUnixMicros() == 1'718'454'645'123'456);
+	assert(micros.toString() == "2024-06-15T12:30:45.123456Z" && "Expected 6 fractional digits");
+	assert(DateTime(micros).toString() == "2024-06-15T12:30:45.123Z" && "Expected truncation to milliseconds");
+	assert(DateTime(DateTimeNanos::FromUnixNanos(-1)).toUnixMillis() == -1 && "Expected rounding to -infinity");
+	static_assert(DateTimeNanos(DateTime::FromUnixMillis(5)).toUnixNanos() == 5'000'000);
+
+	// Nanoseconds only cover the int64 range
+	assert(DateTimeNanos::TryCreate(1677, 9, 21, 0, 12, 43, 145.225).hasValue() && "Expected first valid day");
+	assert(DateTimeNanos::TryCreate(1677, 9, 21, 0, 12, 43, 145.224).error() == DateTimeError::YearOutOfRange &&
+		   "Expected the instant before the int64 range to be rejected");
+	assert(DateTimeNanos::TryCreate(2262, 4, 12, 0, 0, 0).error() == DateTimeError::YearOutOfRange &&
+		   "Expected 2262-04-12 to be rejected");
+	assert(DateTimeMicros::TryCreate(9999, 12, 31, 23, 59, 59, 999.999).hasValue() && "Expected full year range");
+
+	bool thrown = false;
+	try
+	{
+		(void)DateTimeNanos(DateTime(1, 1, 1, 0, 0, 0));
+	}
+	catch (const std::out_of_range&)
+	{
+		thrown = true;
+	}
+	assert(thrown && "Expected out_of_range when converting year 1 to nanoseconds");
+
+	// Parsing keeps the digits the precision can hold
+	assert(DateTimeNanos::Parse("2024-06-15T12:30:45.123456789Z") == nanos && "Expected fixed-layout parse");
+	assert(DateTimeMicros::Parse("2024-06-15T12:30:45.123456789Z") == micros && "Expected truncated parse");
+	assert(DateTimeNanos::Parse("2024-06-15T14:30:45,1234567+02:00").toUnixNanos() == 1'718'454'645'123'456'700 &&
+		   "Expected general parse with offset");
+	assert(!DateTimeNanos::TryParse("2300-01-01").has_value() && "Expected out of range parse to fail");
+	assert(DateTime::Parse("2024-06-15T12:30:45.123456789Z") == DateTime(2024, 6, 15, 12, 30, 45, 123) &&
+		   "Expected millisecond parse to truncate");
+
+	// Arithmetic with TimeSpan is exact in nanoseconds
+	static_assert((nanos + TimeSpan::FromNanoseconds(211)).toUnixNanos() == 1'718'454'645'123'457'000);
+	static_assert(nanos - DateTimeNanos(micros) == TimeSpan::FromNanoseconds(789));
+
+	// Formatting
+	assert(nanos.toString("%T") == "12:30:45.123456789" && "Expected %S with 9 fractional digits");
+	assert(std::format("{:%F %T}", micros) == "2024-06-15 12:30:45.123456" && "Expected std::format support");
+
+	return true;
+}
+
+static bool TestTimeZone()
+{
+	// ---- POSIX rules, available without the time zone database ----
+	const TimeZone paris = TimeZone::FromPosix("CET-1CEST,M3.5.0,M10.5.0/3");
+	assert(paris.toLocal(DateTime(2024, 1, 15, 12, 0, 0)) == DateTime(2024, 1, 15, 13, 0, 0) && "Expected CET");
+	assert(paris.toLocal(DateTime(2024, 7, 15, 12, 0, 0)) == DateTime(2024, 7, 15, 14, 0, 0) && "Expected CEST");
+	assert(paris.abbreviation(DateTime(2024, 7, 15, 12, 0, 0)) == "CEST" && "Expected the DST abbreviation");
+	assert(paris.isDaylightSavingTime(DateTime(2024, 7, 15, 12, 0, 0)) && "Expected DST in summer");
+	assert(paris.utcOffset(DateTime(2024, 12, 1, 0, 0, 0)) == TimeSpan::FromHours(1) && "Expected +1h in winter");
+
+	// Transitions happen at 01:00 UTC on the last Sunday of March and October
+	assert(paris.utcOffsetSeconds(DateTime(2024, 3, 31, 0, 59, 59).toUnixSeconds()) == 3'600 && "Expected CET");
+	assert(paris.utcOffsetSeconds(DateTime(2024, 3, 31, 1, 0, 0).toUnixSeconds()) == 7'200 && "Expected CEST");
+	assert(paris.utcOffsetSeconds(DateTime(2024, 10, 27, 1, 0, 0).toUnixSeconds()) == 3'600 && "Expected CET");
+
+	// The rule also applies before the table and beyond TimeZone::ExpandedUntilYear
+	assert(paris.toLocal(DateTime(1950, 7, 1, 0, 0, 0)) == DateTime(1950, 7, 1, 2, 0, 0) && "Expected rule in 1950");
+	assert(paris.toLocal(DateTime(2500, 7, 1, 0, 0, 0)) == DateTime(2500, 7, 1, 2, 0, 0) && "Expected rule in 2500");
+	assert(paris.toLocal(DateTime(2500, 12, 1, 0, 0, 0)) == DateTime(2500, 12, 1, 1, 0, 0) && "Expected rule in 2500");
+
+	// Local to UTC, including skipped and repeated local times
+	const DateTime local(2024, 6, 1, 8, 15, 30, 250);
+	assert(paris.fromLocal(local) == DateTime(2024, 6, 1, 6, 15, 30, 250) && "Expected unique local time");
+	assert(paris.fromLocal(DateTime(2024, 3, 31, 2, 30, 0)) == DateTime(2024, 3, 31, 1, 30, 0) &&
+		   "Expected skipped local time to move forward");
+	assert(paris.fromLocal(DateTime(2024, 10, 27, 2, 30, 0)) == DateTime(2024, 10, 27, 0, 30, 0) &&
+		   "Expected earliest repeated local time");
+	assert(paris.fromLocal(DateTime(2024, 10, 27, 2, 30, 0), LocalTimeChoice::Latest) ==
+			   DateTime(2024, 10, 27, 1, 30, 0) &&
+		   "Expected latest repeated local time");
+
+	// Southern hemisphere, with DST across the new year
+	const TimeZone sydney = TimeZone::FromPosix("AEST-10AEDT,M10.1.0,M4.1.0/3");
+	assert(sydney.toLocal(DateTime(2024, 1, 15, 0, 0, 0)) == DateTime(2024, 1, 15, 11, 0, 0) && "Expected AEDT");
+	assert(sydney.toLocal(DateTime(2024, 7, 15, 0, 0, 0)) == DateTime(2024, 7, 15, 10, 0, 0) && "Expected AEST");
+
+	// Fixed offsets and UTC
+	const TimeZone kolkata = TimeZone::FromPosix("<+0530>-5:30");
+	assert(kolkata.toLocal(DateTime(2024, 1, 1, 0, 0, 0)) == DateTime(2024, 1, 1, 5, 30, 0) && "Expected +05:30");
+	assert(kolkata.abbreviation(DateTime(2024, 1, 1, 0, 0, 0)) == "+0530" && "Expected quoted abbreviation");
+	assert(TimeZone::Utc().toLocal(local) == local && "Expected UTC to be the identity");
+
+	// ---- Columns ----
+	std::vector<DateTime> utc;
+	for (int64_t hour = 0; hour < 24 * 400; ++hour)
+		utc.push_back(DateTime::FromUnixSeconds(1'704'067'200 + hour * 3'600 + 59));
+
+	std::vector<DateTime> locals(utc.size(), DateTime::FromUnixMillis(0));
+	std::vector<DateTime> roundTrip(utc.size(), DateTime::FromUnixMillis(0));
+	paris.toLocal(utc, locals);
+	paris.fromLocal(locals, roundTrip, LocalTimeChoice::Latest);
+	for (std::size_t i = 0; i < utc.size(); ++i)
+	{
+		assert(locals[i] == paris.toLocal(utc[i]) && "Expected column to match single conversions");
+		assert(roundTrip[i] == paris.fromLocal(locals[i], LocalTimeChoice::Latest) &&
+			   "Expected column to match single conversions");
+		assert((roundTrip[i] == utc[i] || paris.fromLocal(locals[i]) == utc[i]) && "Expected round trip");
+	}
+
+	// ---- Errors ----
+	for (const char* rule : {"", "CET", "CET-1CEST,M3.5.0", "CET-1CEST,M13.5.0,M10.5.0", "C-1", "<+05-5"})
+	{
+		bool thrown = false;
+		try
+		{
+			(void)TimeZone::FromPosix(rule);
+		}
+		catch (const std::invalid_argument&)
+		{
+			thrown = true;
+		}
+		assert(thrown && "Expected invalid_argument for an invalid POSIX rule");
+	}
+
+	bool thrown = false;
+	try
+	{
+		(void)TimeZone::FromTzif("Broken", "TZif2");
+	}
+	catch (const std::invalid_argument&)
+	{
+		thrown = true;
+	}
+	assert(thrown && "Expected invalid_argument for invalid TZif data");
+	assert(!TimeZone::TryLoad("../etc/passwd").has_value() && "Expected names outside the database to be rejected");
+	assert(!TimeZone::TryLoad("Not/A_Zone").has_value() && "Expected unknown zone to fail");
+
+	// ---- Time zone database, when installed ----
+	if (const auto newYork = TimeZone::TryLoad("America/New_York"))
+	{
+		assert(newYork->name() == "America/New_York" && "Expected the zone name");
+		assert(newYork->toLocal(DateTime(2024, 7, 4, 16, 0, 0)) == DateTime(2024, 7, 4, 12, 0, 0) && "Expected EDT");
+		assert(newYork->toLocal(DateTime(1990, 1, 1, 5, 0, 0)) == DateTime(1990, 1, 1, 0, 0, 0) && "Expected EST");
+		assert(newYork->toLocal(DateTime(2400, 7, 4, 16, 0, 0)) == DateTime(2400, 7, 4, 12, 0, 0) &&
+			   "Expected the footer rule beyond the table");
+		assert(newYork->abbreviation(DateTime(1883, 1, 1, 0, 0, 0)) == "LMT" && "Expected local mean time");
+	}
+
+	return true;
+}
+
+static bool TestEncoding()
+{
+	// ---- Sortable keys ----
+	const std::vector<DateTime> sorted = {
+		DateTime(1, 1, 1, 0, 0, 0),
+		DateTime(1, 1, 1, 0, 0, 0, 1),
+		DateTime(1969, 12, 31, 23, 59, 59, 999),
+		DateTime::FromUnixMillis(0),
+		DateTime::FromUnixMillis(1),
+		DateTime::FromUnixMillis(255),
+		DateTime::FromUnixMillis(256),
+		DateTime(2024, 6, 15, 12, 30, 45, 123),
+		DateTime(9999, 12, 31, 23, 59, 59, 999),
+	};
+
+	std::vector<std::byte> keys(sorted.size() * encoding::KeySize);
+	encoding::encodeKeys(sorted, keys);
+	for (std::size_t i = 0; i < sorted.size(); ++i)
+	{
+		std::byte key[encoding::KeySize];
+		assert(encoding::encodeKey(sorted[i], key) == key + encoding::KeySize && "Expected 8 bytes to be written");
+		assert(std::memcmp(key, &keys[i * encoding::KeySize], encoding::KeySize) == 0 &&
+			   "Expected column to match single keys");
+		assert(encoding::decodeKey(key) == sorted[i] && "Expected key round trip");
+		if (i > 0)
+			assert(std::memcmp(&keys[(i - 1) * encoding::KeySize], key, encoding::KeySize) < 0 &&
+				   "Expected keys to sort like DateTimes");
+	}
+
+	const std::byte epochKey[] = {std::byte{0x80}, std::byte{0}, std::byte{0}, std::byte{0},
+								  std::byte{0},	   std::byte{0}, std::byte{0}, std::byte{0}};
+	assert(encoding::decodeKey(epochKey) == DateTime::FromUnixMillis(0) && "Expected big-endian, sign-flipped key");
+
+	std::vector<DateTime> decoded(sorted.size(), DateTime::FromUnixMillis(0));
+	encoding::decodeKeys(keys, decoded);
+	assert(decoded == sorted && "Expected key column round trip");
+
+	const std::byte invalidKey[encoding::KeySize] = {};
+	assert(!encoding::tryDecodeKey(invalidKey).has_value() && "Expected out of range key to be rejected");
+
+	// ---- TimeSpan varints ----
+	const std::vector<TimeSpan> spans = {
+		TimeSpan::FromNanoseconds(0),
+		TimeSpan::FromNanoseconds(-1),
+		TimeSpan::FromNanoseconds(63),
+		TimeSpan::FromNanoseconds(64),
+		TimeSpan::FromMilliseconds(-1),
+		TimeSpan::FromDays(365),
+		TimeSpan::MinValue(),
+		TimeSpan::MaxValue(),
+	};
+	const std::size_t expectedSizes[] = {1, 1, 1, 2, 3, 8, 10, 10};
+
+	std::byte varint[encoding::MaxVarintSize];
+	for (std::size_t i = 0; i < spans.size(); ++i)
+	{
+		const std::byte* end = encoding::encodeVarint(spans[i], varint);
+		assert(static_cast<std::size_t>(end - varint) == expectedSizes[i] && "Expected varint size");
+
+		TimeSpan value;
+		assert(encoding::decodeVarint(varint, end, value) == end && value == spans[i] && "Expected varint round trip");
+		assert(encoding::decodeVarint(varint, end - 1, value) == nullptr && "Expected truncated varint to fail");
+	}
+
+	std::vector<std::byte> varints(spans.size() * encoding::MaxVarintSize);
+	const std::size_t varintsSize = encoding::encodeVarints(spans, varints);
+	std::vector<TimeSpan> decodedSpans(spans.size());
+	assert(encoding::decodeVarints(std::span(varints).first(varintsSize), decodedSpans) == varintsSize &&
+		   "Expected every byte to be read");
+	assert(decodedSpans == spans && "Expected varint column round trip");
+
+	// More than 64 bits
+	std::byte overlong[encoding::MaxVarintSize + 1];
+	std::fill(std::begin(overlong), std::end(overlong), std::byte{0xFF});
+	overlong[encoding::MaxVarintSize] = std::byte{0x01};
+	TimeSpan ignored;
+	assert(encoding::decodeVarint(overlong, std::end(overlong), ignored) == nullptr && "Expected overlong to fail");
+
+	// ---- Delta-encoded DateTimes ----
+	std::vector<DateTime> events;
+	for (int64_t i = 0; i < 1'000; ++i)
+		events.push_back(DateTime::FromUnixMillis(1'718'454'645'000 + i * 250 - (i % 7 == 3 ? 40 : 0)));
+	events.push_back(DateTime(1, 1, 1, 0, 0, 0));
+	events.push_back(DateTime(9999, 12, 31, 23, 59, 59, 999));
+
+	std::vector<std::byte> deltas(encoding::maxDeltasSize(events.size()));
+	const std::size_t deltasSize = encoding::encodeDeltas(events, deltas);
+	assert(deltasSize < 2 * events.size() + 2 * encoding::MaxVarintSize + 6 && "Expected small deltas to take 2 bytes");
+
+	std::vector<DateTime> decodedEvents(events.size(), DateTime::FromUnixMillis(0));
+	assert(encoding::decodeDeltas(std::span(deltas).first(deltasSize), decodedEvents) == deltasSize &&
+		   "Expected every byte to be read");
+	assert(decodedEvents == events && "Expected delta round trip");
+
+	// ---- Errors ----
+	bool thrown = false;
+	try
+	{
+		encoding::encodeDeltas(events, std::span(deltas).first(deltasSize - 1));
+	}
+	catch (const std::invalid_argument&)
+	{
+		thrown = true;
+	}
+	assert(thrown && "Expected invalid_argument for a short output");
+
+	thrown = false;
+	try
+	{
+		encoding::decodeDeltas(std::span(deltas).first(deltasSize - 1), decodedEvents);
+	}
+	catch (const std::invalid_argument&)
+	{
+		thrown = true;
+	}
+	assert(thrown && "Expected invalid_argument for truncated input");
+
+	thrown = false;
+	try
+	{
+		encoding::decodeKey(invalidKey);
+	}
+	catch (const std::out_of_range&)
+	{
+		thrown = true;
+	}
+	assert(thrown && "Expected out_of_range for an invalid key");
+
+	return true;
+}
+
+static bool TestTimestampColumn()
+{
+	// ---- Regular series: one value per second, with a gap, a jitter and a jump ----
+	std::vector<DateTime> values;
+	int64_t unixMillis = 1'718'454'645'000;
+	for (int64_t i = 0; i < 5'000; ++i)
+	{
+		unixMillis += i == 1'234 ? 3'600'000 : 1'000;
+		values.push_back(DateTime::FromUnixMillis(unixMillis + (i % 97 == 5 ? 3 : 0)));
+	}
+
+	TimestampColumn column;
+	assert(column.empty() && column.isSorted() && "Expected empty column");
+	column.append(values);
+	assert(column.size() == values.size() && "Expected every value to be appended");
+	assert(column.blockCount() == (values.size() + TimestampColumn::BlockSize - 1) / TimestampColumn::BlockSize &&
+		   "Expected full blocks");
+	assert(column.isSorted() && "Expected sorted column");
+	assert(column.compressedBytes() * 8 < values.size() * 2 && "Expected under 2 bits per value");
+	assert(column.back() == values.back() && "Expected last value");
+
+	for (std::size_t i = 0; i < values.size(); i += 37)
+		assert(column.at(i) == values[i] && "Expected random access to match");
+	assert(column.at(TimestampColumn::BlockSize) == values[TimestampColumn::BlockSize] && "Expected block start");
+
+	std::vector<DateTime> decoded(values.size(), DateTime::FromUnixMillis(0));
+	column.decode(decoded);
+	assert(decoded == values && "Expected decode round trip");
+
+	std::vector<DateTime> window(700, DateTime::FromUnixMillis(0));
+	column.decode(1'000, window);
+	assert(std::equal(window.begin(), window.end(), values.begin() + 1'000) && "Expected range decode");
+
+	// ---- lowerBound ----
+	for (std::size_t i = 0; i < values.size(); i += 13)
+	{
+		assert(column.lowerBound(values[i]) == i && "Expected exact match");
+		assert(column.lowerBound(values[i] + TimeSpan::FromMilliseconds(1)) == i + 1 && "Expected next value");
+	}
+	assert(column.lowerBound(DateTime(2000, 1, 1, 0, 0, 0)) == 0 && "Expected bound before the first value");
+	assert(column.lowerBound(DateTime(2100, 1, 1, 0, 0, 0)) == values.size() && "Expected bound past the end");
+
+	// ---- Irregular values, including the extremes of the DateTime range ----
+	TimestampColumn irregular;
+	std::vector<DateTime> mixed = {DateTime(2024, 1, 1, 0, 0, 0), DateTime(1, 1, 1, 0, 0, 0),
+								   DateTime(9999, 12, 31, 23, 59, 59, 999), DateTime::FromUnixMillis(-1)};
+	for (int64_t i = 0; i < 2'000; ++i)
+		mixed.push_back(DateTime::FromUnixMillis(i * i * 7'919 % 1'000'003 - 500'000));
+	irregular.append(mixed);
+	assert(!irregular.isSorted() && "Expected unsorted column");
+
+	std::vector<DateTime> mixedDecoded(mixed.size(), DateTime::FromUnixMillis(0));
+	irregular.decode(mixedDecoded);
+	assert(mixedDecoded == mixed && "Expected irregular round trip");
+	for (std::size_t i = 0; i < mixed.size(); ++i)
+		assert(irregular.at(i) == mixed[i] && "Expected irregular random access");
+
+	irregular.shrinkToFit();
+	irregular.append(DateTime::FromUnixMillis(42));
+	assert(irregular.at(mixed.size()) == DateTime::FromUnixMillis(42) && "Expected append after shrinkToFit");
+
+	irregular.clear();
+	assert(irregular.empty() && irregular.blockCount() == 0 && "Expected cleared column");
+
+	// ---- Errors ----
+	bool thrown = false;
+	try
+	{
+		(void)column.at(values.size());
+	}
+	catch (const std::out_of_range&)
+	{
+		thrown = true;
+	}
+	assert(thrown && "Expected out_of_range for an index past the end");
+
+	thrown = false;
+	try
+	{
+		column.decode(values.size() - 10, window);
+	}
+	catch (const std::out_of_range&)
+	{
+		thrown = true;
+	}
+	assert(thrown && "Expected out_of_range for a range past the end");
+
+	return true;
+}
+
+static bool TestDateTimeIndex()
+{
+	// Sizes around node and layer boundaries, with duplicates
+	for (std::size_t size : {0, 1, 7, 8, 9, 72, 73, 81, 1'000, 10'007})
+	{
+		std::vector<DateTime> values;
+		for (std::size_t i = 0; i < size; ++i)
+			values.push_back(DateTime::FromUnixMillis(static_cast<int64_t>(i / 3) * 10 - 5'000));
+
+		const DateTimeIndex index(values);
+		assert(index.size() == size && index.empty() == (size == 0) && "Expected index size");
+
+		std::vector<DateTime> queries;
+		for (int64_t millis = -5'020; millis <= static_cast<int64_t>(size) * 4 - 4'980; millis += 3)
+			queries.push_back(DateTime::FromUnixMillis(millis));
+		queries.push_back(DateTime(1, 1, 1, 0, 0, 0));
+		queries.push_back(DateTime(9999, 12, 31, 23, 59, 59, 999));
+
+		std::vector<std::size_t> bounds(queries.size());
+		index.lowerBounds(queries, bounds);
+		for (std::size_t i = 0; i < queries.size(); ++i)
+		{
+			const auto lower = std::lower_bound(values.begin(), values.end(), queries[i]) - values.begin();
+			const auto upper = std::upper_bound(values.begin(), values.end(), queries[i]) - values.begin();
+			assert(index.lowerBound(queries[i]) == static_cast<std::size_t>(lower) && "Expected std::lower_bound");
+			assert(index.upperBound(queries[i]) == static_cast<std::size_t>(upper) && "Expected std::upper_bound");
+			assert(bounds[i] == static_cast<std::size_t>(lower) && "Expected bulk search to match");
+
+			const auto [first, last] = index.equalRange(queries[i]);
+			assert(first == static_cast<std::size_t>(lower) && last == static_cast<std::size_t>(upper) &&
+				   "Expected std::equal_range");
+		}
+	}
+
+	const std::vector<DateTime> hours = {DateTime(2024, 1, 1, 0, 0, 0), DateTime(2024, 1, 1, 1, 0, 0),
+										 DateTime(2024, 1, 1, 2, 0, 0), DateTime(2024, 1, 1, 3, 0, 0)};
+	const DateTimeIndex hourIndex(hours);
+	const auto [first, last] = hourIndex.range(DateTime(2024, 1, 1, 0, 30, 0), DateTime(2024, 1, 1, 3, 0, 0));
+	assert(first == 1 && last == 3 && "Expected half-open range");
+	const auto [emptyFirst, emptyLast] = hourIndex.range(hours[3], hours[0]);
+	assert(emptyFirst == emptyLast && "Expected empty range when from > to");
+
+	bool thrown = false;
+	try
+	{
+		const std::vector<DateTime> unsorted = {hours[1], hours[0]};
+		(void)DateTimeIndex(unsorted);
+	}
+	catch (const std::invalid_argument&)
+	{
+		thrown = true;
+	}
+	assert(thrown && "Expected invalid_argument for unsorted values");
+
+	return true;
+}
+
+static bool TestDateTimeRounding()
+{
+	// Fixed intervals from the Unix epoch
+	const DateTime time(2024, 5, 17, 10, 7, 30, 500);
+	const TimeSpan quarterHour = TimeSpan::FromMinutes(15);
+	assert(time.floor(quarterHour) == DateTime(2024, 5, 17, 10, 0, 0) && "Expected floor to 15 minutes");
+	assert(time.ceil(quarterHour) == DateTime(2024, 5, 17, 10, 15, 0) && "Expected ceil to 15 minutes");
+	assert(time.round(quarterHour) == DateTime(2024, 5, 17, 10, 15, 0) && "Expected round to 15 minutes");
+	assert(DateTime(2024, 5, 17, 10, 7, 29, 999).round(quarterHour) == DateTime(2024, 5, 17, 10, 0, 0) &&
+		   "Expected round down below halfway");
+	assert(DateTime(2024, 5, 17, 10, 7, 30).round(quarterHour) == DateTime(2024, 5, 17, 10, 15, 0) &&
+		   "Expected halfway values to round up");
+	assert(time.floor(quarterHour).ceil(quarterHour) == time.floor(quarterHour) && "Expected ceil to keep bounds");
+	static_assert(DateTime::FromUnixMillis(-1).floor(TimeSpan::FromSeconds(1)) == DateTime::FromUnixMillis(-1'000));
+
+	// Origin
+	const DateTime origin(2024, 1, 1, 0, 0, 5);
+	assert(time.floor(TimeSpan::FromMinutes(1), origin) == DateTime(2024, 5, 17, 10, 7, 5) && "Expected origin");
+	assert(DateTime(2000, 1, 1, 0, 0, 0).floor(TimeSpan::FromMinutes(1), origin) == DateTime(1999, 12, 31, 23, 59, 5) &&
+		   "Expected origin after the value");
+	const DateTime monday(2024, 5, 13, 0, 0, 0);
+	assert(time.floor(TimeSpan::FromDays(7), monday) == monday && "Expected 7 day intervals from a Monday");
+
+	// Precision
+	const DateTimeNanos nanos = DateTimeNanos::FromUnixNanos(1'234'567'891);
+	assert(nanos.floor(TimeSpan::FromMicroseconds(1)) == DateTimeNanos::FromUnixNanos(1'234'567'000) &&
+		   "Expected floor at nanosecond precision");
+	assert(nanos.round(TimeSpan::FromNanoseconds(10)) == DateTimeNanos::FromUnixNanos(1'234'567'890) &&
+		   "Expected round at nanosecond precision");
+
+	for (const TimeSpan& interval : {TimeSpan(), TimeSpan::FromMicroseconds(999), TimeSpan::FromMilliseconds(-1)})
+	{
+		bool thrown = false;
+		try
+		{
+			(void)time.floor(interval);
+		}
+		catch (const std::invalid_argument&)
+		{
+			thrown = true;
+		}
+		assert(thrown && "Expected invalid_argument for an interval shorter than the precision");
+	}
+
+	// Calendar units
+	assert(time.floor(CalendarUnit::Day) == DateTime(2024, 5, 17, 0, 0, 0) && "Expected day");
+	assert(time.floor(CalendarUnit::Week) == monday && "Expected ISO week to start on Monday");
+	assert(DateTime(2024, 5, 19, 23, 0, 0).floor(CalendarUnit::Week) == monday && "Expected Sunday in the week");
+	assert(time.floor(CalendarUnit::Month) == DateTime(2024, 5, 1, 0, 0, 0) && "Expected month");
+	assert(time.floor(CalendarUnit::Quarter) == DateTime(2024, 4, 1, 0, 0, 0) && "Expected quarter");
+	assert(time.floor(CalendarUnit::Year) == DateTime(2024, 1, 1, 0, 0, 0) && "Expected year");
+	assert(time.ceil(CalendarUnit::Week) == DateTime(2024, 5, 20, 0, 0, 0) && "Expected next week");
+	assert(time.ceil(CalendarUnit::Quarter) == DateTime(2024, 7, 1, 0, 0, 0) && "Expected next quarter");
+	assert(DateTime(2024, 2, 1, 0, 0, 0).ceil(CalendarUnit::Month) == DateTime(2024, 2, 1, 0, 0, 0) &&
+		   "Expected ceil to keep a month start");
+	assert(DateTime(2024, 2, 15, 12, 0, 0).round(CalendarUnit::Month) == DateTime(2024, 3, 1, 0, 0, 0) &&
+		   "Expected halfway through a leap February to round up");
+	assert(DateTime(2023, 2, 14, 23, 0, 0).round(CalendarUnit::Month) == DateTime(2023, 2, 1, 0, 0, 0) &&
+		   "Expected round down before halfway");
+	assert(time.round(CalendarUnit::Year) == DateTime(2024, 1, 1, 0, 0, 0) && "Expected round to year");
+	assert(DateTime(1, 1, 1, 0, 0, 0).floor(CalendarUnit::Week) == DateTime(1, 1, 1, 0, 0, 0) &&
+		   "Expected 0001-01-01 to be a Monday");
+	static_assert(DateTime::FromUnixSeconds(0).floor(CalendarUnit::Week) == DateTime(1969, 12, 29, 0, 0, 0));
+	assert(DateTimeNanos(time).floor(CalendarUnit::Month) == DateTimeNanos(DateTime(2024, 5, 1, 0, 0, 0)) &&
+		   "Expected calendar floor at nanosecond precision");
+
+	bool thrown = false;
+	try
+	{
+		(void)DateTime(9999, 12, 31, 23, 59, 59, 999).ceil(CalendarUnit::Day);
+	}
+	catch (const std::out_of_range&)
+	{
+		thrown = true;
+	}
+	assert(thrown && "Expected out_of_range after 9999-12-31");
+
+	// Batch buckets match floor for every unit and instruction set
+	std::vector<DateTime> values;
+	for (int64_t millis = -5'000'000'000'000; millis < 5'000'000'000'000; millis += 3'917'654'321)
+		values.push_back(DateTime::FromUnixMillis(millis));
+	values.push_back(DateTime(1, 1, 1, 0, 0, 0));
+	values.push_back(DateTime(9999, 12, 31, 23, 59, 59, 999));
+	values.push_back(DateTime(1969, 12, 31, 23, 59, 59, 999));
+
+	std::vector<int64_t> ids(values.size());
+	for (const CalendarUnit unit :
+		 {CalendarUnit::Day, CalendarUnit::Week, CalendarUnit::Month, CalendarUnit::Quarter, CalendarUnit::Year})
+	{
+		for (const batch::Isa isa : {batch::Isa::Scalar, batch::Isa::Avx2, batch::Isa::Avx512})
+		{
+			batch::bucketize(values, unit, ids, isa);
+			for (std::size_t i = 0; i < values.size(); ++i)
+				assert(batch::bucketStart(ids[i], unit) == values[i].floor(unit) && "Expected bucket of floor");
+		}
+	}
+
+	std::vector<int64_t> monthIds(2);
+	batch::bucketize(std::vector<DateTime>{DateTime(1970, 1, 31, 0, 0, 0), DateTime(1969, 12, 1, 0, 0, 0)},
+					 CalendarUnit::Month,
+					 monthIds);
+	assert(monthIds[0] == 0 && monthIds[1] == -1 && "Expected months since January 1970");
+
+	for (const TimeSpan& interval : {TimeSpan::FromMilliseconds(1), TimeSpan::FromMinutes(15), TimeSpan::FromDays(7)})
+	{
+		batch::bucketize(values, interval, ids, monday);
+		for (std::size_t i = 0; i < values.size(); ++i)
+			assert(batch::bucketStart(ids[i], interval, monday) == values[i].floor(interval, monday) &&
+				   "Expected interval bucket of floor");
+	}
+
+	thrown = false;
+	try
+	{
+		(void)batch::bucketStart(int64_t{1} << 40, CalendarUnit::Year);
+	}
+	catch (const std::out_of_range&)
+	{
+		thrown = true;
+	}
+	assert(thrown && "Expected out_of_range for a bucket after 9999");
+
+	thrown = false;
+	try
+	{
+		batch::bucketize(values, CalendarUnit::Day, std::span<int64_t>(ids).first(1));
+	}
+	catch (const std::invalid_argument&)
+	{
+		thrown = true;
+	}
+	assert(thrown && "Expected invalid_argument for a short output column");
+
+	return true;
+}
+
+static bool TestSortByTime()
+{
+	// Sizes around the comparison sort threshold, with wide ranges (8 passes) and narrow ones (skipped passes)
+	for (const std::size_t size : {0, 1, 255, 256, 1'000, 200'000})
+	{
+		for (const int64_t spread : {int64_t{1}, int64_t{86'400'000}, int64_t{315'537'897'600'000}})
+		{
+			std::vector<DateTime> values;
+			uint64_t state = 12345;
+			for (std::size_t i = 0; i < size; ++i)
+			{
+				state = state * 6364136223846793005 + 1442695040888963407;
+				const auto offset = static_cast<int64_t>((state >> 11) % static_cast<uint64_t>(spread));
+				values.push_back(DateTime::FromUnixMillis(-62'135'596'800'000 + offset));
+			}
+
+			std::vector<DateTime> expected = values;
+			std::sort(expected.begin(), expected.end());
+			for (const unsigned threads : {1u, 3u})
+			{
+				std::vector<DateTime> sorted = values;
+				sortByTime(sorted, threads);
+				assert(sorted == expected && "Expected sorted DateTimes");
+			}
+		}
+	}
+
+	// Records, by a projected DateTime: stable, with every field moved along
+	struct Event
+	{
+		DateTime time;
+		std::string name;
+		std::size_t sequence;
+	};
+
+	for (const std::size_t size : {10, 150'000})
+	{
+		std::vector<Event> events;
+		for (std::size_t i = 0; i < size; ++i)
+		{
+			const auto minute = static_cast<int64_t>(i * 7'919 % 1'000);
+			events.push_back({DateTime::FromUnixMillis(1'700'000'000'000 + minute * 60'000), std::to_string(i), i});
+		}
+
+		for (const unsigned threads : {1u, 2u})
+		{
+			std::vector<Event> sorted = events;
+			sortByTime(std::span<Event>(sorted), &Event::time, threads);
+			for (std::size_t i = 0; i < size; ++i)
+			{
+				assert(sorted[i].name == std::to_string(sorted[i].sequence) && "Expected records moved whole");
+				if (i != 0)
+				{
+					assert(sorted[i - 1].time <= sorted[i].time && "Expected records sorted by time");
+					assert((sorted[i - 1].time < sorted[i].time || sorted[i - 1].sequence < sorted[i].sequence) &&
+						   "Expected a stable sort");
+				}
+			}
+		}
+	}
+
+	return true;
+}
+
+static bool TestLogScanner()
+{
+	// Leading timestamps
+	assert(parseLineTimestamp("2024-06-15T12:30:45.500Z GET /index.html") == DateTime(2024, 6, 15, 12, 30, 45, 500) &&
+		   "Expected toString() layout");
+	assert(parseLineTimestamp("2024-06-15 12:30:45,250 INFO started") == DateTime(2024, 6, 15, 12, 30, 45, 250) &&
+		   "Expected space separator and comma fraction");
+	assert(parseLineTimestamp("[2024-06-15T14:30:45+02:00] warning") == DateTime(2024, 6, 15, 12, 30, 45) &&
+		   "Expected bracketed timestamp with offset");
+	assert(parseLineTimestamp("2024-06-15\tjob") == DateTime(2024, 6, 15, 0, 0, 0) && "Expected date alone");
+	assert(parseLineTimestamp("2024-06-15T12:30:45Z\r") == DateTime(2024, 6, 15, 12, 30, 45) &&
+		   "Expected CRLF line");
+	assert(!parseLineTimestamp("    at com.example.Main(Main.java:12)") && "Expected no timestamp");
+	assert(!parseLineTimestamp("") && !parseLineTimestamp("[") && "Expected no timestamp in empty lines");
+	assert(!parseLineTimestamp("2024-13-15T12:30:45Z x") && "Expected invalid dates to be rejected");
+
+	// Offsets and line counts, on a text large enough to be split between threads
+	std::string text;
+	std::vector<LogTimestamp> expected;
+	for (int i = 0; text.size() < (std::size_t{3} << 20); ++i)
+	{
+		const DateTime time = DateTime::FromUnixMillis(1'718'454'645'000 + i * 37);
+		if (i % 5 == 4)
+			text += "    continuation line without a timestamp\n";
+		expected.push_back({text.size(), time});
+		text += time.toString() + " request " + std::to_string(i) + '\n';
+	}
+	expected.push_back({text.size(), DateTime(2024, 6, 15, 12, 0, 0)});
+	text += "2024-06-15 12:00:00 last line without newline";
+
+	for (const unsigned threads : {1u, 3u})
+	{
+		const LogScan scan = scanLogTimestamps(text, threads);
+		assert(scan.bytes == text.size() && "Expected scanned bytes");
+		assert(scan.lines == expected.size() + expected.size() / 5 && "Expected every line counted");
+		assert(scan.timestamps.size() == expected.size() && "Expected one timestamp per line with one");
+		for (std::size_t i = 0; i < expected.size(); ++i)
+			assert(scan.timestamps[i].offset == expected[i].offset && scan.timestamps[i].time == expected[i].time &&
+				   "Expected offsets and timestamps in file order");
+	}
+
+	// Memory-mapped files
+	const std::string path = (std::filesystem::temp_directory_path() / "onion_log_scanner_test.log").string();
+	{
+		std::ofstream file(path, std::ios::binary);
+		file << "2024-06-15T12:30:45.500Z a\nno timestamp\n2024-06-16T00:00:00.000Z b\n";
+	}
+	const LogScan fileScan = scanLogFile(path);
+	assert(fileScan.lines == 3 && fileScan.timestamps.size() == 2 && fileScan.timestamps[1].offset == 40 &&
+		   "Expected file scan");
+	std::ofstream(path, std::ios::binary | std::ios::trunc).close();
+	assert(scanLogFile(path).lines == 0 && "Expected empty file scan");
+	std::filesystem::remove(path);
+
+	bool thrown = false;
+	try
+	{
+		(void)scanLogFile(path);
+	}
+	catch (const std::system_error&)
+	{
+		thrown = true;
+	}
+	assert(thrown && "Expected system_error for a missing file");
+
+	return true;
+}
+
+static bool TestTimeBucketAggregator()
+{
+	// Hashing
+	std::unordered_set<DateTime> seen;
+	const DateTime base(2024, 6, 15, 12, 0, 0);
+	for (int i = 0; i < 1000; ++i)
+		seen.insert(base + TimeSpan::FromMilliseconds(i));
+	seen.insert(base);
+	assert(seen.size() == 1000 && seen.contains(base + TimeSpan::FromMilliseconds(999)) && "Expected DateTime keys");
+	assert(std::hash<DateTime>{}(base) != std::hash<DateTime>{}(base + TimeSpan::FromMilliseconds(1)) &&
+		   "Expected nearby instants to hash differently");
+	std::unordered_map<TimeSpan, int> spans{{TimeSpan::FromMinutes(1), 1}, {TimeSpan::FromSeconds(60), 2}};
+	assert(spans.size() == 1 && spans[TimeSpan::FromMinutes(1)] == 1 && "Expected TimeSpan keys");
+
+	// Buckets from an origin, including instants before it
+	TimeBucketAggregator<double> latency(TimeSpan::FromMinutes(5), 1, DateTime(2024, 6, 15, 12, 1, 0));
+	latency.shard(0).add(DateTime(2024, 6, 15, 12, 1, 0), 1.5);
+	latency.shard(0).add(DateTime(2024, 6, 15, 12, 5, 59, 999), 2.5);
+	latency.shard(0).add(DateTime(2024, 6, 15, 12, 0, 59, 999), 4.0);
+	latency.shard(0).add(DateTime(2024, 6, 15, 12, 6, 0), 8.0);
+	const auto minutes = latency.buckets();
+	assert(minutes.size() == 3 && "Expected three buckets");
+	assert(minutes[0].start == DateTime(2024, 6, 15, 11, 56, 0) && minutes[0].count == 1 && minutes[0].sum == 4.0 &&
+		   "Expected bucket before the origin");
+	assert(minutes[1].start == DateTime(2024, 6, 15, 12, 1, 0) && minutes[1].count == 2 && minutes[1].sum == 4.0 &&
+		   "Expected bucket at the origin");
+	assert(minutes[2].start == DateTime(2024, 6, 15, 12, 6, 0) && minutes[2].sum == 8.0 && "Expected next bucket");
+	assert(latency.find(DateTime(2024, 6, 15, 12, 3, 0))->count == 2 && "Expected find");
+	assert(!latency.find(DateTime(2024, 6, 15, 13, 0, 0)) && "Expected no empty bucket");
+
+	// Shards written from several threads, merged on read, across table growth
+	constexpr int Threads = 4;
+	constexpr int Events = 20000;
+	TimeBucketAggregator<> counts(TimeSpan::FromSeconds(1), Threads);
+	std::vector<std::thread> writers;
+	for (int t = 0; t < Threads; ++t)
+	{
+		writers.emplace_back(
+			[&counts, t]
+			{
+				auto& shard = counts.shard(static_cast<std::size_t>(t));
+				for (int i = 0; i < Events; ++i)
+					shard.add(DateTime::FromUnixMillis(1'718'454'645'000 + int64_t{i} * 250 + t), i % 7);
+			});
+	}
+	for (std::thread& writer : writers)
+		writer.join();
+
+	const auto seconds = counts.buckets();
+	assert(seconds.size() == Events / 4 && "Expected one bucket per second");
+	uint64_t total = 0;
+	for (std::size_t i = 0; i < seconds.size(); ++i)
+	{
+		assert(seconds[i].count == 4 * Threads && "Expected merged counts");
+		assert((i == 0 || seconds[i].start - seconds[i - 1].start == TimeSpan::FromSeconds(1)) &&
+			   "Expected buckets in order");
+		total += seconds[i].count;
+	}
+	assert(total == uint64_t{Threads} * Events && "Expected every event counted");
+	int64_t sum = 0;
+	for (int i = 0; i < Events; ++i)
+		sum += i % 7;
+	int64_t mergedSum = 0;
+	for (const auto& bucket : seconds)
+		mergedSum += bucket.sum;
+	assert(mergedSum == sum * Threads && "Expected merged sums");
+
+	counts.clear();
+	assert(counts.buckets().empty() && counts.shard(0).size() == 0 && "Expected empty aggregator after clear");
+	counts.shard(1).add(DateTime(1, 1, 1, 0, 0, 0));
+	counts.shard(2).add(DateTime(9999, 12, 31, 23, 59, 59, 999));
+	const auto extremes = counts.buckets();
+	assert(extremes.size() == 2 && extremes[0].start == DateTime(1, 1, 1, 0, 0, 0) &&
+		   extremes[1].start == DateTime(9999, 12, 31, 23, 59, 59) && "Expected extreme buckets");
+
+	// Intervals truncated to whole milliseconds
+	TimeBucketAggregator<> truncated(TimeSpan::FromMicroseconds(1500), 1);
+	assert(truncated.interval() == TimeSpan::FromMilliseconds(1) && "Expected interval truncated to milliseconds");
+	truncated.shard(0).add(DateTime::FromUnixMillis(1));
+	truncated.shard(0).add(DateTime::FromUnixMillis(2));
+	const auto milliseconds = truncated.buckets();
+	assert(milliseconds.size() == 2 && milliseconds[1].start - milliseconds[0].start == truncated.interval() &&
+		   milliseconds[1].start == DateTime::FromUnixMillis(2).floor(truncated.interval(), truncated.origin()) &&
+		   "Expected buckets as wide as interval()");
+
+	// Invalid arguments
+	int thrown = 0;
+	try
+	{
+		TimeBucketAggregator<> invalid(TimeSpan::FromMilliseconds(0), 1);
+	}
+	catch (const std::invalid_argument&)
+	{
+		++thrown;
+	}
+	try
+	{
+		TimeBucketAggregator<> invalid(TimeSpan::FromMicroseconds(999), 1);
+	}
+	catch (const std::invalid_argument&)
+	{
+		++thrown;
+	}
+	try
+	{
+		TimeBucketAggregator<> invalid(TimeSpan::FromSeconds(1), 0);
+	}
+	catch (const std::invalid_argument&)
+	{
+		++thrown;
+	}
+	try
+	{
+		(void)counts.shard(Threads);
+	}
+	catch (const std::out_of_range&)
+	{
+		++thrown;
+	}
+	assert(thrown == 4 && "Expected invalid intervals, shard counts and shard indexes to be rejected");
+
+	return true;
+}
+
+static bool TestTimerWheel()
+{
+	const DateTime start(2024, 6, 15, 12, 0, 0);
+	TimerWheel<int> wheel(start);
+	assert(wheel.now() == start && wheel.empty() && "Expected empty wheel at its start");
+
+	// Expiry in order of due time, never early
+	wheel.schedule(start + TimeSpan::FromSeconds(2), 2);
+	wheel.schedule(start + TimeSpan::FromMilliseconds(1500), 1);
+	const auto cancelled = wheel.schedule(start + TimeSpan::FromSeconds(1), 99);
+	wheel.schedule(start + TimeSpan::FromDays(400), 3);
+	wheel.schedule(start - TimeSpan::FromSeconds(5), 0);
+	assert(wheel.size() == 5 && wheel.contains(cancelled) && "Expected pending timers");
+	assert(wheel.cancel(cancelled) && !wheel.contains(cancelled) && !wheel.cancel(cancelled) && "Expected cancel");
+
+	std::vector<int> expired;
+	assert(wheel.advance(start + TimeSpan::FromMilliseconds(1499), expired) == 1 && expired == std::vector<int>{0} &&
+		   "Expected only the overdue timer");
+	assert(wheel.advance(start + TimeSpan::FromSeconds(2), expired) == 2 && expired == std::vector<int>({0, 1, 2}) &&
+		   "Expected timers due by then, in order");
+	assert(wheel.now() == start + TimeSpan::FromSeconds(2) && wheel.size() == 1 && "Expected current time");
+	wheel.advance(start + TimeSpan::FromDays(399), expired);
+	assert(expired.size() == 3 && "Expected far timer still pending");
+	wheel.advance(DateTime(9999, 12, 31, 23, 59, 59, 999), expired);
+	assert(expired.size() == 4 && expired[3] == 3 && wheel.empty() && "Expected far timer after cascading");
+	assert(wheel.advance(start, expired) == 0 && wheel.now() == DateTime(9999, 12, 31, 23, 59, 59, 999) &&
+		   "Expected time to never move back");
+
+	// Against a sorted reference, with random schedules, cancels and advances at several scales
+	std::mt19937_64 rng(7);
+	TimerWheel<uint64_t> random(start, TimeSpan::FromMilliseconds(10));
+	std::multimap<uint64_t, uint64_t> reference; // due tick -> id
+	std::vector<std::pair<TimerWheel<uint64_t>::Handle, uint64_t>> handles;
+	std::vector<uint64_t> dueTicks;
+	int64_t nowMillis = 0;
+	for (int round = 0; round < 200; ++round)
+	{
+		for (int i = 0; i < 200; ++i)
+		{
+			const int64_t delay = static_cast<int64_t>(rng() % (uint64_t{1} << (rng() % 40)));
+			const DateTime due = start + TimeSpan::FromMilliseconds(nowMillis + delay);
+			const uint64_t id = dueTicks.size();
+			dueTicks.push_back(static_cast<uint64_t>(nowMillis + delay + 9) / 10);
+			handles.emplace_back(random.schedule(due, id), id);
+			reference.emplace(dueTicks[id], id);
+		}
+		for (int i = 0; i < 50; ++i)
+		{
+			const auto& [handle, id] = handles[rng() % handles.size()];
+			const bool pending = random.contains(handle);
+			assert(random.cancel(handle) == pending && !random.contains(handle) && "Expected cancel of pending timers");
+			if (pending)
+			{
+				const auto [first, last] = reference.equal_range(dueTicks[id]);
+				reference.erase(std::find_if(first, last, [id](const auto& entry) { return entry.second == id; }));
+			}
+		}
+
+		nowMillis += static_cast<int64_t>(rng() % (uint64_t{1} << (rng() % 36)));
+		std::vector<uint64_t> fired;
+		random.advance(start + TimeSpan::FromMilliseconds(nowMillis), fired);
+		const auto end = reference.upper_bound(static_cast<uint64_t>(nowMillis) / 10);
+		assert(fired.size() == static_cast<std::size_t>(std::distance(reference.begin(), end)) &&
+			   "Expected every due timer");
+		for (std::size_t i = 0; i < fired.size(); ++i)
+			assert((i == 0 || dueTicks[fired[i - 1]] <= dueTicks[fired[i]]) &&
+				   dueTicks[fired[i]] <= static_cast<uint64_t>(nowMillis) / 10 && "Expected due timers in order");
+		reference.erase(reference.begin(), end);
+		assert(random.size() == reference.size() && "Expected pending count");
+	}
+
+	// Rescheduling and cancelling from the callback
+	TimerWheel<int> retries(start);
+	retries.schedule(start + TimeSpan::FromMilliseconds(10), 1);
+	const auto other = retries.schedule(start + TimeSpan::FromMilliseconds(12), 2);
+	int calls = 0;
+	const auto retry = [&](int value)
+	{
+		++calls;
+		if (value == 1)
+		{
+			retries.cancel(other);
+			retries.schedule(retries.now(), 3);
+			retries.schedule(retries.now() + TimeSpan::FromMilliseconds(5), 4);
+		}
+	};
+	assert(retries.advance(start + TimeSpan::FromMilliseconds(20), retry) == 3 && calls == 3 && retries.empty() &&
+		   "Expected the callback to cancel a timer, and timers it schedules to fire within the advance");
+	retries.schedule(start, 5);
+	assert(retries.advance(start, retry) == 1 && calls == 4 && "Expected an overdue timer to fire on the next advance");
+
+	bool thrown = false;
+	try
+	{
+		TimerWheel<int> invalid(start, TimeSpan::FromMicroseconds(500));
+	}
+	catch (const std::invalid_argument&)
+	{
+		thrown = true;
+	}
+	assert(thrown && "Expected resolutions under 1 ms to be rejected");
+
+	return true;
+}
+
+static bool TestStopwatch()
+{
+	const SteadyStamp first = SteadyStamp::Now();
+	const SteadyStamp second = SteadyStamp::Now();
+	assert(second >= first && "Expected monotonic stamps");
+	assert(second - first >= TimeSpan::Zero() && second - first < TimeSpan::FromMilliseconds(100) &&
+		   first - second <= TimeSpan::Zero() && "Expected signed differences");
+
+	// Laps against steady_clock, which the counter is calibrated on
+	Stopwatch watch;
+	const auto steadyStart = std::chrono::steady_clock::now();
+	std::this_thread::sleep_for(std::chrono::milliseconds(50));
+	const TimeSpan sleeping = watch.lap();
+	const TimeSpan steady = TimeSpan(std::chrono::steady_clock::now() - steadyStart);
+	assert(sleeping >= TimeSpan::FromMilliseconds(50) - TimeSpan::FromMicroseconds(500) && "Expected the sleep");
+	assert(sleeping <= steady + TimeSpan::FromMicroseconds(500) &&
+		   sleeping >= steady - steady / 100 - TimeSpan::FromMicroseconds(500) &&
+		   "Expected the calibrated counter to agree with steady_clock");
+
+	const TimeSpan idle = watch.lap();
+	assert(idle >= TimeSpan::Zero() && idle < TimeSpan::FromMilliseconds(50) && "Expected a short second lap");
+	assert(watch.elapsed() >= sleeping + idle && "Expected elapsed time to cover the laps");
+
+	watch.restart();
+	assert(watch.elapsed() < sleeping && watch.started() >= second && "Expected restart");
+
+	return true;
+}
+
+static bool TestLatencyHistogram()
+{
+	using Histogram = LatencyHistogram;
+
+	// Buckets cover every non-negative value, within 1/128 of it
+	for (const uint64_t value : {uint64_t{0},
+								 uint64_t{1},
+								 uint64_t{255},
+								 uint64_t{256},
+								 uint64_t{257},
+								 uint64_t{1'000'000},
+								 (uint64_t{1} << 40) + 12345,
+								 uint64_t{INT64_MAX}})
+	{
+		const std::size_t index = Histogram::BucketIndex(value);
+		assert(index < Histogram::BucketCount && "Expected a bucket in range");
+		assert(Histogram::BucketLowest(index) <= value && value <= Histogram::BucketHighest(index) &&
+			   "Expected the value within its bucket");
+		assert((value < 256 ? Histogram::BucketLowest(index) == value
+							: (Histogram::BucketHighest(index) - Histogram::BucketLowest(index)) * 128 <= value) &&
+			   "Expected exact small buckets and relative width under 1/128");
+	}
+	assert(Histogram::BucketIndex(INT64_MAX) == Histogram::BucketCount - 1 && "Expected the last bucket");
+
+	// Percentiles and mean of 1..100000 ns
+	Histogram::Snapshot uniform;
+	for (int64_t i = 1; i <= 100'000; ++i)
+		uniform.record(TimeSpan::FromNanoseconds(i));
+	assert(uniform.count() == 100'000 && uniform.mean() == TimeSpan::FromNanoseconds(50'000) && "Expected mean");
+	for (const double percent : {50.0, 99.0, 99.9})
+	{
+		const auto exact = static_cast<int64_t>(percent * 1000);
+		const int64_t value = uniform.percentile(percent).TotalNanoseconds();
+		assert(value >= exact && value <= exact + exact / 128 && "Expected percentiles within a bucket");
+	}
+	assert(uniform.percentile(0) == TimeSpan::FromNanoseconds(1) && uniform.min() == TimeSpan::FromNanoseconds(1) &&
+		   "Expected the smallest latency");
+	assert(uniform.percentile(100) == uniform.max() && uniform.max() >= TimeSpan::FromNanoseconds(100'000) &&
+		   "Expected the largest latency");
+
+	Histogram::Snapshot negative;
+	negative.record(TimeSpan::FromNanoseconds(-5));
+	assert(negative.count() == 1 && negative.max() == TimeSpan::Zero() && "Expected negative latencies as zero");
+	const Histogram::Snapshot empty;
+	assert(empty.percentile(99) == TimeSpan::Zero() && empty.mean() == TimeSpan::Zero() &&
+		   "Expected zero for empty snapshots");
+
+	// Recorders written from several threads, snapshotted while they record
+	constexpr int Threads = 4;
+	constexpr int Records = 100'000;
+	Histogram histogram(Threads);
+	const Histogram::Snapshot before = histogram.snapshot();
+	std::vector<std::thread> recorders;
+	for (int t = 0; t < Threads; ++t)
+	{
+		recorders.emplace_back(
+			[&histogram, t]
+			{
+				Histogram::Recorder& recorder = histogram.recorder(static_cast<std::size_t>(t));
+				for (int i = 0; i < Records; ++i)
+					recorder.record(TimeSpan::FromMicroseconds(1 + i % 1000));
+			});
+	}
+	uint64_t seen = 0;
+	for (int i = 0; i < 20; ++i)
+	{
+		const uint64_t count = histogram.snapshot().count();
+		assert(count >= seen && "Expected snapshots to grow while recording");
+		seen = count;
+	}
+	for (std::thread& recorder : recorders)
+		recorder.join();
+
+	const Histogram::Snapshot after = histogram.snapshot();
+	const Histogram::Snapshot interval = after - before;
+	assert(interval.count() == uint64_t{Threads} * Records && "Expected every recording");
+	assert(interval.mean() == TimeSpan::FromNanoseconds(500'500) && "Expected the mean of the interval");
+	assert((interval + interval).count() == 2 * interval.count() &&
+		   (interval + interval).percentile(90) == interval.percentile(90) && "Expected merged snapshots");
+
+	// Serialized form
+	const std::vector<std::byte> bytes = uniform.encode();
+	assert(bytes.size() < 4096 && "Expected a compact encoding");
+	const Histogram::Snapshot decoded = Histogram::Snapshot::Decode(bytes);
+	assert(decoded.count() == uniform.count() && decoded.mean() == uniform.mean() && "Expected count and mean");
+	for (std::size_t i = 0; i < Histogram::BucketCount; ++i)
+		assert(decoded.bucketCount(i) == uniform.bucketCount(i) && "Expected the same buckets");
+	assert(Histogram::Snapshot::Decode(empty.encode()).count() == 0 && "Expected empty round trip");
+
+	int thrown = 0;
+	std::vector<std::byte> trailing = bytes;
+	trailing.push_back(std::byte{0});
+	for (const std::span<const std::byte> malformed :
+		 {std::span<const std::byte>(bytes).first(bytes.size() - 1), std::span<const std::byte>(trailing)})
+	{
+		try
+		{
+			(void)Histogram::Snapshot::Decode(malformed);
+		}
+		catch (const std::invalid_argument&)
+		{
+			++thrown;
+		}
+	}
+	try
+	{
+		(void)uniform.percentile(100.5);
+	}
+	catch (const std::invalid_argument&)
+	{
+		++thrown;
+	}
+	try
+	{
+		Histogram invalid(0);
+	}
+	catch (const std::invalid_argument&)
+	{
+		++thrown;
+	}
+	try
+	{
+		(void)histogram.recorder(Threads);
+	}
+	catch (const std::out_of_range&)
+	{
+		++thrown;
+	}
+	assert(thrown == 5 && "Expected malformed input, percentiles, recorder counts and indexes to be rejected");
+
+	return true;
+}
+
+int main()
+{
+	bool constructorsTestPassed = TestDateTimeConstructors();
+	if (constructorsTestPassed)
+	{
+		std::cout << "TestDateTimeConstructors passed." << std::endl;
+	}
+	else
+	{
+		assert(false && "TestDateTimeConstructors failed.");
+	}
+
+	bool tryCreateTestPassed = TestDateTimeTryCreate();
+	if (tryCreateTestPassed)
+	{
+		std::cout << "TestDateTimeTryCreate passed." << std::endl;
+	}
+	else
+	{
+		assert(false && "TestDateTimeTryCreate failed.");
+	}
+
+	bool utcNowTestPassed = TestDateTimeUtcNow();
+	if (utcNowTestPassed)
+	{
+		std::cout << "TestDateTimeUtcNow passed." << std::endl;
+	}
+	else
+	{
+		assert(false && "TestDateTimeUtcNow failed.");
+	}
+
+	bool utcNowCoarseTestPassed = TestUtcNowCoarse();
+	if (utcNowCoarseTestPassed)
+	{
+		std::cout << "TestUtcNowCoarse passed." << std::endl;
+	}
+	else
+	{
+		assert(false && "TestUtcNowCoarse failed.");
+	}
+
+	bool gettersTestPassed = TestDateTimeGetters();
+	if (gettersTestPassed)
+	{
+		std::cout << "TestDateTimeGetters passed." << std::endl;
+	}
+	else
+	{
+		assert(false && "TestDateTimeGetters failed.");
+	}
+
+	bool decomposeTestPassed = TestDateTimeDecompose();
+	if (decomposeTestPassed)
+	{
+		std::cout << "TestDateTimeDecompose passed." << std::endl;
+	}
+	else
+	{
+		assert(false && "TestDateTimeDecompose failed.");
+	}
+
+	bool batchDecomposeTestPassed = TestBatchDecompose();
+	if (batchDecomposeTestPassed)
+	{
+		std::cout << "TestBatchDecompose passed." << std::endl;
+	}
+	else
+	{
+		assert(false && "TestBatchDecompose failed.");
+	}
+
+	bool assignationOperatorTestPassed = TestAssignationOperator();
+	if (assignationOperatorTestPassed)
+	{
+		std::cout << "TestAssignationOperator passed." << std::endl;
+	}
+	else
+	{
+		assert(false && "TestAssignationOperator failed.");
+	}
+
+	bool comparisonOperatorsTestPassed = TestDateTimeComparisonOperators();
+	if (comparisonOperatorsTestPassed)
+	{
+		std::cout << "TestDateTimeComparisonOperators passed." << std::endl;
+	}
+	else
+	{
+		assert(false && "TestDateTimeComparisonOperators failed.");
+	}
+
+	bool toStringTestPassed = TestDateTimeToString();
+	if (toStringTestPassed)
+	{
+		std::cout << "TestDateTimeToString passed." << std::endl;
+	}
+	else
+	{
+		assert(false && "TestDateTimeToString failed.");
+	}
+
+	bool toCharsTestPassed = TestDateTimeToChars();
+	if (toCharsTestPassed)
+	{
+		std::cout << "TestDateTimeToChars passed." << std::endl;
+	}
+	else
+	{
+		assert(false && "TestDateTimeToChars failed.");
+	}
+
+	bool constexprTestPassed = TestConstexprArithmetic();
+	if (constexprTestPassed)
+	{
+		std::cout << "TestConstexprArithmetic passed." << std::endl;
+	}
+	else
+	{
+		assert(false && "TestConstexprArithmetic failed.");
+	}
+
+	bool patternTestPassed = TestDateTimePattern();
+	if (patternTestPassed)
+	{
+		std::cout << "TestDateTimePattern passed." << std::endl;
+	}
+	else
+	{
+		assert(false && "TestDateTimePattern failed.");
+	}
+
+	bool timestampFormatterTestPassed = TestTimestampFormatter();
+	if (timestampFormatterTestPassed)
+	{
+		std::cout << "TestTimestampFormatter passed." << std::endl;
+	}
+	else
+	{
+		assert(false && "TestTimestampFormatter failed.");
+	}
+
+	bool unixTimestampTestPassed = TestDateTimeUnixTimestamp();
+	if (unixTimestampTestPassed)
+	{
+		std::cout << "TestDateTimeUnixTimestamp passed." << std::endl;
+	}
+	else
+	{
+		assert(false && "TestDateTimeUnixTimestamp failed.");
+	}
+
+	bool unixEpochTestPassed = TestDateTimeUnixEpoch();
+	if (unixEpochTestPassed)
+	{
+		std::cout << "TestDateTimeUnixEpoch passed." << std::endl;
+	}
+	else
+	{
+		assert(false && "TestDateTimeUnixEpoch failed.");
+	}
+
+	bool batchUnixEpochTestPassed = TestBatchUnixEpoch();
+	if (batchUnixEpochTestPassed)
+	{
+		std::cout << "TestBatchUnixEpoch passed." << std::endl;
+	}
+	else
+	{
+		assert(false && "TestBatchUnixEpoch failed.");
+	}
+
+	bool parseTestPassed = TestDateTimeParse();
+	if (parseTestPassed)
+	{
+		std::cout << "TestDateTimeParse passed." << std::endl;
+	}
+	else
+	{
+		assert(false && "TestDateTimeParse failed.");
+	}
+
+	bool timeSpanFormattingTestPassed = TestTimeSpanFormatting();
+	if (timeSpanFormattingTestPassed)
+	{
+		std::cout << "TestTimeSpanFormatting passed." << std::endl;
+	}
+	else
+	{
+		assert(false && "TestTimeSpanFormatting failed.");
+	}
+
+	bool timeSpanOverflowTestPassed = TestTimeSpanOverflow();
+	if (timeSpanOverflowTestPassed)
+	{
+		std::cout << "TestTimeSpanOverflow passed." << std::endl;
+	}
+	else
+	{
+		assert(false && "TestTimeSpanOverflow failed.");
+	}
+
+	bool basicDateTimePrecisionTestPassed = TestBasicDateTimePrecision();
+	if (basicDateTimePrecisionTestPassed)
+	{
+		std::cout << "TestBasicDateTimePrecision passed." << std::endl;
+	}
+	else
+	{
+		assert(false && "TestBasicDateTimePrecision failed.");
+	}
+
+	bool timeZoneTestPassed = TestTimeZone();
+	if (timeZoneTestPassed)
+	{
+		std::cout << "TestTimeZone passed." << std::endl;
+	}
+	else
+	{
+		assert(false && "TestTimeZone failed.");
+	}
+
+	bool encodingTestPassed = TestEncoding();
+	if (encodingTestPassed)
+	{
+		std::cout << "TestEncoding passed." << std::endl;
+	}
+	else
+	{
+		assert(false && "TestEncoding failed.");
+	}
+
+	bool timestampColumnTestPassed = TestTimestampColumn();
+	if (timestampColumnTestPassed)
+	{
+		std::cout << "TestTimestampColumn passed." << std::endl;
+	}
+	else
+	{
+		assert(false && "TestTimestampColumn failed.");
+	}
+
+	bool dateTimeIndexTestPassed = TestDateTimeIndex();
+	if (dateTimeIndexTestPassed)
+	{
+		std::cout << "TestDateTimeIndex passed." << std::endl;
+	}
+	else
+	{
+		assert(false && "TestDateTimeIndex failed.");
+	}
+
+	bool roundingTestPassed = TestDateTimeRounding();
+	if (roundingTestPassed)
+	{
+		std::cout << "TestDateTimeRounding passed." << std::endl;
+	}
+	else
+	{
+		assert(false && "TestDateTimeRounding failed.");
+	}
+
+	bool sortTestPassed = TestSortByTime();
+	if (sortTestPassed)
+	{
+		std::cout << "TestSortByTime passed." << std::endl;
+	}
+	else
+	{
+		assert(false && "TestSortByTime failed.");
+	}
+
+	bool logScannerTestPassed = TestLogScanner();
+	if (logScannerTestPassed)
+	{
+		std::cout << "TestLogScanner passed." << std::endl;
+	}
+	else
+	{
+		assert(false && "TestLogScanner failed.");
+	}
+
+	bool timeBucketAggregatorTestPassed = TestTimeBucketAggregator();
+	if (timeBucketAggregatorTestPassed)
+	{
+		std::cout << "TestTimeBucketAggregator passed." << std::endl;
+	}
+	else
+	{
+		assert(false && "TestTimeBucketAggregator failed.");
+	}
+
+	bool timerWheelTestPassed = TestTimerWheel();
+	if (timerWheelTestPassed)
+	{
+		std::cout << "TestTimerWheel passed." << std::endl;
+	}
+	else
+	{
+		assert(false && "TestTimerWheel failed.");
+	}
+
+	bool stopwatchTestPassed = TestStopwatch();
+	if (stopwatchTestPassed)
+	{
+		std::cout << "TestStopwatch passed." << std::endl;
+	}
+	else
+	{
+		assert(false && "TestStopwatch failed.");
+	}
+
+	bool latencyHistogramTestPassed = TestLatencyHistogram();
+	if (latencyHistogramTestPassed)
+	{
+		std::cout << "TestLatencyHistogram passed." << std::endl;
+	}
+	else
+	{
+		assert(false && "TestLatencyHistogram failed.");
 	}
 
 	std::cout << "\n\nAll tests passed successfully !!" << std::endl;
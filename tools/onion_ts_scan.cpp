@@ -0,0 +1,164 @@
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <exception>
+#include <span>
+#include <string>
+#include <string_view>
+
+#include <onion/DateTime.hpp>
+#include <onion/Encoding.hpp>
+#include <onion/LogScanner.hpp>
+#include <onion/Sort.hpp>
+
+using namespace onion;
+
+namespace
+{
+	constexpr const char* Usage =
+		"Usage: onion_ts_scan [-t THREADS] [-o INDEX] FILE\n"
+		"\n"
+		"Extracts the leading ISO 8601 timestamp of every line of FILE.\n"
+		"\n"
+		"  -t THREADS  Number of threads (default: all hardware threads)\n"
+		"  -o INDEX    Write a binary index sorted by time to INDEX instead of printing the timestamps.\n"
+		"              Each entry is 16 bytes: the sortable key of the timestamp (onion::encoding::encodeKey)\n"
+		"              followed by the byte offset of the line, big-endian, so entries sort with memcmp.\n"
+		"\n"
+		"Without -o, prints one \"<offset>\\t<timestamp>\" line per timestamp, in file order.\n"
+		"A summary is printed to stderr.\n";
+
+	constexpr std::size_t IndexEntrySize = encoding::KeySize + 8;
+	constexpr std::size_t OutputBufferSize = std::size_t{1} << 20;
+
+	/// Writes through a large buffer, as the output can have as many lines as the input.
+	class Output
+	{
+	  public:
+		explicit Output(std::FILE* file) : m_file(file) { m_buffer.reserve(OutputBufferSize); }
+
+		void write(const char* data, std::size_t size)
+		{
+			if (m_buffer.size() + size > OutputBufferSize)
+				flush();
+			m_buffer.append(data, size);
+		}
+
+		bool flush()
+		{
+			const bool written = std::fwrite(m_buffer.data(), 1, m_buffer.size(), m_file) == m_buffer.size();
+			m_buffer.clear();
+			return written && std::fflush(m_file) == 0;
+		}
+
+	  private:
+		std::FILE* m_file;
+		std::string m_buffer;
+	};
+
+	bool printTimestamps(std::span<const LogTimestamp> timestamps)
+	{
+		Output output(stdout);
+		char line[64];
+		for (const LogTimestamp& timestamp : timestamps)
+		{
+			const auto offset = static_cast<unsigned long long>(timestamp.offset);
+			const int prefix = std::snprintf(line, sizeof(line), "%llu\t", offset);
+			char* end = timestamp.time.toChars(line + prefix, line + sizeof(line) - 1).ptr;
+			*end++ = '\n';
+			output.write(line, static_cast<std::size_t>(end - line));
+		}
+		return output.flush();
+	}
+
+	bool writeIndex(std::span<LogTimestamp> timestamps, unsigned threads, const char* path)
+	{
+		sortByTime(timestamps, &LogTimestamp::time, threads);
+
+		std::FILE* file = std::fopen(path, "wb");
+		if (!file)
+			return false;
+
+		Output output(file);
+		std::byte entry[IndexEntrySize];
+		for (const LogTimestamp& timestamp : timestamps)
+		{
+			encoding::encodeKey(timestamp.time, entry);
+			for (std::size_t i = 0; i < 8; ++i)
+				entry[encoding::KeySize + i] = static_cast<std::byte>(timestamp.offset >> (56 - 8 * i));
+			output.write(reinterpret_cast<const char*>(entry), IndexEntrySize);
+		}
+		const bool written = output.flush();
+		return std::fclose(file) == 0 && written;
+	}
+} // namespace
+
+int main(int argc, char** argv)
+{
+	unsigned threads = 0;
+	const char* indexPath = nullptr;
+	const char* inputPath = nullptr;
+
+	for (int i = 1; i < argc; ++i)
+	{
+		const std::string_view argument = argv[i];
+		if ((argument == "-t" || argument == "-o") && i + 1 < argc)
+		{
+			if (argument == "-t")
+				threads = static_cast<unsigned>(std::strtoul(argv[++i], nullptr, 10));
+			else
+				indexPath = argv[++i];
+		}
+		else if (argument == "-h" || argument == "--help")
+		{
+			std::fputs(Usage, stdout);
+			return 0;
+		}
+		else if (!inputPath && !argument.starts_with('-'))
+			inputPath = argv[i];
+		else
+		{
+			std::fputs(Usage, stderr);
+			return 2;
+		}
+	}
+
+	if (!inputPath)
+	{
+		std::fputs(Usage, stderr);
+		return 2;
+	}
+
+	try
+	{
+		const auto start = std::chrono::steady_clock::now();
+		LogScan scan = scanLogFile(inputPath, threads);
+		const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+		const bool written =
+			indexPath ? writeIndex(scan.timestamps, threads, indexPath) : printTimestamps(scan.timestamps);
+		if (!written)
+		{
+			std::fprintf(stderr, "onion_ts_scan: cannot write %s\n", indexPath ? indexPath : "the output");
+			return 1;
+		}
+
+		std::fprintf(stderr,
+					 "%llu lines, %zu timestamps, %.3f GB scanned in %.3f s (%.2f GB/s)\n",
+					 static_cast<unsigned long long>(scan.lines),
+					 scan.timestamps.size(),
+					 static_cast<double>(scan.bytes) / 1e9,
+					 elapsed.count(),
+					 static_cast<double>(scan.bytes) / 1e9 / elapsed.count());
+	}
+	catch (const std::exception& ex)
+	{
+		std::fprintf(stderr, "onion_ts_scan: %s\n", ex.what());
+		return 1;
+	}
+
+	return 0;
+}